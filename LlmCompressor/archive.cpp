@@ -0,0 +1,399 @@
+#include "archive.h"
+#include "compressor.cuh"
+#include "file_util.h"
+#include "chunk_codec.h"
+#include "rans.h"
+#include "gguf.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 인덱스 직렬화 헬퍼 (리틀 엔디언 x64 가정, 기존 v1 과 동일)
+struct ByteWriter {
+    std::vector<char> buf;
+    void put(const void* p, size_t n) { buf.insert(buf.end(), static_cast<const char*>(p), static_cast<const char*>(p) + n); }
+    void u8(uint8_t v) { put(&v, 1); }
+    void u32(uint32_t v) { put(&v, 4); }
+    void u64(uint64_t v) { put(&v, 8); }
+    void str(const std::string& s) { u32(static_cast<uint32_t>(s.size())); put(s.data(), s.size()); }
+};
+
+struct ByteReader {
+    const char* p;
+    const char* end;
+    bool ok = true;
+    bool get(void* dst, size_t n) {
+        if (!ok || static_cast<size_t>(end - p) < n) { ok = false; return false; }
+        std::memcpy(dst, p, n);
+        p += n;
+        return true;
+    }
+    uint8_t u8() { uint8_t v = 0; get(&v, 1); return v; }
+    uint32_t u32() { uint32_t v = 0; get(&v, 4); return v; }
+    uint64_t u64() { uint64_t v = 0; get(&v, 8); return v; }
+    std::string str() {
+        uint32_t n = u32();
+        if (!ok || static_cast<size_t>(end - p) < n) { ok = false; return std::string(); }
+        std::string s(p, p + n);
+        p += n;
+        return s;
+    }
+};
+
+std::vector<char> serialize_chunks(const std::vector<ArchiveChunk>& chunks)
+{
+    ByteWriter w;
+    w.u64(chunks.size());
+    for (const auto& c : chunks) {
+        w.u64(c.offset);
+        w.u64(c.compressed_size);
+        w.u64(c.original_size);
+        w.u8(c.codec);
+        w.u8(static_cast<uint8_t>(c.level));
+        w.u8(c.transform);
+        w.u8(c.transform_param);
+        w.u32(c.aux);
+    }
+    return w.buf;
+}
+
+bool parse_chunks(const std::vector<char>& data, std::vector<ArchiveChunk>& chunks)
+{
+    ByteReader r{ data.data(), data.data() + data.size() };
+    uint64_t n = r.u64();
+    if (!r.ok || n > data.size() / 32) return false;
+    chunks.resize(static_cast<size_t>(n));
+    for (auto& c : chunks) {
+        c.offset = r.u64();
+        c.compressed_size = r.u64();
+        c.original_size = r.u64();
+        c.codec = r.u8();
+        c.level = static_cast<int8_t>(r.u8());
+        c.transform = r.u8();
+        c.transform_param = r.u8();
+        c.aux = r.u32();
+    }
+    return r.ok;
+}
+
+std::vector<char> serialize_files(const std::vector<ArchiveFile>& files)
+{
+    ByteWriter w;
+    w.u64(files.size());
+    for (const auto& f : files) {
+        w.str(f.path);
+        w.u64(f.size);
+        w.u64(f.extents.size());
+        for (const auto& e : f.extents) {
+            w.u64(e.chunk);
+            w.u64(e.chunk_offset);
+            w.u64(e.length);
+        }
+    }
+    return w.buf;
+}
+
+bool parse_files(const std::vector<char>& data, std::vector<ArchiveFile>& files)
+{
+    ByteReader r{ data.data(), data.data() + data.size() };
+    uint64_t n = r.u64();
+    if (!r.ok || n > data.size()) return false;
+    files.resize(static_cast<size_t>(n));
+    for (auto& f : files) {
+        f.path = r.str();
+        f.size = r.u64();
+        uint64_t ne = r.u64();
+        if (!r.ok || ne > data.size() / 24) return false;
+        f.extents.resize(static_cast<size_t>(ne));
+        for (auto& e : f.extents) {
+            e.chunk = r.u64();
+            e.chunk_offset = r.u64();
+            e.length = r.u64();
+        }
+    }
+    return r.ok;
+}
+
+} // namespace
+
+bool is_v2_archive(const fs::path& path)
+{
+    std::FILE* f = file_open(path, "rb");
+    if (!f) return false;
+    char sig[8];
+    bool ok = std::fread(sig, 1, sizeof(sig), f) == sizeof(sig) &&
+              std::string(sig, sig + 8) == KANG_V2_SIGNATURE;
+    std::fclose(f);
+    return ok;
+}
+
+bool write_v2_signature(std::FILE* f)
+{
+    return std::fwrite(KANG_V2_SIGNATURE.data(), 1, KANG_V2_SIGNATURE.size(), f) == KANG_V2_SIGNATURE.size();
+}
+
+bool write_archive_index(std::FILE* f, const ArchiveIndex& index)
+{
+    std::map<uint32_t, std::vector<char>> sections = index.extra_sections;
+    sections[SECTION_CHUNKS] = serialize_chunks(index.chunks);
+    sections[SECTION_FILES] = serialize_files(index.files);
+
+    ByteWriter w;
+    w.u32(KANG_V2_INDEX_VERSION);
+    w.u32(static_cast<uint32_t>(sections.size()));
+    for (const auto& s : sections) {
+        w.u32(s.first);
+        w.u64(s.second.size());
+        w.put(s.second.data(), s.second.size());
+    }
+
+    const uint64_t index_offset = file_tell(f);
+    const uint64_t index_size = w.buf.size();
+    return std::fwrite(w.buf.data(), 1, w.buf.size(), f) == w.buf.size() &&
+           file_write_u64(f, index_offset) &&
+           file_write_u64(f, index_size) &&
+           std::fwrite(KANG_V2_TRAILER.data(), 1, KANG_V2_TRAILER.size(), f) == KANG_V2_TRAILER.size();
+}
+
+bool read_archive_index(std::FILE* f, ArchiveIndex& index, uint64_t* index_offset_out)
+{
+    index = ArchiveIndex();
+
+    char sig[8];
+    if (!file_read_at(f, 0, sig, sizeof(sig)) || std::string(sig, sig + 8) != KANG_V2_SIGNATURE) {
+        std::cerr << "Error: Not a v2 .kang archive (invalid signature)." << std::endl;
+        return false;
+    }
+    if (!file_seek_end(f)) return false;
+    const uint64_t file_size = file_tell(f);
+    if (file_size < KANG_V2_SIGNATURE.size() + KANG_V2_TRAILER_SIZE) {
+        std::cerr << "Error: Archive is truncated." << std::endl;
+        return false;
+    }
+
+    uint64_t index_offset = 0, index_size = 0;
+    char trailer[8];
+    if (!file_read_at(f, file_size - KANG_V2_TRAILER_SIZE, &index_offset, sizeof(index_offset)) ||
+        !file_read_u64(f, index_size) ||
+        std::fread(trailer, 1, sizeof(trailer), f) != sizeof(trailer) ||
+        std::string(trailer, trailer + 8) != KANG_V2_TRAILER ||
+        index_offset + index_size + KANG_V2_TRAILER_SIZE != file_size) {
+        std::cerr << "Error: Archive index is missing or damaged (incomplete write?)." << std::endl;
+        return false;
+    }
+
+    std::vector<char> buf(static_cast<size_t>(index_size));
+    if (!file_read_at(f, index_offset, buf.data(), buf.size())) return false;
+
+    ByteReader r{ buf.data(), buf.data() + buf.size() };
+    const uint32_t version = r.u32();
+    const uint32_t num_sections = r.u32();
+    if (!r.ok || version != KANG_V2_INDEX_VERSION) {
+        std::cerr << "Error: Unsupported archive index version." << std::endl;
+        return false;
+    }
+    bool ok = true;
+    for (uint32_t i = 0; i < num_sections && ok; ++i) {
+        const uint32_t tag = r.u32();
+        const uint64_t size = r.u64();
+        if (!r.ok || static_cast<uint64_t>(r.end - r.p) < size) { ok = false; break; }
+        std::vector<char> data(r.p, r.p + size);
+        r.p += size;
+        if (tag == SECTION_CHUNKS) ok = parse_chunks(data, index.chunks);
+        else if (tag == SECTION_FILES) ok = parse_files(data, index.files);
+        else index.extra_sections[tag] = std::move(data);
+    }
+    auto tables = index.extra_sections.find(SECTION_RANS_TABLES);
+    if (ok && tables != index.extra_sections.end()) {
+        auto shared = std::make_shared<RansSharedTables>();
+        ok = parse_rans_tables(tables->second, *shared);
+        index.rans_tables = std::move(shared);
+    }
+    if (!ok) {
+        std::cerr << "Error: Archive index is corrupted." << std::endl;
+        return false;
+    }
+    for (const auto& c : index.chunks) {
+        if (c.offset + c.compressed_size > index_offset) {
+            std::cerr << "Error: Chunk table points past the payload." << std::endl;
+            return false;
+        }
+    }
+    if (index_offset_out) *index_offset_out = index_offset;
+    return true;
+}
+
+bool decode_archive_chunks(std::FILE* f, const ArchiveIndex& index,
+                           const std::vector<size_t>& chunk_ids, const ArchiveChunkSink& sink)
+{
+    // XOR 참조 청크 (--moe): 참조 원본을 해제해 XOR. 같은 참조를 가리키는 청크가 이어지므로 최근 참조 하나를 보관
+    std::vector<char> reference;
+    uint64_t reference_id = UINT64_MAX;
+    auto apply_reference = [&](size_t id, char* data, size_t size) {
+        const ArchiveChunk& c = index.chunks[id];
+        if (!(c.transform & CHUNK_TRANSFORM_XOR_REFERENCE)) return true;
+        if (c.aux >= index.chunks.size() || index.chunks[c.aux].original_size != size ||
+            (index.chunks[c.aux].transform & CHUNK_TRANSFORM_XOR_REFERENCE)) {
+            std::cerr << "Error: Archive index is corrupted (bad XOR reference chunk)." << std::endl;
+            return false;
+        }
+        if (reference_id != c.aux) {
+            reference_id = UINT64_MAX;
+            const bool ok = decode_archive_chunks(f, index, { static_cast<size_t>(c.aux) },
+                                                  [&](size_t, const char* ref, size_t n) {
+                                                      reference.assign(ref, ref + n);
+                                                      return true;
+                                                  });
+            if (!ok) return false;
+            reference_id = c.aux;
+        }
+        xor_bytes(data, reference.data(), size);
+        return true;
+    };
+
+    // 코덱 해제 뒤 청크 변환을 되돌려 sink 로 넘김
+    std::vector<char> merged;
+    auto deliver = [&](size_t id, const char* data, size_t size) {
+        const ArchiveChunk& c = index.chunks[id];
+        const uint8_t transform = c.transform & ~CHUNK_TRANSFORM_XOR_REFERENCE;
+        if (c.transform == static_cast<uint8_t>(ChunkTransform::None)) return sink(id, data, size);
+        merged.resize(size);
+        bool ok = false;
+        if (transform == static_cast<uint8_t>(ChunkTransform::None)) {
+            std::memcpy(merged.data(), data, size);
+            ok = true;
+        }
+        else if (transform == static_cast<uint8_t>(ChunkTransform::ByteSplit) && c.transform_param >= 2) {
+            byte_merge(data, size, c.transform_param, merged.data());
+            ok = true;
+        }
+        else if (transform == static_cast<uint8_t>(ChunkTransform::SignSplit)) {
+            ok = sign_merge(data, size, static_cast<DType>(c.transform_param), merged.data());
+        }
+        else if (transform == static_cast<uint8_t>(ChunkTransform::TransposeSplit)) {
+            ok = transpose_merge(data, size, static_cast<DType>(c.transform_param), c.aux, merged.data());
+        }
+        else if (transform == static_cast<uint8_t>(ChunkTransform::QuantSplit)) {
+            ok = quant_merge(data, size, c.transform_param, merged.data());
+        }
+        if (!ok) {
+            std::cerr << "Error: Unknown chunk transform " << static_cast<int>(c.transform) << "." << std::endl;
+            return false;
+        }
+        return apply_reference(id, merged.data(), size) && sink(id, merged.data(), size);
+    };
+
+    std::vector<char> comp_buf, plain_buf;
+    size_t i = 0;
+    while (i < chunk_ids.size()) {
+        // 같은 코덱끼리 묶어서 처리 (GPU 세션 재사용)
+        const uint8_t codec = index.chunks[chunk_ids[i]].codec;
+        size_t j = i;
+        while (j < chunk_ids.size() && index.chunks[chunk_ids[j]].codec == codec) ++j;
+
+        if (codec == static_cast<uint8_t>(ChunkCodec::Stored)) {
+            for (size_t k = i; k < j; ++k) {
+                const ArchiveChunk& c = index.chunks[chunk_ids[k]];
+                comp_buf.resize(static_cast<size_t>(c.compressed_size));
+                if (c.compressed_size != c.original_size ||
+                    !file_read_at(f, c.offset, comp_buf.data(), comp_buf.size()) ||
+                    !deliver(chunk_ids[k], comp_buf.data(), comp_buf.size())) {
+                    return false;
+                }
+            }
+        }
+        else if (is_cpu_codec(codec)) {
+            for (size_t k = i; k < j; ++k) {
+                ArchiveChunk c = index.chunks[chunk_ids[k]];
+                c.transform &= ~CHUNK_TRANSFORM_XOR_REFERENCE;
+                comp_buf.resize(static_cast<size_t>(c.compressed_size));
+                plain_buf.resize(static_cast<size_t>(c.original_size));
+                // 변환까지 코덱 쪽에서 되돌림 (deliver 를 거치지 않음)
+                if (!file_read_at(f, c.offset, comp_buf.data(), comp_buf.size()) ||
+                    !decode_cpu_chunk_to_plain(c, comp_buf.data(), comp_buf.size(), plain_buf.data(), index.rans_tables.get()) ||
+                    !apply_reference(chunk_ids[k], plain_buf.data(), plain_buf.size()) ||
+                    !sink(chunk_ids[k], plain_buf.data(), plain_buf.size())) {
+                    return false;
+                }
+            }
+        }
+        else if (codec == static_cast<uint8_t>(ChunkCodec::NvcompZstd)) {
+            bool ok = decompress_chunks_streaming(
+                j - i,
+                [&](size_t k, size_t& compressed_size, size_t& original_size) -> const char* {
+                    const ArchiveChunk& c = index.chunks[chunk_ids[i + k]];
+                    comp_buf.resize(static_cast<size_t>(c.compressed_size));
+                    if (!file_read_at(f, c.offset, comp_buf.data(), comp_buf.size())) return nullptr;
+                    compressed_size = comp_buf.size();
+                    original_size = static_cast<size_t>(c.original_size);
+                    return comp_buf.data();
+                },
+                [&](size_t k, const char* data, size_t size) {
+                    return deliver(chunk_ids[i + k], data, size);
+                });
+            if (!ok) return false;
+        }
+        else {
+            std::cerr << "Error: Unknown chunk codec " << static_cast<int>(codec) << "." << std::endl;
+            return false;
+        }
+        i = j;
+    }
+    return true;
+}
+
+bool append_extent_slice(const std::vector<ArchiveExtent>& extents, uint64_t offset, uint64_t length,
+                         std::vector<ArchiveExtent>& out)
+{
+    uint64_t pos = 0;
+    for (const auto& e : extents) {
+        if (length == 0) break;
+        if (offset < pos + e.length) {
+            const uint64_t skip = offset - pos;
+            const uint64_t len = std::min<uint64_t>(length, e.length - skip);
+            ArchiveExtent piece{ e.chunk, e.chunk_offset + skip, len };
+            if (!out.empty() && out.back().chunk == piece.chunk &&
+                out.back().chunk_offset + out.back().length == piece.chunk_offset) {
+                out.back().length += len;
+            } else {
+                out.push_back(piece);
+            }
+            offset += len;
+            length -= len;
+        }
+        pos += e.length;
+    }
+    return length == 0;
+}
+
+bool read_archive_file_range(std::FILE* f, const ArchiveIndex& index, const ArchiveFile& file,
+                             uint64_t offset, uint64_t length, std::vector<char>& out)
+{
+    std::vector<ArchiveExtent> slice;
+    if (!append_extent_slice(file.extents, offset, length, slice)) {
+        std::cerr << "Error: Requested range is past the end of " << file.path << std::endl;
+        return false;
+    }
+    out.resize(static_cast<size_t>(length));
+
+    std::vector<size_t> ids;
+    for (const auto& e : slice) {
+        if (e.chunk >= index.chunks.size() || e.chunk_offset + e.length > index.chunks[e.chunk].original_size) {
+            std::cerr << "Error: Archive index is corrupted (bad extent)." << std::endl;
+            return false;
+        }
+        if (std::find(ids.begin(), ids.end(), e.chunk) == ids.end()) ids.push_back(static_cast<size_t>(e.chunk));
+    }
+    return decode_archive_chunks(f, index, ids, [&](size_t chunk, const char* data, size_t) {
+        uint64_t out_pos = 0;
+        for (const auto& e : slice) {
+            if (e.chunk == chunk) std::memcpy(out.data() + out_pos, data + e.chunk_offset, static_cast<size_t>(e.length));
+            out_pos += e.length;
+        }
+        return true;
+    });
+}
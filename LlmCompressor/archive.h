@@ -0,0 +1,119 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <filesystem>
+#include <memory>
+
+// .kang v2 (컨테이너) 레이아웃
+// [8B "KANGCMP2"][독립적으로 해제 가능한 압축 청크들...][인덱스][트레일러]
+// 트레일러: [u64 인덱스 오프셋][u64 인덱스 크기][8B "KANGEND2"]
+// 인덱스: [u32 버전][u32 섹션 수][섹션 수 x (u32 태그, u64 크기, 내용)]
+// 청크가 끝나는 대로 기록하고 인덱스는 마지막에 붙이므로 스트리밍/병렬 기록이 가능.
+inline const std::string KANG_V2_SIGNATURE = "KANGCMP2";
+inline const std::string KANG_V2_TRAILER = "KANGEND2";
+constexpr uint32_t KANG_V2_INDEX_VERSION = 1;
+constexpr uint64_t KANG_V2_TRAILER_SIZE = 24;
+
+// 인덱스 섹션 태그
+constexpr uint32_t make_section_tag(char a, char b, char c, char d)
+{
+    return static_cast<uint32_t>(static_cast<unsigned char>(a)) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(c)) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(d)) << 24);
+}
+constexpr uint32_t SECTION_CHUNKS = make_section_tag('C', 'H', 'N', 'K');
+constexpr uint32_t SECTION_FILES = make_section_tag('F', 'I', 'L', 'E');
+constexpr uint32_t SECTION_RANS_TABLES = make_section_tag('R', 'T', 'A', 'B'); // 공유 rANS 표 (rans.h)
+
+// 청크 코덱
+enum class ChunkCodec : uint8_t {
+    NvcompZstd = 0, // nvCOMP ZstdManager 포맷 (GPU)
+    Stored = 1,     // 무압축
+    Lz4 = 2,        // LZ4 블록 (CPU, level 0 = 빠른 압축, 3~12 = LZ4-HC). 해제가 메모리 대역폭에 가까움
+    Lzma = 3,       // xz 스트림 (CPU LZMA2, level 0~9 = 프리셋, 10 = 9e). 보관용 고압축
+    Rans = 4,       // 인터리브 rANS (CPU order-0 엔트로피 코딩, rans.h). 바이트 평면마다 표, SIMD 해제
+    Fpc = 5,        // FPC 예측 부동소수 코더 (CPU, fpc.h). fp32/fp64 원소를 이웃/문맥 예측과 XOR 한 잔차로, 독립 블록
+    Zstd = 6,       // 표준 zstd 프레임 (CPU libzstd, level 1~22). --rule 의 zstd 처럼 레벨이 그대로 적용되어야 하는 청크
+};
+
+// 청크 변환 (해제 후 되돌림)
+enum class ChunkTransform : uint8_t {
+    None = 0,
+    ByteSplit = 1,  // transform_param 바이트 원소의 같은 자리 바이트끼리 모음 (bf16 이면 상위/하위 바이트 평면)
+    SignSplit = 2,  // transform_param = DType (dtype_kernels.h). 부호를 최하위 비트로 옮긴 뒤 바이트 분할 (실수면 최상위 평면 = 지수)
+    TransposeSplit = 3, // transform_param = DType, aux = 열 수. 행 x 열 원소를 열 우선으로 전치한 뒤 SignSplit (부호 없는 형은 ByteSplit)
+    QuantSplit = 4, // transform_param = ggml 형 (gguf.h). 양자화 블록의 필드(스케일/양자 값)별 스트림으로 모음
+};
+
+// transform 상위 비트: 변환을 되돌린 뒤 aux 번 청크 원본과 XOR (--moe 전문가 잔차, moe.h)
+// 참조 청크는 같은 크기이고 이 비트가 없음. TransposeSplit 과는 같이 쓰지 않음 (aux 공유)
+constexpr uint8_t CHUNK_TRANSFORM_XOR_REFERENCE = 0x80;
+
+struct RansSharedTables;
+
+struct ArchiveChunk {
+    uint64_t offset = 0;          // 아카이브 내 절대 오프셋
+    uint64_t compressed_size = 0;
+    uint64_t original_size = 0;
+    uint8_t codec = 0;            // ChunkCodec
+    int8_t level = 0;
+    uint8_t transform = 0;        // ChunkTransform
+    uint8_t transform_param = 0;  // ByteSplit: 원소 크기
+    uint32_t aux = 0;             // TransposeSplit: 행당 원소 수, XOR 참조: 참조 청크 번호 (그 외 예약)
+};
+
+// 파일 내용의 한 구간이 어느 청크의 어디에 있는지
+struct ArchiveExtent {
+    uint64_t chunk = 0;           // 청크 번호
+    uint64_t chunk_offset = 0;    // 해제된 청크 내 시작 위치
+    uint64_t length = 0;
+};
+
+struct ArchiveFile {
+    std::string path;             // 아카이브 내 상대 경로 ('/' 구분)
+    uint64_t size = 0;
+    std::vector<ArchiveExtent> extents; // 순서대로 이어 붙이면 원본 파일
+};
+
+struct ArchiveIndex {
+    std::vector<ArchiveChunk> chunks;
+    std::vector<ArchiveFile> files;
+    std::map<uint32_t, std::vector<char>> extra_sections; // 알 수 없는/추가 섹션은 그대로 보존
+    std::shared_ptr<const RansSharedTables> rans_tables;  // SECTION_RANS_TABLES 를 읽을 때 만든 해제 표 (없으면 null)
+};
+
+// v2 아카이브 여부 (시그니처만 확인)
+bool is_v2_archive(const std::filesystem::path& path);
+
+// 시그니처 기록 (새 아카이브 시작)
+bool write_v2_signature(std::FILE* f);
+
+// 현재 위치에 인덱스 + 트레일러 기록
+bool write_archive_index(std::FILE* f, const ArchiveIndex& index);
+
+// 트레일러를 따라 인덱스를 읽음. index_offset 에 인덱스 시작 위치(=페이로드 끝) 반환
+bool read_archive_index(std::FILE* f, ArchiveIndex& index, uint64_t* index_offset = nullptr);
+
+// 해제된 청크 출력 콜백
+using ArchiveChunkSink = std::function<bool(size_t chunk, const char* data, size_t size)>;
+
+// 지정한 청크들을 코덱에 맞게 해제해 sink 로 넘김 (chunk_ids 순서대로)
+bool decode_archive_chunks(std::FILE* f, const ArchiveIndex& index,
+                           const std::vector<size_t>& chunk_ids, const ArchiveChunkSink& sink);
+
+// 파일 내용 중 [offset, offset + length) 구간만 해제 (겹치는 청크만 해제)
+bool read_archive_file_range(std::FILE* f, const ArchiveIndex& index, const ArchiveFile& file,
+                             uint64_t offset, uint64_t length, std::vector<char>& out);
+
+// 익스텐트 목록에서 [offset, offset + length) 구간을 잘라 out 뒤에 붙임 (이어지는 익스텐트는 병합)
+bool append_extent_slice(const std::vector<ArchiveExtent>& extents, uint64_t offset, uint64_t length,
+                         std::vector<ArchiveExtent>& out);
+
+#endif //ARCHIVE_H
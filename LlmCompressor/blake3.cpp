@@ -0,0 +1,203 @@
+#include "blake3.h"
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t IV[8] = { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+                             0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+constexpr uint8_t MSG_PERMUTATION[16] = { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 };
+
+constexpr uint32_t CHUNK_START = 1;
+constexpr uint32_t CHUNK_END = 2;
+constexpr uint32_t PARENT = 4;
+constexpr uint32_t ROOT = 8;
+constexpr size_t BLOCK_LEN = 64;
+constexpr size_t CHUNK_LEN = 1024;
+
+inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+inline void g(uint32_t s[16], int a, int b, int c, int d, uint32_t mx, uint32_t my)
+{
+    s[a] = s[a] + s[b] + mx;
+    s[d] = rotr(s[d] ^ s[a], 16);
+    s[c] = s[c] + s[d];
+    s[b] = rotr(s[b] ^ s[c], 12);
+    s[a] = s[a] + s[b] + my;
+    s[d] = rotr(s[d] ^ s[a], 8);
+    s[c] = s[c] + s[d];
+    s[b] = rotr(s[b] ^ s[c], 7);
+}
+
+void compress(const uint32_t cv[8], const uint32_t block_words[16], uint64_t counter,
+              uint32_t block_len, uint32_t flags, uint32_t out[16])
+{
+    uint32_t s[16] = { cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+                       IV[0], IV[1], IV[2], IV[3],
+                       static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), block_len, flags };
+    uint32_t m[16];
+    std::memcpy(m, block_words, sizeof(m));
+    for (int round = 0; round < 7; ++round) {
+        g(s, 0, 4, 8, 12, m[0], m[1]);
+        g(s, 1, 5, 9, 13, m[2], m[3]);
+        g(s, 2, 6, 10, 14, m[4], m[5]);
+        g(s, 3, 7, 11, 15, m[6], m[7]);
+        g(s, 0, 5, 10, 15, m[8], m[9]);
+        g(s, 1, 6, 11, 12, m[10], m[11]);
+        g(s, 2, 7, 8, 13, m[12], m[13]);
+        g(s, 3, 4, 9, 14, m[14], m[15]);
+        if (round < 6) {
+            uint32_t permuted[16];
+            for (int i = 0; i < 16; ++i) permuted[i] = m[MSG_PERMUTATION[i]];
+            std::memcpy(m, permuted, sizeof(m));
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        out[i] = s[i] ^ s[i + 8];
+        out[i + 8] = s[i + 8] ^ cv[i];
+    }
+}
+
+void load_words(const uint8_t block[BLOCK_LEN], uint32_t words[16])
+{
+    for (int i = 0; i < 16; ++i) {
+        words[i] = static_cast<uint32_t>(block[4 * i]) | (static_cast<uint32_t>(block[4 * i + 1]) << 8) |
+                   (static_cast<uint32_t>(block[4 * i + 2]) << 16) | (static_cast<uint32_t>(block[4 * i + 3]) << 24);
+    }
+}
+
+// 압축 직전 상태 (루트이면 ROOT 플래그를 더해 출력)
+struct Output {
+    uint32_t input_cv[8];
+    uint32_t block_words[16];
+    uint64_t counter;
+    uint32_t block_len;
+    uint32_t flags;
+
+    void chaining_value(uint32_t cv[8]) const
+    {
+        uint32_t out[16];
+        compress(input_cv, block_words, counter, block_len, flags, out);
+        std::memcpy(cv, out, 8 * sizeof(uint32_t));
+    }
+    void root_bytes(uint8_t* dst, size_t size) const
+    {
+        uint32_t out[16];
+        compress(input_cv, block_words, 0, block_len, flags | ROOT, out);
+        for (size_t i = 0; i < size && i < 64; ++i) dst[i] = static_cast<uint8_t>(out[i / 4] >> (8 * (i % 4)));
+    }
+};
+
+Output parent_output(const uint32_t left[8], const uint32_t right[8])
+{
+    Output o;
+    std::memcpy(o.input_cv, IV, sizeof(o.input_cv));
+    std::memcpy(o.block_words, left, 8 * sizeof(uint32_t));
+    std::memcpy(o.block_words + 8, right, 8 * sizeof(uint32_t));
+    o.counter = 0;
+    o.block_len = BLOCK_LEN;
+    o.flags = PARENT;
+    return o;
+}
+
+} // namespace
+
+Blake3Hasher::Blake3Hasher()
+{
+    reset_chunk(0);
+}
+
+void Blake3Hasher::reset_chunk(uint64_t chunk_counter)
+{
+    std::memcpy(chunk_.cv, IV, sizeof(chunk_.cv));
+    chunk_.chunk_counter = chunk_counter;
+    std::memset(chunk_.block, 0, sizeof(chunk_.block));
+    chunk_.block_len = 0;
+    chunk_.blocks_compressed = 0;
+}
+
+void Blake3Hasher::push_chunk_cv(const uint32_t cv[8], uint64_t total_chunks)
+{
+    // 완성된 서브트리를 병합 (total_chunks 의 끝자리 0 개수만큼)
+    uint32_t new_cv[8];
+    std::memcpy(new_cv, cv, sizeof(new_cv));
+    while ((total_chunks & 1) == 0) {
+        --cv_stack_len_;
+        parent_output(cv_stack_[cv_stack_len_], new_cv).chaining_value(new_cv);
+        total_chunks >>= 1;
+    }
+    std::memcpy(cv_stack_[cv_stack_len_++], new_cv, sizeof(new_cv));
+}
+
+void Blake3Hasher::update(const void* data, size_t size)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        // 청크가 가득 찼고 입력이 더 있으면 청크 마감
+        if (chunk_.blocks_compressed * BLOCK_LEN + chunk_.block_len == CHUNK_LEN) {
+            uint32_t words[16];
+            load_words(chunk_.block, words);
+            Output o;
+            std::memcpy(o.input_cv, chunk_.cv, sizeof(o.input_cv));
+            std::memcpy(o.block_words, words, sizeof(words));
+            o.counter = chunk_.chunk_counter;
+            o.block_len = chunk_.block_len;
+            o.flags = CHUNK_END | (chunk_.blocks_compressed == 0 ? CHUNK_START : 0);
+            uint32_t cv[8];
+            o.chaining_value(cv);
+            const uint64_t total_chunks = chunk_.chunk_counter + 1;
+            push_chunk_cv(cv, total_chunks);
+            reset_chunk(total_chunks);
+        }
+        // 블록이 가득 찼고 입력이 더 있으면 블록 압축
+        if (chunk_.block_len == BLOCK_LEN) {
+            uint32_t words[16], out[16];
+            load_words(chunk_.block, words);
+            compress(chunk_.cv, words, chunk_.chunk_counter, BLOCK_LEN,
+                     chunk_.blocks_compressed == 0 ? CHUNK_START : 0, out);
+            std::memcpy(chunk_.cv, out, sizeof(chunk_.cv));
+            ++chunk_.blocks_compressed;
+            std::memset(chunk_.block, 0, sizeof(chunk_.block));
+            chunk_.block_len = 0;
+        }
+        const size_t take = std::min(size, BLOCK_LEN - chunk_.block_len);
+        std::memcpy(chunk_.block + chunk_.block_len, p, take);
+        chunk_.block_len = static_cast<uint8_t>(chunk_.block_len + take);
+        p += take;
+        size -= take;
+    }
+}
+
+void Blake3Hasher::finalize(uint8_t out[BLAKE3_OUT_LEN]) const
+{
+    Output o;
+    std::memcpy(o.input_cv, chunk_.cv, sizeof(o.input_cv));
+    load_words(chunk_.block, o.block_words);
+    o.counter = chunk_.chunk_counter;
+    o.block_len = chunk_.block_len;
+    o.flags = CHUNK_END | (chunk_.blocks_compressed == 0 ? CHUNK_START : 0);
+    for (size_t i = cv_stack_len_; i > 0; --i) {
+        uint32_t cv[8];
+        o.chaining_value(cv);
+        o = parent_output(cv_stack_[i - 1], cv);
+    }
+    o.root_bytes(out, BLAKE3_OUT_LEN);
+}
+
+void blake3_hash(const void* data, size_t size, uint8_t out[BLAKE3_OUT_LEN])
+{
+    Blake3Hasher h;
+    h.update(data, size);
+    h.finalize(out);
+}
+
+std::string blake3_hex(const uint8_t hash[BLAKE3_OUT_LEN])
+{
+    static const char hex[] = "0123456789abcdef";
+    std::string s;
+    for (size_t i = 0; i < BLAKE3_OUT_LEN; ++i) {
+        s += hex[hash[i] >> 4];
+        s += hex[hash[i] & 15];
+    }
+    return s;
+}
@@ -0,0 +1,40 @@
+#ifndef BLAKE3_H
+#define BLAKE3_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// BLAKE3 (기본 해시 모드, 32바이트 출력). 이식성 있는 단일 스레드 구현
+// 청크 저장소의 내용 주소(청크 ID)에 사용
+constexpr size_t BLAKE3_OUT_LEN = 32;
+
+class Blake3Hasher {
+public:
+    Blake3Hasher();
+    void update(const void* data, size_t size);
+    void finalize(uint8_t out[BLAKE3_OUT_LEN]) const;
+
+private:
+    struct ChunkState {
+        uint32_t cv[8];
+        uint64_t chunk_counter;
+        uint8_t block[64];
+        uint8_t block_len;
+        uint8_t blocks_compressed;
+    };
+    void reset_chunk(uint64_t chunk_counter);
+    void push_chunk_cv(const uint32_t cv[8], uint64_t total_chunks);
+
+    ChunkState chunk_;
+    uint32_t cv_stack_[54][8];
+    size_t cv_stack_len_ = 0;
+};
+
+// 한 번에 해시
+void blake3_hash(const void* data, size_t size, uint8_t out[BLAKE3_OUT_LEN]);
+
+// 16진 문자열
+std::string blake3_hex(const uint8_t hash[BLAKE3_OUT_LEN]);
+
+#endif //BLAKE3_H
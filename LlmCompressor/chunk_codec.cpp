@@ -0,0 +1,444 @@
+#include "chunk_codec.h"
+#include "rans.h"
+#include "fpc.h"
+#include "gguf.h"
+#include "scratch_pool.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <lz4.h>
+#include <lz4hc.h>
+#include <lzma.h>
+#include <zstd.h>
+
+namespace {
+
+// 원소 크기를 컴파일 시간 상수로 두어 내부 루프를 펼침 (해제 경로라 대역폭이 중요)
+template <size_t W>
+void split_fixed(const char* src, size_t n, char* dst)
+{
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t b = 0; b < W; ++b) dst[b * n + i] = src[i * W + b];
+    }
+}
+
+template <size_t W>
+void merge_fixed(const char* src, size_t n, char* dst)
+{
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t b = 0; b < W; ++b) dst[i * W + b] = src[b * n + i];
+    }
+}
+
+// rows x cols 원소 행렬을 cols x rows 로 전치 (타일 단위로 돌아 읽기/쓰기 모두 캐시 안에서)
+template <size_t W>
+void transpose_fixed(const char* src, size_t rows, size_t cols, char* dst)
+{
+    constexpr size_t TILE = 32;
+    for (size_t r0 = 0; r0 < rows; r0 += TILE) {
+        const size_t r1 = std::min(rows, r0 + TILE);
+        for (size_t c0 = 0; c0 < cols; c0 += TILE) {
+            const size_t c1 = std::min(cols, c0 + TILE);
+            for (size_t r = r0; r < r1; ++r) {
+                for (size_t c = c0; c < c1; ++c) std::memcpy(dst + (c * rows + r) * W, src + (r * cols + c) * W, W);
+            }
+        }
+    }
+}
+
+void transpose_elements(const char* src, size_t rows, size_t cols, size_t width, char* dst)
+{
+    switch (width) {
+    case 1: transpose_fixed<1>(src, rows, cols, dst); break;
+    case 2: transpose_fixed<2>(src, rows, cols, dst); break;
+    case 4: transpose_fixed<4>(src, rows, cols, dst); break;
+    default: transpose_fixed<8>(src, rows, cols, dst); break;
+    }
+}
+
+// 빈도 분포의 기호당 비트 수
+double order0_entropy(const uint64_t counts[256])
+{
+    uint64_t total = 0;
+    for (size_t s = 0; s < 256; ++s) total += counts[s];
+    double bits = 0;
+    for (size_t s = 0; s < 256; ++s) {
+        if (counts[s] == 0) continue;
+        const double p = static_cast<double>(counts[s]) / static_cast<double>(total);
+        bits -= p * std::log2(p);
+    }
+    return bits;
+}
+
+} // namespace
+
+void byte_split(const char* src, size_t size, size_t width, char* dst)
+{
+    const size_t n = width > 1 ? size / width : 0;
+    switch (width) {
+    case 2: split_fixed<2>(src, n, dst); break;
+    case 4: split_fixed<4>(src, n, dst); break;
+    case 8: split_fixed<8>(src, n, dst); break;
+    default:
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t b = 0; b < width; ++b) dst[b * n + i] = src[i * width + b];
+        }
+        break;
+    }
+    std::memcpy(dst + n * width, src + n * width, size - n * width);
+}
+
+void byte_merge(const char* src, size_t size, size_t width, char* dst)
+{
+    const size_t n = width > 1 ? size / width : 0;
+    switch (width) {
+    case 2: merge_fixed<2>(src, n, dst); break;
+    case 4: merge_fixed<4>(src, n, dst); break;
+    case 8: merge_fixed<8>(src, n, dst); break;
+    default:
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t b = 0; b < width; ++b) dst[i * width + b] = src[b * n + i];
+        }
+        break;
+    }
+    std::memcpy(dst + n * width, src + n * width, size - n * width);
+}
+
+bool sign_split(const char* src, size_t size, DType dtype, char* dst)
+{
+    const DTypeKernels* k = dtype_kernels(dtype);
+    if (!k) return false;
+    const size_t n = size / k->width;
+    k->fold_split(src, n, dst);
+    std::memcpy(dst + n * k->width, src + n * k->width, size - n * k->width);
+    return true;
+}
+
+bool sign_merge(const char* src, size_t size, DType dtype, char* dst)
+{
+    const DTypeKernels* k = dtype_kernels(dtype);
+    if (!k) return false;
+    const size_t n = size / k->width;
+    k->merge_unfold(src, n, dst);
+    std::memcpy(dst + n * k->width, src + n * k->width, size - n * k->width);
+    return true;
+}
+
+bool transpose_split(const char* src, size_t size, DType dtype, size_t columns, char* dst)
+{
+    const DTypeKernels* k = dtype_kernels(dtype);
+    if (!k || columns == 0 || size % (columns * k->width) != 0) return false;
+    const size_t n = size / k->width;
+    ScratchPool::Lease transposed = scratch_pool().acquire(size);
+    transpose_elements(src, n / columns, columns, k->width, transposed.data());
+    if (k->kind == DTypeKind::Unsigned) k->split(transposed.data(), n, dst);
+    else k->fold_split(transposed.data(), n, dst);
+    return true;
+}
+
+bool transpose_merge(const char* src, size_t size, DType dtype, size_t columns, char* dst)
+{
+    const DTypeKernels* k = dtype_kernels(dtype);
+    if (!k || columns == 0 || size % (columns * k->width) != 0) return false;
+    const size_t n = size / k->width;
+    ScratchPool::Lease transposed = scratch_pool().acquire(size);
+    if (k->kind == DTypeKind::Unsigned) k->merge(src, n, transposed.data());
+    else k->merge_unfold(src, n, transposed.data());
+    transpose_elements(transposed.data(), columns, n / columns, k->width, dst);
+    return true;
+}
+
+bool prefer_column_major(const char* src, size_t size, DType dtype, size_t columns)
+{
+    const DTypeKernels* k = dtype_kernels(dtype);
+    if (!k || k->width < 2 || columns < 2 || size % (columns * k->width) != 0) return false;
+    const size_t rows = size / (columns * k->width);
+    if (rows < 2) return false;
+    const uint8_t mask = k->kind == DTypeKind::Float ? 0x7F : 0xFF;
+    auto high = [&](size_t r, size_t c) {
+        return static_cast<uint8_t>(static_cast<uint8_t>(src[(r * columns + c + 1) * k->width - 1]) & mask);
+    };
+    // 최대 256 x 256 표본 격자 (청크 크기와 무관하게 비용 일정)
+    const size_t row_step = std::max<size_t>(1, (rows - 1) / 256);
+    const size_t col_step = std::max<size_t>(1, (columns - 1) / 256);
+    uint64_t along_row[256] = {};
+    uint64_t along_column[256] = {};
+    for (size_t r = 1; r < rows; r += row_step) {
+        for (size_t c = 1; c < columns; c += col_step) {
+            const uint8_t v = high(r, c);
+            ++along_row[static_cast<uint8_t>(v - high(r, c - 1))];
+            ++along_column[static_cast<uint8_t>(v - high(r - 1, c))];
+        }
+    }
+    // 해제 때 전치 비용이 들므로 확실히 나을 때만 (5%)
+    return order0_entropy(along_column) < 0.95 * order0_entropy(along_row);
+}
+
+void xor_bytes(char* dst, const char* src, size_t size)
+{
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t a, b;
+        std::memcpy(&a, dst + i, 8);
+        std::memcpy(&b, src + i, 8);
+        a ^= b;
+        std::memcpy(dst + i, &a, 8);
+    }
+    for (; i < size; ++i) dst[i] ^= src[i];
+}
+
+DType unsigned_dtype(size_t width)
+{
+    switch (width) {
+    case 1: return DType::U8;
+    case 2: return DType::U16;
+    case 4: return DType::U32;
+    case 8: return DType::U64;
+    default: return DType::Unknown;
+    }
+}
+
+DType dominant_dtype(const std::vector<TensorInfo>& tensors, uint64_t begin, uint64_t end)
+{
+    uint64_t covered[256] = {};
+    for (const auto& t : tensors) {
+        const uint64_t lo = std::max(begin, t.data_begin);
+        const uint64_t hi = std::min(end, t.data_end);
+        const DTypeKernels* k = dtype_kernels(t.dtype);
+        if (lo < hi && k && k->width >= 2) covered[static_cast<uint8_t>(k->dtype)] += hi - lo;
+    }
+    size_t best = 0;
+    for (size_t d = 1; d < 256; ++d) {
+        if (covered[d] > covered[best]) best = d;
+    }
+    return static_cast<DType>(best);
+}
+
+bool lz4_compress_chunk(const char* src, size_t size, int level, std::vector<char>& out)
+{
+    if (size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+        std::cerr << "Error: Chunk is too large for LZ4 (" << size << " bytes)." << std::endl;
+        return false;
+    }
+    out.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(size))));
+    const int r = level < KANG_LZ4HC_MIN_LEVEL
+        ? LZ4_compress_default(src, out.data(), static_cast<int>(size), static_cast<int>(out.size()))
+        : LZ4_compress_HC(src, out.data(), static_cast<int>(size), static_cast<int>(out.size()),
+                          std::min(level, LZ4HC_CLEVEL_MAX));
+    if (r <= 0 && size > 0) {
+        std::cerr << "Error: LZ4 compression failed." << std::endl;
+        return false;
+    }
+    out.resize(static_cast<size_t>(r));
+    return true;
+}
+
+bool lz4_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size)
+{
+    const int r = LZ4_decompress_safe(src, dst, static_cast<int>(compressed_size), static_cast<int>(original_size));
+    if (r < 0 || static_cast<size_t>(r) != original_size) {
+        std::cerr << "Error: LZ4 chunk is corrupted." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool lzma_compress_chunk(const char* src, size_t size, int level, uint8_t element_width, std::vector<char>& out)
+{
+    uint32_t preset = static_cast<uint32_t>(std::min(std::max(level, 0), 9));
+    if (level >= KANG_LZMA_EXTREME_LEVEL) preset |= LZMA_PRESET_EXTREME;
+    lzma_options_lzma opt;
+    if (lzma_lzma_preset(&opt, preset)) {
+        std::cerr << "Error: Invalid LZMA preset " << level << "." << std::endl;
+        return false;
+    }
+    // 청크보다 큰 사전은 메모리만 씀
+    opt.dict_size = static_cast<uint32_t>(std::max<size_t>(LZMA_DICT_SIZE_MIN, std::min<size_t>(opt.dict_size, size)));
+    if (element_width == 2 || element_width == 4) {
+        const uint32_t bits = element_width == 2 ? 1 : 2;
+        opt.lp = bits;
+        opt.pb = bits;
+        opt.lc = std::min<uint32_t>(opt.lc, LZMA_LCLP_MAX - bits);
+    }
+    lzma_filter filters[2] = { { LZMA_FILTER_LZMA2, &opt }, { LZMA_VLI_UNKNOWN, nullptr } };
+
+    out.resize(lzma_stream_buffer_bound(size));
+    size_t out_pos = 0;
+    const lzma_ret r = lzma_stream_buffer_encode(filters, LZMA_CHECK_CRC32, nullptr,
+                                                 reinterpret_cast<const uint8_t*>(src), size,
+                                                 reinterpret_cast<uint8_t*>(out.data()), &out_pos, out.size());
+    if (r != LZMA_OK) {
+        std::cerr << "Error: LZMA compression failed (" << static_cast<int>(r) << ")." << std::endl;
+        return false;
+    }
+    out.resize(out_pos);
+    return true;
+}
+
+bool lzma_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size)
+{
+    uint64_t memlimit = UINT64_MAX;
+    size_t in_pos = 0, out_pos = 0;
+    const lzma_ret r = lzma_stream_buffer_decode(&memlimit, 0, nullptr,
+                                                 reinterpret_cast<const uint8_t*>(src), &in_pos, compressed_size,
+                                                 reinterpret_cast<uint8_t*>(dst), &out_pos, original_size);
+    if (r != LZMA_OK || out_pos != original_size || in_pos != compressed_size) {
+        std::cerr << "Error: LZMA chunk is corrupted." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool zstd_compress_chunk(const char* src, size_t size, int level, std::vector<char>& out)
+{
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    if (!cctx) {
+        std::cerr << "Error: Cannot create zstd context." << std::endl;
+        return false;
+    }
+    out.resize(ZSTD_compressBound(size));
+    const size_t r = ZSTD_compressCCtx(cctx, out.data(), out.size(), src, size, clamp_codec_level(ChunkCodec::Zstd, level));
+    ZSTD_freeCCtx(cctx);
+    if (ZSTD_isError(r)) {
+        std::cerr << "Error: zstd compression failed: " << ZSTD_getErrorName(r) << std::endl;
+        return false;
+    }
+    out.resize(r);
+    return true;
+}
+
+bool zstd_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size)
+{
+    const size_t r = ZSTD_decompress(dst, original_size, src, compressed_size);
+    if (ZSTD_isError(r) || r != original_size) {
+        std::cerr << "Error: zstd chunk is corrupted." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int clamp_codec_level(ChunkCodec codec, int level)
+{
+    if (codec == ChunkCodec::Rans || codec == ChunkCodec::Fpc) return 0;
+    if (codec == ChunkCodec::Zstd) return std::min(std::max(level, 1), ZSTD_maxCLevel());
+    return std::min(std::max(level, 0), codec == ChunkCodec::Lzma ? KANG_LZMA_EXTREME_LEVEL : LZ4HC_CLEVEL_MAX);
+}
+
+bool decode_cpu_chunk(uint8_t codec, const char* src, size_t compressed_size, char* dst, size_t original_size,
+                      const RansSharedTables* shared)
+{
+    if (codec == static_cast<uint8_t>(ChunkCodec::Lz4)) return lz4_decompress_chunk(src, compressed_size, dst, original_size);
+    if (codec == static_cast<uint8_t>(ChunkCodec::Lzma)) return lzma_decompress_chunk(src, compressed_size, dst, original_size);
+    if (codec == static_cast<uint8_t>(ChunkCodec::Rans)) return rans_decompress_chunk(src, compressed_size, dst, original_size, shared);
+    if (codec == static_cast<uint8_t>(ChunkCodec::Fpc)) return fpc_decompress_chunk(src, compressed_size, dst, original_size);
+    if (codec == static_cast<uint8_t>(ChunkCodec::Zstd)) return zstd_decompress_chunk(src, compressed_size, dst, original_size);
+    std::cerr << "Error: Unknown chunk codec " << static_cast<int>(codec) << "." << std::endl;
+    return false;
+}
+
+bool decode_cpu_chunk_to_plain(const ArchiveChunk& c, const char* src, size_t compressed_size, char* dst,
+                               const RansSharedTables* shared)
+{
+    const size_t size = static_cast<size_t>(c.original_size);
+    if (c.transform == static_cast<uint8_t>(ChunkTransform::None)) return decode_cpu_chunk(c.codec, src, compressed_size, dst, size, shared);
+    if (c.transform == static_cast<uint8_t>(ChunkTransform::TransposeSplit)) {
+        ScratchPool::Lease planes = scratch_pool().acquire(size);
+        if (!decode_cpu_chunk(c.codec, src, compressed_size, planes.data(), size, shared)) return false;
+        if (!transpose_merge(planes.data(), size, static_cast<DType>(c.transform_param), c.aux, dst)) {
+            std::cerr << "Error: Bad transposed chunk (dtype " << static_cast<int>(c.transform_param) << ", "
+                      << c.aux << " columns)." << std::endl;
+            return false;
+        }
+        return true;
+    }
+    if (c.transform == static_cast<uint8_t>(ChunkTransform::QuantSplit)) {
+        // Rans 는 필드 평면 스트림 길이가 달라 rans_decompress_chunk 가 그대로 해제
+        ScratchPool::Lease planes = scratch_pool().acquire(size);
+        if (!decode_cpu_chunk(c.codec, src, compressed_size, planes.data(), size, shared)) return false;
+        if (!quant_merge(planes.data(), size, c.transform_param, dst)) {
+            std::cerr << "Error: Unknown quantization type " << static_cast<int>(c.transform_param) << " in chunk transform." << std::endl;
+            return false;
+        }
+        return true;
+    }
+    const bool sign = c.transform == static_cast<uint8_t>(ChunkTransform::SignSplit);
+    if (!sign && (c.transform != static_cast<uint8_t>(ChunkTransform::ByteSplit) || c.transform_param < 2)) {
+        std::cerr << "Error: Unknown chunk transform " << static_cast<int>(c.transform) << "." << std::endl;
+        return false;
+    }
+    const DTypeKernels* k = dtype_kernels(sign ? static_cast<DType>(c.transform_param) : unsigned_dtype(c.transform_param));
+    if (sign && !k) {
+        std::cerr << "Error: Unknown dtype " << static_cast<int>(c.transform_param) << " in chunk transform." << std::endl;
+        return false;
+    }
+    if (c.codec == static_cast<uint8_t>(ChunkCodec::Rans) && k) {
+        return rans_decompress_planes(*k, sign, src, compressed_size, dst, size, shared);
+    }
+    // 나머지 코덱은 청크 단위로만 해제되므로 풀 버퍼에 해제한 뒤 병합
+    ScratchPool::Lease planes = scratch_pool().acquire(size);
+    if (!decode_cpu_chunk(c.codec, src, compressed_size, planes.data(), size, shared)) return false;
+    if (sign) return sign_merge(planes.data(), size, static_cast<DType>(c.transform_param), dst);
+    byte_merge(planes.data(), size, c.transform_param, dst);
+    return true;
+}
+
+bool encode_cpu_chunk(ChunkCodec codec, const char* data, size_t size, int level, DType dtype, bool split,
+                      ArchiveChunk& meta, std::vector<char>& out, const RansSharedTables* shared, size_t columns)
+{
+    const DTypeKernels* kernels = dtype_kernels(dtype);
+    const uint8_t element_width = kernels ? kernels->width : 0;
+    const bool sign = kernels && kernels->kind != DTypeKind::Unsigned;
+    const bool planes = split && codec != ChunkCodec::Fpc && element_width > 1 && size >= element_width;
+    const bool transpose = planes && codec != ChunkCodec::Rans && columns <= UINT32_MAX &&
+                           prefer_column_major(data, size, dtype, columns);
+    meta.original_size = size;
+    bool ok = false;
+    if (codec == ChunkCodec::Rans && planes) {
+        ok = rans_compress_planes(*kernels, sign, data, size, out, shared); // 타일 단위 융합 (중간 평면 버퍼 없음)
+    }
+    else if (planes) {
+        ScratchPool::Lease buffer = scratch_pool().acquire(size);
+        if (transpose) transpose_split(data, size, dtype, columns, buffer.data());
+        else if (sign) sign_split(data, size, dtype, buffer.data());
+        else byte_split(data, size, element_width, buffer.data());
+        ok = codec == ChunkCodec::Lzma ? lzma_compress_chunk(buffer.data(), size, level, 0, out)
+           : codec == ChunkCodec::Zstd ? zstd_compress_chunk(buffer.data(), size, level, out)
+                                       : lz4_compress_chunk(buffer.data(), size, level, out);
+    }
+    else if (codec == ChunkCodec::Lzma) ok = lzma_compress_chunk(data, size, level, element_width, out);
+    else if (codec == ChunkCodec::Rans) ok = rans_compress_chunk(data, size, 1, out);
+    else if (codec == ChunkCodec::Fpc) ok = fpc_compress_chunk(data, size, element_width == 8 ? 8 : 4, out);
+    else if (codec == ChunkCodec::Zstd) ok = zstd_compress_chunk(data, size, level, out);
+    else ok = lz4_compress_chunk(data, size, level, out);
+    if (!ok) return false;
+    if (out.size() >= size) {
+        // 압축되지 않는 데이터 (변환 없이 그대로)
+        out.assign(data, data + size);
+        meta.codec = static_cast<uint8_t>(ChunkCodec::Stored);
+        meta.level = 0;
+        meta.transform = static_cast<uint8_t>(ChunkTransform::None);
+        meta.transform_param = 0;
+        meta.aux = 0;
+        return true;
+    }
+    meta.codec = static_cast<uint8_t>(codec);
+    meta.level = static_cast<int8_t>(clamp_codec_level(codec, level));
+    meta.transform = static_cast<uint8_t>(!planes ? ChunkTransform::None
+                                          : transpose ? ChunkTransform::TransposeSplit
+                                          : sign ? ChunkTransform::SignSplit : ChunkTransform::ByteSplit);
+    meta.transform_param = !planes ? 0 : (sign || transpose) ? static_cast<uint8_t>(dtype) : element_width;
+    meta.aux = transpose ? static_cast<uint32_t>(columns) : 0;
+    return true;
+}
+
+DType repack_dtype(const ArchiveChunk& c)
+{
+    const uint8_t transform = c.transform & ~CHUNK_TRANSFORM_XOR_REFERENCE;
+    if (transform == static_cast<uint8_t>(ChunkTransform::ByteSplit)) return unsigned_dtype(c.transform_param);
+    if (transform == static_cast<uint8_t>(ChunkTransform::SignSplit) ||
+        transform == static_cast<uint8_t>(ChunkTransform::TransposeSplit)) {
+        return static_cast<DType>(c.transform_param);
+    }
+    return DType::Unknown;
+}
@@ -0,0 +1,92 @@
+#ifndef CHUNK_CODEC_H
+#define CHUNK_CODEC_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "archive.h"
+#include "safetensors.h"
+#include "dtype_kernels.h"
+
+// CPU 청크 코덱 (LZ4/LZ4-HC, LZMA2, zstd, rANS) 과 바이트 분할 변환 (tiers.h 저장 등급)
+constexpr size_t KANG_FASTLOAD_CHUNK_SIZE = 1024ULL * 1024ULL * 4ULL; // 작은 청크 = 코어 수만큼 병렬 해제
+constexpr size_t KANG_COLD_CHUNK_SIZE = 1024ULL * 1024ULL * 16ULL;    // LZMA 사전 크기 = 청크 크기 (워커당 인코더 메모리 ~200MB)
+constexpr int KANG_LZ4HC_MIN_LEVEL = 3;                               // 미만이면 LZ4 빠른 압축
+constexpr int KANG_LZMA_EXTREME_LEVEL = 10;                           // 이상이면 프리셋 9 + LZMA_PRESET_EXTREME
+
+// width 바이트 원소를 바이트 자리별 평면으로 재배치 (끝의 나머지 바이트는 그대로)
+void byte_split(const char* src, size_t size, size_t width, char* dst);
+void byte_merge(const char* src, size_t size, size_t width, char* dst);
+
+// ChunkTransform::SignSplit 변환/역변환 (dtype 특수화 커널, 끝의 나머지 바이트는 그대로). 모르는 dtype 이면 false
+bool sign_split(const char* src, size_t size, DType dtype, char* dst);
+bool sign_merge(const char* src, size_t size, DType dtype, char* dst);
+
+// ChunkTransform::TransposeSplit 변환/역변환. size 는 columns 개 원소 행의 배수여야 함
+// 행 방향보다 열 방향 통계가 강한 가중치 행렬 (입력 채널별 이상치 열 등) 은 열 우선으로 두면 같은 열의 지수가 이웃해
+// LZ 매치/LZMA 문맥이 잘 잡힘. 모르는 dtype 이거나 크기가 맞지 않으면 false
+bool transpose_split(const char* src, size_t size, DType dtype, size_t columns, char* dst);
+bool transpose_merge(const char* src, size_t size, DType dtype, size_t columns, char* dst);
+
+// 열 우선 배치가 나은지 싼 엔트로피 추정으로 판단: 표본 격자에서 상위 바이트(실수는 부호 제외)의
+// 행 방향 이웃 차분과 열 방향 이웃 차분의 order-0 엔트로피를 비교
+bool prefer_column_major(const char* src, size_t size, DType dtype, size_t columns);
+
+// dst ^= src (size 바이트)
+void xor_bytes(char* dst, const char* src, size_t size);
+
+// width 바이트 부호 없는 정수 dtype (ByteSplit 병합 커널용). 1/2/4/8 이 아니면 Unknown
+DType unsigned_dtype(size_t width);
+
+// 청크 [begin, end) 를 가장 많이 덮는 2바이트 이상 dtype. 1바이트형이나 텐서 밖이면 Unknown
+DType dominant_dtype(const std::vector<TensorInfo>& tensors, uint64_t begin, uint64_t end);
+
+// LZ4 블록 압축/해제 (level < KANG_LZ4HC_MIN_LEVEL 이면 LZ4, 아니면 LZ4-HC)
+bool lz4_compress_chunk(const char* src, size_t size, int level, std::vector<char>& out);
+bool lz4_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size);
+
+// LZMA2 (xz 스트림) 압축/해제. level 0~9 = xz 프리셋, KANG_LZMA_EXTREME_LEVEL 이상 = 9e
+// element_width 가 2 이상이면 LZMA 리터럴 위치 비트(lp/pb)를 원소 정렬에 맞춤 (float 가수 바이트 모델링)
+bool lzma_compress_chunk(const char* src, size_t size, int level, uint8_t element_width, std::vector<char>& out);
+bool lzma_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size);
+
+// zstd 프레임 압축/해제 (CPU libzstd, level 은 1~ZSTD_maxCLevel 로 자름)
+bool zstd_compress_chunk(const char* src, size_t size, int level, std::vector<char>& out);
+bool zstd_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size);
+
+// CPU 코덱(Lz4/Lzma/Rans/Fpc/Zstd) 여부
+inline bool is_cpu_codec(uint8_t codec)
+{
+    return codec == static_cast<uint8_t>(ChunkCodec::Lz4) || codec == static_cast<uint8_t>(ChunkCodec::Lzma) ||
+           codec == static_cast<uint8_t>(ChunkCodec::Rans) || codec == static_cast<uint8_t>(ChunkCodec::Fpc) ||
+           codec == static_cast<uint8_t>(ChunkCodec::Zstd);
+}
+
+// 코덱별 기록할 레벨 범위로 자름 (Rans/Fpc 는 0)
+int clamp_codec_level(ChunkCodec codec, int level);
+
+// CPU 코덱(Lz4/Lzma/Rans/Fpc/Zstd) 청크 해제
+// shared = 아카이브 공유 rANS 표 (ArchiveIndex::rans_tables)
+bool decode_cpu_chunk(uint8_t codec, const char* src, size_t compressed_size, char* dst, size_t original_size,
+                      const RansSharedTables* shared = nullptr);
+
+// CPU 코덱 청크를 해제하고 변환까지 되돌려 dst (c.original_size) 에 기록
+// Rans + 바이트 분할은 타일 단위 융합 경로(rans_decompress_planes), 나머지는 풀 버퍼에 해제 후 병합
+bool decode_cpu_chunk_to_plain(const ArchiveChunk& c, const char* src, size_t compressed_size, char* dst,
+                               const RansSharedTables* shared = nullptr);
+
+// 청크 하나를 CPU 코덱으로 인코딩하고 meta 의 코덱/레벨/변환을 채움
+// split 이고 dtype 이 2바이트 이상이면 바이트 분할 후 압축 (부호 있는 형은 SignSplit, Rans 는 평면마다 스트림).
+// Rans 는 shared 가 있으면 공유 표를 참조. 압축이 오히려 커지면 Stored 로 기록
+// columns 가 있으면 (청크가 2-D 텐서의 행 묶음) prefer_column_major 가 고를 때 TransposeSplit.
+// Rans 는 평면마다 order-0 이라 원소 순서가 압축률에 영향이 없으므로 전치하지 않음
+// Fpc 는 변환 없이 dtype 원소 크기 (F64 면 8, 그 외 4) 로 예측 코딩
+bool encode_cpu_chunk(ChunkCodec codec, const char* data, size_t size, int level, DType dtype, bool split,
+                      ArchiveChunk& meta, std::vector<char>& out, const RansSharedTables* shared = nullptr,
+                      size_t columns = 0);
+
+// 해제한 청크를 다시 인코딩할 때의 분할 기준 dtype (원래 변환에서 복원, 분할하지 않았던 청크는 Unknown)
+// compact/transcode 가 encode_cpu_chunk(..., repack_dtype(c), repack_dtype(c) != DType::Unknown, ...) 로 분할을 유지
+DType repack_dtype(const ArchiveChunk& c);
+
+#endif //CHUNK_CODEC_H
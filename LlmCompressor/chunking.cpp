@@ -0,0 +1,306 @@
+#include "chunking.h"
+#include "compressor.cuh"
+#include "file_util.h"
+#include <algorithm>
+#include <map>
+#include <iterator>
+
+namespace {
+
+// Gear 테이블: 고정 시드 splitmix64 (저장소 간 경계가 같아야 하므로 절대 바꾸지 말 것)
+struct GearTable {
+    uint64_t v[256];
+    GearTable()
+    {
+        uint64_t x = 0x4B414E4743444331ULL; // "KANGCDC1"
+        for (auto& g : v) {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            g = z ^ (z >> 31);
+        }
+    }
+};
+
+const GearTable& gear_table()
+{
+    static const GearTable table;
+    return table;
+}
+
+// 다음 경계까지의 길이
+size_t next_cut(const uint8_t* data, size_t size, size_t min_size, size_t avg_size, size_t max_size,
+                uint64_t mask_small, uint64_t mask_large)
+{
+    if (size <= min_size) return size;
+    const uint64_t* gear = gear_table().v;
+    const size_t limit = std::min(size, max_size);
+    const size_t normal = std::min(limit, avg_size);
+    uint64_t h = 0;
+    size_t i = min_size; // 최소 크기까지는 해시하지 않음
+    for (; i < normal; ++i) {
+        h = (h << 1) + gear[data[i]];
+        if ((h & mask_small) == 0) return i + 1;
+    }
+    for (; i < limit; ++i) {
+        h = (h << 1) + gear[data[i]];
+        if ((h & mask_large) == 0) return i + 1;
+    }
+    return limit;
+}
+
+} // namespace
+
+std::vector<size_t> plan_tensor_aligned_chunks(const std::vector<TensorInfo>& tensors, uint64_t data_size)
+{
+    // 텐서 시작 위치 순으로 구간 나누기 (텐서 사이 빈틈은 앞 구간에 포함)
+    std::vector<const TensorInfo*> sorted;
+    for (const auto& t : tensors) {
+        if (t.data_end > data_size) return fixed_chunk_plan(static_cast<size_t>(data_size));
+        sorted.push_back(&t);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const TensorInfo* a, const TensorInfo* b) { return a->data_begin < b->data_begin; });
+
+    std::vector<size_t> plan;
+    uint64_t current = 0;
+    auto flush = [&]() {
+        if (current > 0) plan.push_back(static_cast<size_t>(current));
+        current = 0;
+    };
+    auto add_unit = [&](uint64_t size, bool anchor) {
+        if (size > KANG_CHUNK_SIZE) {
+            // 큰 텐서: 텐서 시작에서 끊고 고정 크기 분할
+            flush();
+            for (; size > KANG_CHUNK_SIZE; size -= KANG_CHUNK_SIZE) plan.push_back(KANG_CHUNK_SIZE);
+            current = size;
+            flush();
+            return;
+        }
+        if (current + size > KANG_CHUNK_SIZE || (anchor && current >= KANG_RSYNC_MIN_CHUNK)) flush();
+        current += size;
+    };
+
+    uint64_t pos = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const uint64_t begin = sorted[i]->data_begin;
+        const uint64_t end = (i + 1 < sorted.size()) ? sorted[i + 1]->data_begin : data_size;
+        if (begin > pos) add_unit(begin - pos, false); // 첫 텐서 앞 빈틈
+        const uint64_t from = std::max(begin, pos);
+        if (end <= from) continue;
+        const std::string& name = sorted[i]->name;
+        add_unit(end - from, fnv1a64(name.data(), name.size()) % KANG_RSYNC_ANCHOR_MODULUS == 0);
+        pos = end;
+    }
+    if (pos < data_size) add_unit(data_size - pos, false);
+    flush();
+    return plan;
+}
+
+std::vector<size_t> plan_content_defined_chunks(const char* data, size_t size,
+                                                size_t min_size, size_t avg_size, size_t max_size)
+{
+    // 해시 상위 비트를 보는 마스크 (Gear 해시는 상위 비트가 최근 64바이트 전체에 의존)
+    int bits = 0;
+    while ((size_t(1) << (bits + 1)) <= avg_size) ++bits;
+    const uint64_t mask_small = ~0ULL << (64 - (bits + 1));
+    const uint64_t mask_large = ~0ULL << (64 - (bits - 1));
+
+    std::vector<size_t> plan;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    size_t pos = 0;
+    while (pos < size) {
+        const size_t n = next_cut(p + pos, size - pos, min_size, avg_size, max_size, mask_small, mask_large);
+        plan.push_back(n);
+        pos += n;
+    }
+    return plan;
+}
+
+uint64_t PlannedChunk::size() const
+{
+    uint64_t total = 0;
+    for (const auto& r : ranges) total += r.length;
+    return total;
+}
+
+std::string tensor_role(const std::string& name)
+{
+    // 점으로 나눈 구성요소 중 숫자뿐인 것 (층/전문가 번호) 을 # 로
+    std::string role;
+    size_t begin = 0;
+    while (begin <= name.size()) {
+        size_t end = name.find('.', begin);
+        if (end == std::string::npos) end = name.size();
+        const bool numeric = end > begin &&
+            std::all_of(name.begin() + begin, name.begin() + end, [](char c) { return c >= '0' && c <= '9'; });
+        if (begin > 0) role += '.';
+        role.append(numeric ? std::string("#") : name.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return role;
+}
+
+std::vector<TensorSpan> tensor_spans(const std::vector<TensorInfo>& tensors, uint64_t data_size, bool reorder)
+{
+    std::vector<TensorSpan> spans;
+    std::vector<const TensorInfo*> sorted;
+    for (const auto& t : tensors) {
+        if (t.data_end > data_size || t.data_begin > t.data_end) {
+            if (data_size > 0) spans.push_back({ 0, data_size, DType::Unknown });
+            return spans;
+        }
+        sorted.push_back(&t);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const TensorInfo* a, const TensorInfo* b) { return a->data_begin < b->data_begin; });
+
+    // 파일 순서로 텐서/빈틈 구간을 만든 뒤 (겹치는 텐서는 겹친 부분을 앞 텐서에)
+    struct Keyed {
+        TensorSpan span;
+        const TensorInfo* tensor; // 빈틈이면 nullptr
+    };
+    std::vector<Keyed> items;
+    uint64_t pos = 0;
+    for (const TensorInfo* t : sorted) {
+        if (t->data_begin > pos) items.push_back({ { pos, t->data_begin - pos, DType::Unknown }, nullptr });
+        const uint64_t from = std::max(t->data_begin, pos);
+        if (t->data_end <= from) continue;
+        const DTypeKernels* k = dtype_kernels(t->dtype);
+        TensorSpan span{ from, t->data_end - from, k ? k->dtype : DType::Unknown };
+        uint64_t elements = 1;
+        for (uint64_t d : t->shape) elements *= d;
+        if (k && from == t->data_begin && t->shape.size() >= 2 && t->shape.back() > 0 &&
+            elements * k->width == span.length) {
+            span.columns = t->shape.back();
+        }
+        items.push_back({ span, t });
+        pos = t->data_end;
+    }
+    if (pos < data_size) items.push_back({ { pos, data_size - pos, DType::Unknown }, nullptr });
+
+    // reorder: (dtype, shape, 이름 역할) 순. 같은 키는 파일 순서 유지, 빈틈은 끝으로
+    if (reorder) {
+        std::vector<std::string> roles(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (items[i].tensor) roles[i] = tensor_role(items[i].tensor->name);
+        }
+        std::vector<size_t> order(items.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            const Keyed& x = items[a];
+            const Keyed& y = items[b];
+            if (!x.tensor || !y.tensor) return x.tensor != nullptr && y.tensor == nullptr;
+            if (x.span.dtype != y.span.dtype) return x.span.dtype < y.span.dtype;
+            if (x.tensor->shape != y.tensor->shape) return x.tensor->shape < y.tensor->shape;
+            return roles[a] < roles[b];
+        });
+        for (size_t i : order) spans.push_back(items[i].span);
+    } else {
+        for (const auto& item : items) spans.push_back(item.span);
+    }
+    return spans;
+}
+
+namespace {
+
+// 바이트 분할 기준 dtype (1바이트 dtype 은 분할해도 평면이 하나라 Unknown)
+DType split_dtype(DType dtype)
+{
+    const DTypeKernels* k = dtype_kernels(dtype);
+    return k && k->width >= 2 ? dtype : DType::Unknown;
+}
+
+// 구간을 청크 끝에 붙임 (파일에서 이어진 구간은 하나로)
+void append_range(PlannedChunk& chunk, uint64_t offset, uint64_t length)
+{
+    if (!chunk.ranges.empty() && chunk.ranges.back().offset + chunk.ranges.back().length == offset) {
+        chunk.ranges.back().length += length;
+    } else {
+        chunk.ranges.push_back({ offset, length });
+    }
+}
+
+} // namespace
+
+std::vector<PlannedChunk> plan_sliced_chunks(const std::vector<TensorSpan>& spans, size_t chunk_size)
+{
+    std::vector<PlannedChunk> plan;
+    PlannedChunk current;
+    uint64_t filled = 0;
+    uint64_t covered[256] = {};
+    auto flush = [&]() {
+        if (filled == 0) return;
+        size_t best = 0;
+        for (size_t d = 1; d < 256; ++d) {
+            if (covered[d] > covered[best]) best = d;
+        }
+        current.dtype = static_cast<DType>(best);
+        plan.push_back(std::move(current));
+        current = PlannedChunk();
+        filled = 0;
+        std::fill(std::begin(covered), std::end(covered), 0);
+    };
+    for (const auto& s : spans) {
+        uint64_t offset = s.offset;
+        uint64_t length = s.length;
+        const DType dtype = split_dtype(s.dtype);
+        while (length > 0) {
+            const uint64_t n = std::min<uint64_t>(length, chunk_size - filled);
+            append_range(current, offset, n);
+            if (dtype != DType::Unknown) covered[static_cast<uint8_t>(dtype)] += n;
+            filled += n;
+            offset += n;
+            length -= n;
+            if (filled == chunk_size) flush();
+        }
+    }
+    flush();
+    return plan;
+}
+
+std::vector<PlannedChunk> plan_solid_chunks(const std::vector<TensorSpan>& spans, size_t chunk_size, uint64_t small_threshold)
+{
+    std::vector<PlannedChunk> plan;
+    // (dtype, 규칙) 별 열린 블록 (나온 순서대로 끝에 붙이기 위해 순서도 기록)
+    std::map<std::pair<uint8_t, uint32_t>, PlannedChunk> open;
+    std::vector<std::pair<uint8_t, uint32_t>> order;
+    for (const auto& s : spans) {
+        if (s.length == 0) continue;
+        const DType dtype = split_dtype(s.dtype);
+        if (s.length >= small_threshold) {
+            // 큰 텐서: 자기 청크들 (chunk_size 분할, 행렬이면 행 경계에서)
+            const DTypeKernels* k = dtype_kernels(s.dtype);
+            const uint64_t row = k && s.columns ? s.columns * k->width : 0;
+            const bool rows = row > 0 && row <= chunk_size;
+            const uint64_t step = rows ? chunk_size / row * row : chunk_size;
+            for (uint64_t done = 0; done < s.length;) {
+                const uint64_t n = std::min<uint64_t>(s.length - done, step);
+                PlannedChunk c;
+                c.ranges.push_back({ s.offset + done, n });
+                c.dtype = dtype;
+                c.columns = rows ? s.columns : 0;
+                c.rule = s.rule;
+                plan.push_back(std::move(c));
+                done += n;
+            }
+            continue;
+        }
+        const std::pair<uint8_t, uint32_t> group{ static_cast<uint8_t>(s.dtype), s.rule };
+        PlannedChunk& block = open[group];
+        if (!block.ranges.empty() && block.size() + s.length > chunk_size) {
+            plan.push_back(std::move(block));
+            block = PlannedChunk();
+        }
+        if (block.ranges.empty()) {
+            block.dtype = dtype;
+            block.rule = s.rule;
+            if (std::find(order.begin(), order.end(), group) == order.end()) order.push_back(group);
+        }
+        append_range(block, s.offset, s.length);
+    }
+    for (const auto& g : order) {
+        if (!open[g].ranges.empty()) plan.push_back(std::move(open[g]));
+    }
+    return plan;
+}
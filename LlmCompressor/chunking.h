@@ -0,0 +1,83 @@
+#ifndef CHUNKING_H
+#define CHUNKING_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "safetensors.h"
+#include "dtype_kernels.h"
+
+// --rsyncable: 청크 경계를 텐서 경계에 고정
+// 청크는 텐서 시작에서만 끊기고, 앵커 텐서(이름 해시로 결정)에서 새 청크를 시작하므로
+// 텐서 하나가 바뀌어도 그 텐서가 속한 청크만 달라지고 나머지 압축 청크는 바이트 단위로 동일.
+// KANG_CHUNK_SIZE 보다 큰 텐서는 텐서 시작 기준으로 고정 크기 분할.
+constexpr size_t KANG_RSYNC_MIN_CHUNK = 1024ULL * 1024ULL * 8ULL; // 8MB 미만 청크는 앵커에서도 끊지 않음
+constexpr uint64_t KANG_RSYNC_ANCHOR_MODULUS = 4;                // 평균 4 텐서마다 앵커
+
+// 텐서 데이터 영역(data_size)을 텐서 경계 기준 청크로 분할한 원본 크기 목록
+// 헤더가 데이터 영역과 맞지 않으면 KANG_CHUNK_SIZE 고정 분할
+std::vector<size_t> plan_tensor_aligned_chunks(const std::vector<TensorInfo>& tensors, uint64_t data_size);
+
+// FastCDC 내용 기반 분할 (청크 저장소 중복 제거용)
+// Gear 롤링 해시로 경계를 정하므로 앞쪽 내용이 바뀌거나 밀려도 뒤쪽 경계는 다시 맞춰짐.
+// 평균보다 작을 때는 엄격한 마스크, 클 때는 느슨한 마스크를 써서 크기 분포를 평균 주변으로 모음 (normalized chunking)
+constexpr size_t KANG_CDC_MIN_SIZE = 1024ULL * 1024ULL;      // 1MB
+constexpr size_t KANG_CDC_AVG_SIZE = 1024ULL * 1024ULL * 4;  // 4MB
+constexpr size_t KANG_CDC_MAX_SIZE = 1024ULL * 1024ULL * 16; // 16MB
+
+// data 를 내용 기반 청크로 나눈 크기 목록 (avg_size 는 2의 거듭제곱)
+std::vector<size_t> plan_content_defined_chunks(const char* data, size_t size,
+                                                size_t min_size = KANG_CDC_MIN_SIZE,
+                                                size_t avg_size = KANG_CDC_AVG_SIZE,
+                                                size_t max_size = KANG_CDC_MAX_SIZE);
+
+// 텐서 데이터 영역의 구간 하나 (텐서 또는 텐서 사이 빈틈)
+struct TensorSpan {
+    uint64_t offset = 0;            // 텐서 데이터 영역 기준
+    uint64_t length = 0;
+    DType dtype = DType::Unknown;   // 빈틈/모르는 dtype 은 Unknown
+    uint64_t columns = 0;           // 2차원 이상 텐서 전체면 마지막 축 원소 수 (행 길이), 아니면 0
+    uint32_t rule = UINT32_MAX;     // --rule: 텐서에 맞은 규칙 번호 (rules.h)
+};
+
+// 데이터 영역 전체를 덮는 구간 목록. 기본은 파일 순서
+// --reorder: 작성기가 정한 순서대로면 같은 역할 텐서(모든 층의 q_proj, 모든 norm 등)가 멀리 떨어져 LZ 창이 닮음을
+// 못 씀. (dtype, shape, 이름 역할) 순으로 모으고 (같은 키는 파일 순서, 빈틈은 끝), 원래 배치는 파일 extent 가 기록하므로
+// 해제하면 바이트 단위로 원본과 같음. 헤더가 데이터 영역과 맞지 않으면 Unknown 구간 하나
+std::vector<TensorSpan> tensor_spans(const std::vector<TensorInfo>& tensors, uint64_t data_size, bool reorder);
+
+// 이름 역할: 숫자뿐인 구성요소(층/전문가 번호)를 # 로 ("model.layers.3.mlp.up_proj.weight" -> "model.layers.#.mlp.up_proj.weight")
+std::string tensor_role(const std::string& name);
+
+// 청크 하나의 원본 = ranges 를 이 순서로 이어 붙인 것
+struct ChunkRange {
+    uint64_t offset = 0;    // 텐서 데이터 영역 기준
+    uint64_t length = 0;
+};
+
+struct PlannedChunk {
+    std::vector<ChunkRange> ranges;
+    DType dtype = DType::Unknown;   // 바이트 분할 기준 dtype (1바이트 dtype/빈틈은 Unknown)
+    uint64_t columns = 0;           // 청크가 행렬 텐서의 온전한 행 묶음이면 행 길이 (TransposeSplit 후보)
+    uint64_t reference = UINT64_MAX;// --moe: XOR 잔차의 참조 청크 번호 (moe.h)
+    uint32_t quant = UINT32_MAX;    // GGUF 양자화 텐서 청크면 ggml 형 (QuantSplit, gguf.h)
+    uint32_t rule = UINT32_MAX;     // --rule: 청크 텐서들의 규칙 번호 (rules.h)
+    uint64_t size() const;
+};
+
+// 구간들을 이어 붙인 흐름을 chunk_size 로 자름 (dtype 은 청크에서 가장 많은 dtype)
+std::vector<PlannedChunk> plan_sliced_chunks(const std::vector<TensorSpan>& spans, size_t chunk_size);
+
+// --solid: 작은 텐서 솔리드 블록
+// 바이어스/노름/스케일/rotary 버퍼 같은 작은 텐서는 하나씩 압축하면 프레임/표 비용이 이득을 넘고, 고정 크기로 자르면
+// 큰 행렬과 섞여 청크 경계에 걸침. 작은 텐서는 dtype 별로 모아 chunk_size 까지 한 블록(청크)으로, 큰 텐서는 자기 청크로.
+// 블록 안 텐서 위치(블록 내 오프셋 표)는 파일 extent 목록에 그대로 기록되므로 해제/부분 읽기 경로는 바뀌지 않음.
+// 큰 행렬 텐서는 행 경계에서 끊어 청크마다 columns 를 기록. 큰 텐서 청크는 구간 순서대로, 블록은 chunk_size 가 찰 때마다 나오고 남은 블록은 끝에 붙음
+// 블록은 (dtype, 규칙) 별이라 --rule 이 다른 텐서는 같은 청크에 들어가지 않음
+constexpr uint64_t KANG_SOLID_SMALL_TENSOR = 1024ULL * 1024ULL; // 이보다 작은 텐서는 솔리드 블록으로
+
+std::vector<PlannedChunk> plan_solid_chunks(const std::vector<TensorSpan>& spans, size_t chunk_size,
+                                            uint64_t small_threshold = KANG_SOLID_SMALL_TENSOR);
+
+#endif //CHUNKING_H
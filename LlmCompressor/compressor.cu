@@ -2,6 +2,7 @@
 #include <iostream>
 #include <cuda_runtime.h>
 #include <stdexcept>
+#include <algorithm>
 #include <nvcomp/zstd.hpp>
 
 // CUDA 에러 체크 헬퍼 함수
@@ -13,13 +14,10 @@
     } \
 }
 
-bool compress_safetensor(
+bool compress_header(
     const std::string& json_header,
-    const std::vector<char>& tensor_data,
-    CompressionResult& result,
-    int compression_level)
+    std::vector<char>& compressed_header)
 {
-
     try {
         cudaStream_t stream;
         CUDA_CHECK(cudaStreamCreate(&stream));
@@ -32,8 +30,8 @@ bool compress_safetensor(
                 nvcompBatchedZstdDecompressDefaultOpts,
                 stream);
 
-            // 1) JSON 헤더 압축 (빈 헤더는 건너뜀)
-            result.compressed_header.clear();
+            // JSON 헤더 압축 (빈 헤더는 건너뜀)
+            compressed_header.clear();
             if (!json_header.empty()) {
                 void* d_uncompressed_header = nullptr;
                 CUDA_CHECK(cudaMalloc(&d_uncompressed_header, json_header.size()));
@@ -54,10 +52,10 @@ bool compress_safetensor(
 
                 size_t actual_header_comp_size =
                     manager.get_compressed_output_size(reinterpret_cast<const uint8_t*>(d_compressed_header));
-                result.compressed_header.resize(actual_header_comp_size);
+                compressed_header.resize(actual_header_comp_size);
 
                 // 동기 복사(추가 동기화 불필요)
-                CUDA_CHECK(cudaMemcpy(result.compressed_header.data(),
+                CUDA_CHECK(cudaMemcpy(compressed_header.data(),
                                       d_compressed_header,
                                       actual_header_comp_size,
                                       cudaMemcpyDeviceToHost));
@@ -68,81 +66,124 @@ bool compress_safetensor(
                 std::cout << "JSON header compressed (GPU): " << json_header.size()
                           << " -> " << actual_header_comp_size << " bytes" << std::endl;
             }
+        } // 스트림 파괴 전에 매니저가 먼저 소멸됨
 
-            // 2) 텐서 데이터 GPU 압축 (빈 입력은 건너뜀)
-            result.compressed_tensors.clear();
-            result.chunk_info.clear();
-
-            if (!tensor_data.empty()) {
-                const size_t chunk_size = 1024ULL * 1024ULL * 64ULL; // 64MB
-                size_t num_chunks = (tensor_data.size() + chunk_size - 1) / chunk_size;
-                std::cout << "Starting tensor compression with " << num_chunks
-                          << " chunks on GPU using nvCOMP 5.0..." << std::endl;
+        CUDA_CHECK(cudaStreamDestroy(stream));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "An error occurred during GPU header compression: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
 
-                const size_t max_input_chunk = std::min(chunk_size, tensor_data.size());
+bool compress_chunks_streaming(
+    size_t total_size,
+    size_t first_chunk,
+    const ChunkReadFn& read_chunk,
+    const ChunkWriteFn& write_chunk,
+    int compression_level)
+{
+    return compress_chunks_streaming(fixed_chunk_plan(total_size), first_chunk, read_chunk, write_chunk,
+                                     compression_level);
+}
 
-                // 디바이스 버퍼를 반복 사용(과대할당 방지)
-                void* d_uncompressed_chunk = nullptr;
-                CUDA_CHECK(cudaMalloc(&d_uncompressed_chunk, max_input_chunk));
+std::vector<size_t> fixed_chunk_plan(size_t total_size)
+{
+    std::vector<size_t> chunk_sizes(total_size / KANG_CHUNK_SIZE, KANG_CHUNK_SIZE);
+    if (total_size % KANG_CHUNK_SIZE != 0) chunk_sizes.push_back(total_size % KANG_CHUNK_SIZE);
+    return chunk_sizes;
+}
 
-                auto comp_config_template = manager.configure_compression(max_input_chunk);
-                void* d_compressed_chunk = nullptr;
-                CUDA_CHECK(cudaMalloc(&d_compressed_chunk, comp_config_template.max_compressed_buffer_size));
+bool compress_chunks_streaming(
+    const std::vector<size_t>& chunk_sizes,
+    size_t first_chunk,
+    const ChunkReadFn& read_chunk,
+    const ChunkWriteFn& write_chunk,
+    int compression_level)
+{
+    (void)compression_level; // 현재 nvCOMP 기본 옵션 사용
 
-                // 호스트 임시 버퍼(페이지드). 필요 시 cudaHostAlloc으로 변경 가능
-                std::vector<char> host_comp_buf(comp_config_template.max_compressed_buffer_size);
+    const size_t num_chunks = chunk_sizes.size();
+    if (first_chunk >= num_chunks) return true; // 남은 청크 없음
 
-                const char* current_tensor_ptr = tensor_data.data();
-                size_t total_compressed_size = 0;
+    try {
+        cudaStream_t stream;
+        CUDA_CHECK(cudaStreamCreate(&stream));
 
-                for (size_t i = 0; i < num_chunks; ++i) {
-                    const size_t current_chunk_size =
-                        (i == num_chunks - 1)
-                            ? (tensor_data.size() - i * chunk_size)
-                            : chunk_size;
+        { // 매니저 수명 관리를 위한 새 스코프
+            const size_t internal_uncomp_chunk = 64 * 1024; // 64KB 권장
+            nvcomp::ZstdManager manager(
+                internal_uncomp_chunk,
+                nvcompBatchedZstdCompressDefaultOpts,
+                nvcompBatchedZstdDecompressDefaultOpts,
+                stream);
 
-                    CUDA_CHECK(cudaMemcpyAsync(d_uncompressed_chunk,
-                                               current_tensor_ptr,
-                                               current_chunk_size,
-                                               cudaMemcpyHostToDevice,
-                                               stream));
+            std::cout << "Starting tensor compression with " << num_chunks
+                      << " chunks on GPU using nvCOMP 5.0..." << std::endl;
+            if (first_chunk > 0) {
+                std::cout << "Resuming from chunk " << first_chunk << "." << std::endl;
+            }
 
-                    // 청크별 압축 설정
-                    auto comp_config = manager.configure_compression(current_chunk_size);
+            const size_t max_input_chunk = *std::max_element(chunk_sizes.begin() + first_chunk, chunk_sizes.end());
 
-                    // 압축 실행
-                    manager.compress(
-                        reinterpret_cast<const uint8_t*>(d_uncompressed_chunk),
-                        reinterpret_cast<uint8_t*>(d_compressed_chunk),
-                        comp_config);
+            // 디바이스 버퍼를 반복 사용(과대할당 방지)
+            void* d_uncompressed_chunk = nullptr;
+            CUDA_CHECK(cudaMalloc(&d_uncompressed_chunk, max_input_chunk));
 
-                    // 압축 완료 후 실제 크기 조회
-                    CUDA_CHECK(cudaStreamSynchronize(stream));
-                    const size_t actual_comp_size =
-                        manager.get_compressed_output_size(reinterpret_cast<const uint8_t*>(d_compressed_chunk));
+            auto comp_config_template = manager.configure_compression(max_input_chunk);
+            void* d_compressed_chunk = nullptr;
+            CUDA_CHECK(cudaMalloc(&d_compressed_chunk, comp_config_template.max_compressed_buffer_size));
 
-                    // 동기 복사로 호스트에 수신
-                    CUDA_CHECK(cudaMemcpy(host_comp_buf.data(),
-                                          d_compressed_chunk,
-                                          actual_comp_size,
-                                          cudaMemcpyDeviceToHost));
+            // 호스트 임시 버퍼(페이지드). 필요 시 cudaHostAlloc으로 변경 가능
+            std::vector<char> host_comp_buf(comp_config_template.max_compressed_buffer_size);
 
-                    // 결과 누적
-                    result.compressed_tensors.insert(result.compressed_tensors.end(),
-                                                     host_comp_buf.begin(),
-                                                     host_comp_buf.begin() + static_cast<std::ptrdiff_t>(actual_comp_size));
-                    result.chunk_info.push_back({ current_chunk_size, actual_comp_size });
-                    total_compressed_size += actual_comp_size;
+            for (size_t i = first_chunk; i < num_chunks; ++i) {
+                const size_t current_chunk_size = chunk_sizes[i];
 
-                    current_tensor_ptr += current_chunk_size;
+                const char* current_tensor_ptr = read_chunk(i, current_chunk_size);
+                if (current_tensor_ptr == nullptr) {
+                    CUDA_CHECK(cudaFree(d_uncompressed_chunk));
+                    CUDA_CHECK(cudaFree(d_compressed_chunk));
+                    throw std::runtime_error("Failed to read input chunk.");
                 }
 
-                CUDA_CHECK(cudaFree(d_uncompressed_chunk));
-                CUDA_CHECK(cudaFree(d_compressed_chunk));
+                CUDA_CHECK(cudaMemcpyAsync(d_uncompressed_chunk,
+                                           current_tensor_ptr,
+                                           current_chunk_size,
+                                           cudaMemcpyHostToDevice,
+                                           stream));
 
-                std::cout << "Tensor data compressed (GPU): " << tensor_data.size()
-                          << " -> " << total_compressed_size << " bytes" << std::endl;
+                // 청크별 압축 설정
+                auto comp_config = manager.configure_compression(current_chunk_size);
+
+                // 압축 실행
+                manager.compress(
+                    reinterpret_cast<const uint8_t*>(d_uncompressed_chunk),
+                    reinterpret_cast<uint8_t*>(d_compressed_chunk),
+                    comp_config);
+
+                // 압축 완료 후 실제 크기 조회
+                CUDA_CHECK(cudaStreamSynchronize(stream));
+                const size_t actual_comp_size =
+                    manager.get_compressed_output_size(reinterpret_cast<const uint8_t*>(d_compressed_chunk));
+
+                // 동기 복사로 호스트에 수신
+                CUDA_CHECK(cudaMemcpy(host_comp_buf.data(),
+                                      d_compressed_chunk,
+                                      actual_comp_size,
+                                      cudaMemcpyDeviceToHost));
+
+                // 완료된 청크를 바로 넘김
+                if (!write_chunk(i, host_comp_buf.data(), current_chunk_size, actual_comp_size)) {
+                    CUDA_CHECK(cudaFree(d_uncompressed_chunk));
+                    CUDA_CHECK(cudaFree(d_compressed_chunk));
+                    throw std::runtime_error("Failed to write compressed chunk.");
+                }
             }
+
+            CUDA_CHECK(cudaFree(d_uncompressed_chunk));
+            CUDA_CHECK(cudaFree(d_compressed_chunk));
         } // 스트림 파괴 전에 매니저가 먼저 소멸됨
 
         CUDA_CHECK(cudaStreamDestroy(stream));
@@ -154,6 +195,148 @@ bool compress_safetensor(
     return true;
 }
 
+bool compress_safetensor(
+    const std::string& json_header,
+    const std::vector<char>& tensor_data,
+    CompressionResult& result,
+    int compression_level,
+    const std::vector<size_t>& chunk_sizes)
+{
+    // 1) JSON 헤더 압축
+    if (!compress_header(json_header, result.compressed_header)) {
+        return false;
+    }
+
+    // 2) 텐서 데이터 GPU 압축 (빈 입력은 건너뜀)
+    result.compressed_tensors.clear();
+    result.chunk_info.clear();
+
+    if (!tensor_data.empty()) {
+        size_t total_compressed_size = 0;
+        const std::vector<size_t> plan = chunk_sizes.empty() ? fixed_chunk_plan(tensor_data.size()) : chunk_sizes;
+        size_t read_offset = 0;
+        bool ok = compress_chunks_streaming(
+            plan, 0,
+            [&](size_t, size_t size) {
+                const char* p = tensor_data.data() + read_offset;
+                read_offset += size;
+                return p;
+            },
+            [&](size_t, const char* data, size_t original_size, size_t compressed_size) {
+                // 결과 누적
+                result.compressed_tensors.insert(result.compressed_tensors.end(), data, data + compressed_size);
+                result.chunk_info.push_back({ original_size, compressed_size });
+                total_compressed_size += compressed_size;
+                return true;
+            },
+            compression_level);
+        if (!ok) return false;
+
+        std::cout << "Tensor data compressed (GPU): " << tensor_data.size()
+                  << " -> " << total_compressed_size << " bytes" << std::endl;
+    }
+    return true;
+}
+
+bool decompress_chunks_streaming(
+    size_t num_chunks,
+    const CompressedChunkReadFn& read_chunk,
+    const DecompressedChunkWriteFn& write_chunk)
+{
+    if (num_chunks == 0) return true;
+
+    try {
+        cudaStream_t stream;
+        CUDA_CHECK(cudaStreamCreate(&stream));
+
+        { // 매니저 관리를 위한 새 스코프
+            const size_t internal_uncomp_chunk = 64 * 1024;
+            nvcomp::ZstdManager manager(
+                internal_uncomp_chunk,
+                nvcompBatchedZstdCompressDefaultOpts,
+                nvcompBatchedZstdDecompressDefaultOpts,
+                stream);
+
+            // 디바이스/호스트 버퍼는 필요할 때만 키워서 재사용
+            void* d_compressed_chunk = nullptr;
+            void* d_decompressed_chunk = nullptr;
+            size_t d_compressed_capacity = 0;
+            size_t d_decompressed_capacity = 0;
+            std::vector<char> host_decomp_buf;
+
+            for (size_t i = 0; i < num_chunks; ++i) {
+                size_t compressed_size = 0;
+                size_t original_size = 0;
+                const char* compressed_ptr = read_chunk(i, compressed_size, original_size);
+                if (compressed_ptr == nullptr) {
+                    if (d_compressed_chunk) CUDA_CHECK(cudaFree(d_compressed_chunk));
+                    if (d_decompressed_chunk) CUDA_CHECK(cudaFree(d_decompressed_chunk));
+                    throw std::runtime_error("Failed to read compressed chunk.");
+                }
+
+                if (compressed_size > d_compressed_capacity) {
+                    if (d_compressed_chunk) CUDA_CHECK(cudaFree(d_compressed_chunk));
+                    CUDA_CHECK(cudaMalloc(&d_compressed_chunk, compressed_size));
+                    d_compressed_capacity = compressed_size;
+                }
+                if (original_size > d_decompressed_capacity) {
+                    if (d_decompressed_chunk) CUDA_CHECK(cudaFree(d_decompressed_chunk));
+                    CUDA_CHECK(cudaMalloc(&d_decompressed_chunk, original_size));
+                    d_decompressed_capacity = original_size;
+                }
+
+                CUDA_CHECK(cudaMemcpyAsync(d_compressed_chunk,
+                                           compressed_ptr,
+                                           compressed_size,
+                                           cudaMemcpyHostToDevice,
+                                           stream));
+
+                // 해제 설정(디바이스에서 헤더 읽음)
+                auto decomp_config =
+                    manager.configure_decompression(reinterpret_cast<const uint8_t*>(d_compressed_chunk));
+
+                // 검증: 예상 해제 크기 확인
+                if (decomp_config.decomp_data_size != original_size) {
+                    CUDA_CHECK(cudaStreamSynchronize(stream));
+                    CUDA_CHECK(cudaFree(d_compressed_chunk));
+                    CUDA_CHECK(cudaFree(d_decompressed_chunk));
+                    throw std::runtime_error("Decompressed size mismatch for chunk.");
+                }
+
+                manager.decompress(
+                    reinterpret_cast<uint8_t*>(d_decompressed_chunk),
+                    reinterpret_cast<const uint8_t*>(d_compressed_chunk),
+                    decomp_config);
+
+                // 해제 완료 보장
+                CUDA_CHECK(cudaStreamSynchronize(stream));
+
+                host_decomp_buf.resize(original_size);
+                CUDA_CHECK(cudaMemcpy(host_decomp_buf.data(),
+                                      d_decompressed_chunk,
+                                      original_size,
+                                      cudaMemcpyDeviceToHost));
+
+                if (!write_chunk(i, host_decomp_buf.data(), original_size)) {
+                    CUDA_CHECK(cudaFree(d_compressed_chunk));
+                    CUDA_CHECK(cudaFree(d_decompressed_chunk));
+                    throw std::runtime_error("Failed to write decompressed chunk.");
+                }
+            }
+
+            if (d_compressed_chunk) CUDA_CHECK(cudaFree(d_compressed_chunk));
+            if (d_decompressed_chunk) CUDA_CHECK(cudaFree(d_decompressed_chunk));
+        } // 스트림 파괴 전에 매니저가 먼저 소멸
+
+        CUDA_CHECK(cudaStreamDestroy(stream));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "An error occurred during GPU decompression: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
 bool decompress_kang(
     const std::vector<char>& compressed_header,
     const std::vector<char>& compressed_tensors,
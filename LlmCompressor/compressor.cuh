@@ -3,6 +3,14 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <cstddef>
+
+// 텐서 데이터 청크 크기 (원본 기준)
+constexpr size_t KANG_CHUNK_SIZE = 1024ULL * 1024ULL * 64ULL; // 64MB
+
+// nvCOMP zstd 는 압축 레벨 옵션이 없어 항상 기본 설정으로 압축함. NvcompZstd 청크/카탈로그에는 이 값을 기록
+constexpr int NVCOMP_ZSTD_LEVEL = 0;
 
 // 압축 결과를 담을 구조체
 struct CompressionResult {
@@ -16,7 +24,52 @@ bool compress_safetensor(
     const std::string& json_header,
     const std::vector<char>& tensor_data,
     CompressionResult& result,
-    int compression_level = 10 // Zstd 압축 레벨 (높을수록 압축률 증가)
+    int compression_level = 10, // Zstd 압축 레벨 (높을수록 압축률 증가)
+    const std::vector<size_t>& chunk_sizes = {} // 청크별 원본 크기 (비어 있으면 KANG_CHUNK_SIZE 고정)
+);
+
+// 청크 입력 콜백: chunk_index 번째 원본 청크(size 바이트)의 포인터 반환 (실패 시 nullptr)
+using ChunkReadFn = std::function<const char*(size_t chunk_index, size_t size)>;
+// 청크 출력 콜백: 압축이 끝난 청크를 즉시 넘겨받음 (false 반환 시 중단)
+using ChunkWriteFn = std::function<bool(size_t chunk_index, const char* data, size_t original_size, size_t compressed_size)>;
+
+// JSON 헤더만 압축
+bool compress_header(
+    const std::string& json_header,
+    std::vector<char>& compressed_header
+);
+
+// 텐서 데이터를 청크 단위로 스트리밍 압축 (first_chunk 부터 재개 가능)
+bool compress_chunks_streaming(
+    size_t total_size,
+    size_t first_chunk,
+    const ChunkReadFn& read_chunk,
+    const ChunkWriteFn& write_chunk,
+    int compression_level = 10
+);
+
+// 청크별 원본 크기를 지정해 스트리밍 압축 (청크는 순서대로 요청됨)
+bool compress_chunks_streaming(
+    const std::vector<size_t>& chunk_sizes,
+    size_t first_chunk,
+    const ChunkReadFn& read_chunk,
+    const ChunkWriteFn& write_chunk,
+    int compression_level = 10
+);
+
+// KANG_CHUNK_SIZE 고정 분할
+std::vector<size_t> fixed_chunk_plan(size_t total_size);
+
+// 압축 청크 입력 콜백: chunk_index 번째 압축 청크 포인터 반환 (크기는 인자로 채움, 실패 시 nullptr)
+using CompressedChunkReadFn = std::function<const char*(size_t chunk_index, size_t& compressed_size, size_t& original_size)>;
+// 해제 청크 출력 콜백
+using DecompressedChunkWriteFn = std::function<bool(size_t chunk_index, const char* data, size_t original_size)>;
+
+// 압축 청크 num_chunks 개를 순서대로 해제 (청크마다 크기가 달라도 됨)
+bool decompress_chunks_streaming(
+    size_t num_chunks,
+    const CompressedChunkReadFn& read_chunk,
+    const DecompressedChunkWriteFn& write_chunk
 );
 
 // 해제 함수 인터페이스
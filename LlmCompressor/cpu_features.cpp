@@ -0,0 +1,98 @@
+#include "cpu_features.h"
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define KANG_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+
+#ifdef KANG_X86
+void cpuid(uint32_t leaf, uint32_t sub, uint32_t regs[4])
+{
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(sub));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(r[i]);
+#else
+    __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// OS 가 저장/복원하는 레지스터 상태 (XCR0)
+uint64_t xgetbv0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t lo = 0, hi = 0;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+#endif
+
+SimdLevel parse_simd_level(const std::string& name, SimdLevel fallback)
+{
+    if (name == "scalar") return SimdLevel::Scalar;
+    if (name == "sse4") return SimdLevel::Sse41;
+    if (name == "avx2") return SimdLevel::Avx2;
+    if (name == "avx512") return SimdLevel::Avx512;
+    return fallback;
+}
+
+} // namespace
+
+SimdLevel detect_simd_level()
+{
+#ifdef KANG_X86
+    uint32_t r[4];
+    cpuid(0, 0, r);
+    const uint32_t max_leaf = r[0];
+    cpuid(1, 0, r);
+    const bool sse41 = (r[2] >> 19) & 1;
+    const bool osxsave = (r[2] >> 27) & 1;
+    const bool avx = (r[2] >> 28) & 1;
+    if (!sse41) return SimdLevel::Scalar;
+    if (!osxsave || !avx || max_leaf < 7) return SimdLevel::Sse41;
+    const uint64_t xcr0 = xgetbv0();
+    if ((xcr0 & 0x6) != 0x6) return SimdLevel::Sse41;      // XMM/YMM 상태
+    cpuid(7, 0, r);
+    const bool avx2 = (r[1] >> 5) & 1;
+    const bool avx512f = (r[1] >> 16) & 1;
+    if (!avx2) return SimdLevel::Sse41;
+    if (avx512f && (xcr0 & 0xE6) == 0xE6) return SimdLevel::Avx512; // opmask/ZMM 상태
+    return SimdLevel::Avx2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel active_simd_level()
+{
+    static const SimdLevel level = [] {
+        const SimdLevel detected = detect_simd_level();
+        const char* env = std::getenv("KANG_SIMD");
+        if (!env) return detected;
+        const SimdLevel wanted = parse_simd_level(env, detected);
+        return wanted < detected ? wanted : detected;
+    }();
+    return level;
+}
+
+const char* simd_level_name(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Sse41: return "SSE4.1";
+    case SimdLevel::Avx2: return "AVX2";
+    case SimdLevel::Avx512: return "AVX-512";
+    default: return "scalar";
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// 런타임 CPU 기능 감지 (CPUID + XGETBV). SIMD 커널 선택용
+enum class SimdLevel {
+    Scalar = 0,
+    Sse41 = 1,
+    Avx2 = 2,
+    Avx512 = 3,   // AVX-512F
+};
+
+// CPU 와 OS 가 모두 지원하는 최고 수준 (x86 이 아니면 Scalar)
+SimdLevel detect_simd_level();
+
+// 실제로 쓸 수준 = detect_simd_level() 을 $KANG_SIMD (scalar|sse4|avx2|avx512) 로 낮춘 값. 처음 호출 시 결정
+SimdLevel active_simd_level();
+
+const char* simd_level_name(SimdLevel level);
+
+#endif //CPU_FEATURES_H
@@ -0,0 +1,366 @@
+#include "dictionary.h"
+#include "compressor.cuh"
+#include "safetensors.h"
+#include "file_util.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <zstd.h>
+#include <zdict.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t ZSTD_FRAME_MAGIC = 0xFD2FB528U;
+// 사전을 담는 zstd 스키퍼블 프레임 (표준 zstd 는 내용을 무시하고 건너뜀)
+const uint32_t KANG_DICT_SKIPPABLE_MAGIC = 0x184D2A5AU;
+
+uint32_t read_u32(const char* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void append_u32(std::vector<char>& out, uint32_t v)
+{
+    const char* p = reinterpret_cast<const char*>(&v);
+    out.insert(out.end(), p, p + sizeof(v));
+}
+
+// 포함된 사전 프레임이 있으면 그 범위와 뒤따르는 zstd 프레임 위치를 알려줌
+bool split_embedded_dict(const char* src, size_t size, const char*& dict, size_t& dict_size,
+                         const char*& frame, size_t& frame_size)
+{
+    dict = nullptr;
+    dict_size = 0;
+    frame = src;
+    frame_size = size;
+    if (size >= 8 && read_u32(src) == KANG_DICT_SKIPPABLE_MAGIC) {
+        const uint32_t n = read_u32(src + 4);
+        if (static_cast<size_t>(n) > size - 8) return false;
+        dict = src + 8;
+        dict_size = n;
+        frame = src + 8 + n;
+        frame_size = size - 8 - n;
+    }
+    return frame_size >= 4 && read_u32(frame) == ZSTD_FRAME_MAGIC;
+}
+
+bool try_load_dictionary(const fs::path& path, uint32_t id, ZstdDictionary& dict)
+{
+    if (path.empty() || !fs::exists(path)) return false;
+    ZstdDictionary d;
+    if (!load_dictionary(path, d) || d.id != id) return false;
+    dict = std::move(d);
+    return true;
+}
+
+bool read_file(const fs::path& path, std::vector<char>& buf)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    in.seekg(0, std::ios::end);
+    std::streamoff sz = in.tellg();
+    if (sz < 0) return false;
+    buf.resize(static_cast<size_t>(sz));
+    in.seekg(0, std::ios::beg);
+    in.read(buf.data(), buf.size());
+    return in.good() || buf.empty();
+}
+
+int clamp_level(int level)
+{
+    return std::max(1, std::min(level, ZSTD_maxCLevel()));
+}
+
+} // namespace
+
+bool load_dictionary(const fs::path& path, ZstdDictionary& dict)
+{
+    if (!read_file(path, dict.data) || dict.data.empty()) {
+        std::cerr << "Error: Cannot read dictionary " << path.string() << std::endl;
+        return false;
+    }
+    dict.id = ZDICT_getDictID(dict.data.data(), dict.data.size());
+    if (dict.id == 0) {
+        std::cerr << "Error: " << path.string() << " is not a zstd dictionary." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool is_cpu_zstd_blob(const char* data, size_t size)
+{
+    if (size < 4) return false;
+    const uint32_t magic = read_u32(data);
+    return magic == ZSTD_FRAME_MAGIC || magic == KANG_DICT_SKIPPABLE_MAGIC;
+}
+
+bool compress_with_dictionary(const char* src, size_t size, const ZstdDictionary& dict,
+                              int level, bool embed, std::vector<char>& out)
+{
+    out.clear();
+    if (embed) {
+        append_u32(out, KANG_DICT_SKIPPABLE_MAGIC);
+        append_u32(out, static_cast<uint32_t>(dict.data.size()));
+        out.insert(out.end(), dict.data.begin(), dict.data.end());
+    }
+    const size_t prefix = out.size();
+
+    ZSTD_CDict* cdict = ZSTD_createCDict(dict.data.data(), dict.data.size(), clamp_level(level));
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    if (!cdict || !cctx) {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeCCtx(cctx);
+        std::cerr << "Error: Cannot create zstd dictionary context." << std::endl;
+        return false;
+    }
+    out.resize(prefix + ZSTD_compressBound(size));
+    const size_t r = ZSTD_compress_usingCDict(cctx, out.data() + prefix, out.size() - prefix, src, size, cdict);
+    ZSTD_freeCCtx(cctx);
+    ZSTD_freeCDict(cdict);
+    if (ZSTD_isError(r)) {
+        std::cerr << "Error: zstd dictionary compression failed: " << ZSTD_getErrorName(r) << std::endl;
+        return false;
+    }
+    out.resize(prefix + r);
+    return true;
+}
+
+bool resolve_dictionary(const char* src, size_t size, const fs::path& archive_path,
+                        const fs::path& dict_path, ZstdDictionary& dict)
+{
+    const char* embedded = nullptr;
+    const char* frame = nullptr;
+    size_t embedded_size = 0, frame_size = 0;
+    if (!split_embedded_dict(src, size, embedded, embedded_size, frame, frame_size)) {
+        std::cerr << "Error: Invalid zstd block." << std::endl;
+        return false;
+    }
+    const uint32_t id = ZSTD_getDictID_fromFrame(frame, frame_size);
+    dict = ZstdDictionary();
+    if (id == 0) return true;
+
+    if (embedded) {
+        dict.data.assign(embedded, embedded + embedded_size);
+        dict.id = ZDICT_getDictID(dict.data.data(), dict.data.size());
+        if (dict.id == id) return true;
+    }
+    const std::string name = std::to_string(id) + ".zdict";
+    if (try_load_dictionary(dict_path, id, dict)) return true;
+    if (const char* dir = std::getenv(KANG_DICT_DIR_ENV)) {
+        if (try_load_dictionary(fs::path(dir) / name, id, dict)) return true;
+    }
+    if (try_load_dictionary(archive_path.parent_path() / name, id, dict)) return true;
+
+    std::cerr << "Error: Dictionary " << id << " not found. Pass --dict or put " << name
+              << " in " << KANG_DICT_DIR_ENV << "." << std::endl;
+    return false;
+}
+
+bool decompress_with_dictionary(const char* src, size_t size, const ZstdDictionary& dict, std::vector<char>& out)
+{
+    const char* embedded = nullptr;
+    const char* frame = nullptr;
+    size_t embedded_size = 0, frame_size = 0;
+    if (!split_embedded_dict(src, size, embedded, embedded_size, frame, frame_size)) {
+        std::cerr << "Error: Invalid zstd block." << std::endl;
+        return false;
+    }
+    const unsigned long long content = ZSTD_getFrameContentSize(frame, frame_size);
+    if (content == ZSTD_CONTENTSIZE_ERROR || content == ZSTD_CONTENTSIZE_UNKNOWN) {
+        std::cerr << "Error: zstd block has no content size." << std::endl;
+        return false;
+    }
+    out.resize(static_cast<size_t>(content));
+
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (!dctx) return false;
+    const size_t r = ZSTD_decompress_usingDict(dctx, out.data(), out.size(), frame, frame_size,
+                                               dict.data.empty() ? nullptr : dict.data.data(), dict.data.size());
+    ZSTD_freeDCtx(dctx);
+    if (ZSTD_isError(r) || r != out.size()) {
+        std::cerr << "Error: zstd dictionary decompression failed: "
+                  << (ZSTD_isError(r) ? ZSTD_getErrorName(r) : "size mismatch") << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool compress_header_blob(const std::string& json_header, const CompressOptions& options,
+                          std::vector<char>& compressed_header)
+{
+    if (options.dict_path.empty()) {
+        return compress_header(json_header, compressed_header);
+    }
+    compressed_header.clear();
+    if (json_header.empty()) return true;
+
+    ZstdDictionary dict;
+    if (!load_dictionary(options.dict_path, dict)) return false;
+    if (!compress_with_dictionary(json_header.data(), json_header.size(), dict, options.level,
+                                  options.embed_dict, compressed_header)) {
+        return false;
+    }
+    std::cout << "JSON header compressed (CPU, dict " << dict.id << "): " << json_header.size()
+              << " -> " << compressed_header.size() << " bytes" << std::endl;
+    return true;
+}
+
+bool decompress_header_blob(const std::vector<char>& compressed_header, const fs::path& archive_path,
+                            const fs::path& dict_path, std::string& json_header, ZstdDictionary& dict)
+{
+    dict = ZstdDictionary();
+    json_header.clear();
+    if (!is_cpu_zstd_blob(compressed_header.data(), compressed_header.size())) {
+        std::vector<char> no_tensor_data;
+        return decompress_kang(compressed_header, std::vector<char>(), std::vector<std::pair<size_t, size_t>>(),
+                               json_header, no_tensor_data);
+    }
+    std::vector<char> header_buf;
+    if (!resolve_dictionary(compressed_header.data(), compressed_header.size(), archive_path, dict_path, dict) ||
+        !decompress_with_dictionary(compressed_header.data(), compressed_header.size(), dict, header_buf)) {
+        return false;
+    }
+    json_header.assign(header_buf.begin(), header_buf.end());
+    return true;
+}
+
+bool compress_small_with_dictionary(const std::string& json_header, const std::vector<char>& tensor_data,
+                                    const CompressOptions& options, std::vector<char>& compressed_header,
+                                    std::vector<char>& compressed_tensors,
+                                    std::vector<std::pair<size_t, size_t>>& chunk_info)
+{
+    ZstdDictionary dict;
+    if (!load_dictionary(options.dict_path, dict)) return false;
+
+    compressed_header.clear();
+    if (!json_header.empty()) {
+        if (!compress_with_dictionary(json_header.data(), json_header.size(), dict, options.level,
+                                      options.embed_dict, compressed_header)) {
+            return false;
+        }
+        std::cout << "JSON header compressed (CPU, dict " << dict.id << "): " << json_header.size()
+                  << " -> " << compressed_header.size() << " bytes" << std::endl;
+    }
+
+    compressed_tensors.clear();
+    chunk_info.clear();
+    if (tensor_data.empty()) return true;
+
+    // 사전은 헤더 쪽에만 포함 (해제 시 헤더에서 찾은 사전을 재사용)
+    if (!compress_with_dictionary(tensor_data.data(), tensor_data.size(), dict, options.level, false, compressed_tensors)) {
+        return false;
+    }
+    chunk_info.push_back({ tensor_data.size(), compressed_tensors.size() });
+    std::cout << "Tensor data compressed (CPU, dict " << dict.id << "): " << tensor_data.size()
+              << " -> " << compressed_tensors.size() << " bytes" << std::endl;
+    return true;
+}
+
+void handle_train_dict(const std::vector<fs::path>& inputs, const fs::path& output_path, size_t dict_size)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Training dictionary -> " << output_path.string() << std::endl;
+
+    // 1. 샘플 수집: safetensors 헤더 + 작은 텐서, 작은 JSON 파일
+    const size_t max_total = 1024ULL * 1024ULL * 512ULL; // 학습 메모리 상한
+    std::vector<char> samples;
+    std::vector<size_t> sample_sizes;
+    size_t header_samples = 0, tensor_samples = 0, json_samples = 0;
+
+    auto add_sample = [&](const char* p, size_t n) {
+        if (n == 0 || samples.size() + n > max_total) return false;
+        samples.insert(samples.end(), p, p + n);
+        sample_sizes.push_back(n);
+        return true;
+    };
+
+    std::vector<fs::path> files;
+    for (const auto& in : inputs) {
+        if (fs::is_directory(in)) {
+            for (const auto& entry : fs::recursive_directory_iterator(in)) {
+                if (entry.is_regular_file()) files.push_back(entry.path());
+            }
+        } else if (fs::is_regular_file(in)) {
+            files.push_back(in);
+        } else {
+            std::cerr << "Warning: Skipping " << in.string() << " (not found)." << std::endl;
+        }
+    }
+
+    for (const auto& path : files) {
+        const std::string ext = path.extension().string();
+        if (ext == ".json") {
+            std::vector<char> buf;
+            if (fs::file_size(path) <= 1024 * 1024 && read_file(path, buf) && add_sample(buf.data(), buf.size())) {
+                ++json_samples;
+            }
+            continue;
+        }
+        if (ext != ".safetensors") continue;
+
+        std::FILE* f = file_open(path, "rb");
+        if (!f) continue;
+        uint64_t header_len = 0;
+        const uint64_t file_size = fs::file_size(path);
+        std::string json_header;
+        if (file_read_at(f, 0, &header_len, sizeof(header_len)) && header_len <= file_size - 8 && header_len < max_total) {
+            json_header.resize(static_cast<size_t>(header_len));
+            if (header_len > 0 && !file_read_at(f, 8, &json_header[0], json_header.size())) json_header.clear();
+        }
+        if (!json_header.empty() && add_sample(json_header.data(), json_header.size())) ++header_samples;
+
+        std::vector<TensorInfo> tensors;
+        if (!json_header.empty() && parse_safetensors_header(json_header, tensors)) {
+            std::vector<char> buf;
+            for (const auto& t : tensors) {
+                const uint64_t n = t.data_end - t.data_begin;
+                if (n == 0 || n > KANG_DICT_SAMPLE_TENSOR_MAX || 8 + header_len + t.data_end > file_size) continue;
+                buf.resize(static_cast<size_t>(n));
+                if (file_read_at(f, 8 + header_len + t.data_begin, buf.data(), buf.size()) &&
+                    add_sample(buf.data(), buf.size())) {
+                    ++tensor_samples;
+                }
+            }
+        }
+        std::fclose(f);
+    }
+
+    std::cout << "Samples: " << header_samples << " headers, " << tensor_samples << " small tensors, "
+              << json_samples << " JSON files (" << samples.size() << " bytes)" << std::endl;
+    if (sample_sizes.size() < 8) {
+        std::cerr << "Error: Not enough samples to train a dictionary (need at least 8)." << std::endl;
+        return;
+    }
+    if (samples.size() < dict_size * 10) {
+        std::cout << "Warning: Sample set is small for a " << dict_size << "-byte dictionary; ratio gains may be limited." << std::endl;
+    }
+
+    // 2. 학습
+    std::vector<char> dict(dict_size);
+    const size_t r = ZDICT_trainFromBuffer(dict.data(), dict.size(), samples.data(), sample_sizes.data(),
+                                           static_cast<unsigned>(sample_sizes.size()));
+    if (ZDICT_isError(r)) {
+        std::cerr << "Error: Dictionary training failed: " << ZDICT_getErrorName(r) << std::endl;
+        return;
+    }
+    dict.resize(r);
+    const unsigned id = ZDICT_getDictID(dict.data(), dict.size());
+
+    std::ofstream out(output_path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        return;
+    }
+    out.write(dict.data(), dict.size());
+    out.close();
+
+    std::cout << "Dictionary " << id << " trained: " << dict.size() << " bytes." << std::endl;
+    std::cout << "Use it with 'kang compress --dict " << output_path.string() << "', and share it as "
+              << id << ".zdict in " << KANG_DICT_DIR_ENV << " for decompression." << std::endl;
+}
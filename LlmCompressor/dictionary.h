@@ -0,0 +1,61 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "options.h"
+
+// 사전을 쓰는 작은 파일은 텐서 데이터도 GPU 대신 CPU zstd+사전으로 한 번에 압축
+constexpr size_t KANG_DICT_MAX_SMALL_DATA = 1024 * 1024 * 8; // 8MB
+// 사전 학습 시 샘플로 쓰는 작은 텐서 최대 크기
+constexpr size_t KANG_DICT_SAMPLE_TENSOR_MAX = 1024 * 64;
+// 기본 사전 크기 (zstd 권장값)
+constexpr size_t KANG_DICT_DEFAULT_SIZE = 112640;
+
+struct ZstdDictionary {
+    uint32_t id = 0;
+    std::vector<char> data;
+};
+
+// 사전 공유 위치 환경 변수: <KANG_DICT_DIR>/<id>.zdict
+constexpr const char* KANG_DICT_DIR_ENV = "KANG_DICT_DIR";
+
+bool load_dictionary(const std::filesystem::path& path, ZstdDictionary& dict);
+
+// 블록이 CPU zstd 프레임(사전 압축)인지 확인. nvCOMP 포맷이면 false
+bool is_cpu_zstd_blob(const char* data, size_t size);
+
+// 사전 압축 (CPU). embed 이면 사전을 zstd 스키퍼블 프레임으로 앞에 붙임
+bool compress_with_dictionary(const char* src, size_t size, const ZstdDictionary& dict,
+                              int level, bool embed, std::vector<char>& out);
+
+// 블록이 쓰는 사전을 찾음: 포함된 사전 -> dict_path -> KANG_DICT_DIR -> 아카이브 옆 <id>.zdict
+// 사전 없이 압축된 블록이면 dict.id == 0 으로 성공
+bool resolve_dictionary(const char* src, size_t size, const std::filesystem::path& archive_path,
+                        const std::filesystem::path& dict_path, ZstdDictionary& dict);
+
+// 사전 해제 (CPU). 앞에 포함된 사전 프레임은 건너뜀
+bool decompress_with_dictionary(const char* src, size_t size, const ZstdDictionary& dict, std::vector<char>& out);
+
+// 압축 JSON 헤더 해제: 사전 압축(CPU zstd)이면 CPU, 아니면 GPU. dict 에 사용한 사전을 돌려줌
+bool decompress_header_blob(const std::vector<char>& compressed_header, const std::filesystem::path& archive_path,
+                            const std::filesystem::path& dict_path, std::string& json_header, ZstdDictionary& dict);
+
+// 작은 safetensors: 헤더와 텐서 데이터를 모두 CPU zstd+사전으로 압축 (텐서는 청크 1개)
+bool compress_small_with_dictionary(const std::string& json_header, const std::vector<char>& tensor_data,
+                                    const CompressOptions& options, std::vector<char>& compressed_header,
+                                    std::vector<char>& compressed_tensors,
+                                    std::vector<std::pair<size_t, size_t>>& chunk_info);
+
+// JSON 헤더 압축: 사전이 있으면 CPU, 없으면 GPU
+bool compress_header_blob(const std::string& json_header, const CompressOptions& options,
+                          std::vector<char>& compressed_header);
+
+// 헤더/샘플로 사전 학습 (입력은 파일 또는 디렉터리)
+void handle_train_dict(const std::vector<std::filesystem::path>& inputs,
+                       const std::filesystem::path& output_path, size_t dict_size);
+
+#endif //DICTIONARY_H
@@ -0,0 +1,320 @@
+#include "dtype_kernels.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+struct DTypeInfo {
+    DType dtype;
+    const char* name;
+    uint8_t width;
+    DTypeKind kind;
+};
+
+// DType 번호 순서 (kInfo[n - 1] = DType n)
+constexpr DTypeInfo kInfo[] = {
+    { DType::Bool, "BOOL", 1, DTypeKind::Unsigned },
+    { DType::U8, "U8", 1, DTypeKind::Unsigned },
+    { DType::I8, "I8", 1, DTypeKind::Signed },
+    { DType::F8_E4M3, "F8_E4M3", 1, DTypeKind::Float },
+    { DType::F8_E5M2, "F8_E5M2", 1, DTypeKind::Float },
+    { DType::U16, "U16", 2, DTypeKind::Unsigned },
+    { DType::I16, "I16", 2, DTypeKind::Signed },
+    { DType::F16, "F16", 2, DTypeKind::Float },
+    { DType::BF16, "BF16", 2, DTypeKind::Float },
+    { DType::U32, "U32", 4, DTypeKind::Unsigned },
+    { DType::I32, "I32", 4, DTypeKind::Signed },
+    { DType::F32, "F32", 4, DTypeKind::Float },
+    { DType::U64, "U64", 8, DTypeKind::Unsigned },
+    { DType::I64, "I64", 8, DTypeKind::Signed },
+    { DType::F64, "F64", 8, DTypeKind::Float },
+};
+
+template <size_t W> struct UintOf;
+template <> struct UintOf<1> { using type = uint8_t; };
+template <> struct UintOf<2> { using type = uint16_t; };
+template <> struct UintOf<4> { using type = uint32_t; };
+template <> struct UintOf<8> { using type = uint64_t; };
+
+template <typename U>
+inline U load(const char* p)
+{
+    U v;
+    std::memcpy(&v, p, sizeof(U));
+    return v;
+}
+
+template <typename U>
+inline void store(char* p, U v)
+{
+    std::memcpy(p, &v, sizeof(U));
+}
+
+inline float bits_to_float(uint32_t bits)
+{
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+inline float half_to_float(uint16_t h)
+{
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    const uint32_t exp = (h >> 10) & 0x1f;
+    const uint32_t mant = h & 0x3ff;
+    if (exp == 0x1f) return bits_to_float(sign | 0x7f800000 | (mant << 13));
+    if (exp == 0) {
+        const float f = static_cast<float>(mant) * (1.0f / 16777216.0f); // 비정규수: mant * 2^-24
+        return sign ? -f : f;
+    }
+    return bits_to_float(sign | ((exp + 112) << 23) | (mant << 13));
+}
+
+// F8_E4M3 (fn): 지수 바이어스 7, 무한대 없음, S.1111.111 = NaN
+inline float e4m3_to_float(uint8_t v)
+{
+    const uint32_t sign = static_cast<uint32_t>(v & 0x80) << 24;
+    const uint32_t exp = (v >> 3) & 0xf;
+    const uint32_t mant = v & 0x7;
+    if (exp == 0xf && mant == 0x7) return bits_to_float(sign | 0x7fc00000);
+    if (exp == 0) {
+        const float f = static_cast<float>(mant) * (1.0f / 512.0f); // mant * 2^-9
+        return sign ? -f : f;
+    }
+    return bits_to_float(sign | ((exp + 120) << 23) | (mant << 20));
+}
+
+// 부호를 최하위 비트로: 실수는 왼쪽 1비트 회전, 부호 있는 정수는 zigzag
+template <typename U, DTypeKind K>
+inline U fold(U v)
+{
+    constexpr unsigned bits = sizeof(U) * 8;
+    if constexpr (K == DTypeKind::Float) return static_cast<U>((v << 1) | (v >> (bits - 1)));
+    else if constexpr (K == DTypeKind::Signed) return static_cast<U>((v << 1) ^ (U(0) - (v >> (bits - 1))));
+    else return v;
+}
+
+template <typename U, DTypeKind K>
+inline U unfold(U v)
+{
+    constexpr unsigned bits = sizeof(U) * 8;
+    if constexpr (K == DTypeKind::Float) return static_cast<U>((v >> 1) | (v << (bits - 1)));
+    else if constexpr (K == DTypeKind::Signed) return static_cast<U>((v >> 1) ^ (U(0) - (v & 1)));
+    else return v;
+}
+
+template <typename U, DTypeKind K>
+void fold_split_kernel(const char* src, size_t count, char* dst)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const U v = fold<U, K>(load<U>(src + i * sizeof(U)));
+        for (size_t b = 0; b < sizeof(U); ++b) dst[b * count + i] = static_cast<char>(v >> (8 * b));
+    }
+}
+
+template <typename U, DTypeKind K>
+void merge_unfold_kernel(const char* src, size_t count, char* dst)
+{
+    for (size_t i = 0; i < count; ++i) {
+        U v = 0;
+        for (size_t b = 0; b < sizeof(U); ++b) {
+            v = static_cast<U>(v | static_cast<U>(static_cast<U>(static_cast<uint8_t>(src[b * count + i])) << (8 * b)));
+        }
+        store<U>(dst + i * sizeof(U), unfold<U, K>(v));
+    }
+}
+
+template <typename U>
+void delta_encode_kernel(const char* src, size_t count, char* dst)
+{
+    U prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const U v = load<U>(src + i * sizeof(U));
+        store<U>(dst + i * sizeof(U), static_cast<U>(v - prev));
+        prev = v;
+    }
+}
+
+template <typename U>
+void delta_decode_kernel(const char* src, size_t count, char* dst)
+{
+    U acc = 0;
+    for (size_t i = 0; i < count; ++i) {
+        acc = static_cast<U>(acc + load<U>(src + i * sizeof(U)));
+        store<U>(dst + i * sizeof(U), acc);
+    }
+}
+
+template <DType D, typename U, DTypeKind K>
+inline float convert(U v)
+{
+    if constexpr (D == DType::BF16) return bits_to_float(static_cast<uint32_t>(v) << 16);
+    else if constexpr (D == DType::F16) return half_to_float(v);
+    else if constexpr (D == DType::F8_E5M2) return half_to_float(static_cast<uint16_t>(v << 8));
+    else if constexpr (D == DType::F8_E4M3) return e4m3_to_float(v);
+    else if constexpr (D == DType::F32) return bits_to_float(v);
+    else if constexpr (D == DType::F64) {
+        double d;
+        std::memcpy(&d, &v, sizeof(d));
+        return static_cast<float>(d);
+    }
+    else if constexpr (K == DTypeKind::Signed) return static_cast<float>(static_cast<std::make_signed_t<U>>(v));
+    else return static_cast<float>(v);
+}
+
+template <DType D, typename U, DTypeKind K>
+void to_float_kernel(const char* src, size_t count, float* dst)
+{
+    for (size_t i = 0; i < count; ++i) dst[i] = convert<D, U, K>(load<U>(src + i * sizeof(U)));
+}
+
+template <size_t I>
+constexpr DTypeKernels make_kernels()
+{
+    constexpr DTypeInfo info = kInfo[I];
+    using U = typename UintOf<info.width>::type;
+    return { info.dtype, info.name, info.width, info.kind,
+             &fold_split_kernel<U, DTypeKind::Unsigned>, &merge_unfold_kernel<U, DTypeKind::Unsigned>,
+             &fold_split_kernel<U, info.kind>, &merge_unfold_kernel<U, info.kind>,
+             &delta_encode_kernel<U>, &delta_decode_kernel<U>,
+             &to_float_kernel<info.dtype, U, info.kind> };
+}
+
+template <size_t... I>
+constexpr std::array<DTypeKernels, sizeof...(I)> make_table(std::index_sequence<I...>)
+{
+    return { { make_kernels<I>()... } };
+}
+
+constexpr auto kKernels = make_table(std::make_index_sequence<sizeof(kInfo) / sizeof(kInfo[0])>());
+
+// --- 벤치마크 비교용 일반 구현: 원소마다 폭/종류/dtype 을 런타임에 분기 ---
+
+void generic_fold_split(const DTypeKernels& k, const char* src, size_t count, char* dst)
+{
+    const unsigned bits = k.width * 8u;
+    const uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t v = 0;
+        std::memcpy(&v, src + i * k.width, k.width);
+        switch (k.kind) {
+        case DTypeKind::Float: v = ((v << 1) | (v >> (bits - 1))) & mask; break;
+        case DTypeKind::Signed: v = ((v << 1) ^ (0 - (v >> (bits - 1)))) & mask; break;
+        default: break;
+        }
+        for (size_t b = 0; b < k.width; ++b) dst[b * count + i] = static_cast<char>(v >> (8 * b));
+    }
+}
+
+void generic_merge_unfold(const DTypeKernels& k, const char* src, size_t count, char* dst)
+{
+    const unsigned bits = k.width * 8u;
+    const uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t v = 0;
+        for (size_t b = 0; b < k.width; ++b) v |= static_cast<uint64_t>(static_cast<uint8_t>(src[b * count + i])) << (8 * b);
+        switch (k.kind) {
+        case DTypeKind::Float: v = ((v >> 1) | (v << (bits - 1))) & mask; break;
+        case DTypeKind::Signed: v = ((v >> 1) ^ (0 - (v & 1))) & mask; break;
+        default: break;
+        }
+        std::memcpy(dst + i * k.width, &v, k.width);
+    }
+}
+
+void generic_to_float(const DTypeKernels& k, const char* src, size_t count, float* dst)
+{
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t v = 0;
+        std::memcpy(&v, src + i * k.width, k.width);
+        switch (k.dtype) {
+        case DType::BF16: dst[i] = bits_to_float(static_cast<uint32_t>(v) << 16); break;
+        case DType::F16: dst[i] = half_to_float(static_cast<uint16_t>(v)); break;
+        case DType::F8_E5M2: dst[i] = half_to_float(static_cast<uint16_t>(v << 8)); break;
+        case DType::F8_E4M3: dst[i] = e4m3_to_float(static_cast<uint8_t>(v)); break;
+        case DType::F32: dst[i] = bits_to_float(static_cast<uint32_t>(v)); break;
+        case DType::F64: { double d; std::memcpy(&d, &v, sizeof(d)); dst[i] = static_cast<float>(d); break; }
+        case DType::I8: dst[i] = static_cast<float>(static_cast<int8_t>(v)); break;
+        case DType::I16: dst[i] = static_cast<float>(static_cast<int16_t>(v)); break;
+        case DType::I32: dst[i] = static_cast<float>(static_cast<int32_t>(v)); break;
+        case DType::I64: dst[i] = static_cast<float>(static_cast<int64_t>(v)); break;
+        default: dst[i] = static_cast<float>(v); break;
+        }
+    }
+}
+
+} // namespace
+
+const DTypeKernels* dtype_kernels(const std::string& dtype)
+{
+    for (const auto& k : kKernels) {
+        if (dtype == k.name) return &k;
+    }
+    return nullptr;
+}
+
+const DTypeKernels* dtype_kernels(DType dtype)
+{
+    const size_t n = static_cast<size_t>(dtype);
+    return n >= 1 && n <= kKernels.size() ? &kKernels[n - 1] : nullptr;
+}
+
+void handle_bench_transforms(size_t megabytes)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Transform kernel benchmark (generic per-element dispatch vs dtype-specialized, single thread)" << std::endl;
+    const size_t size = std::max<size_t>(megabytes, 1) * 1024 * 1024;
+    std::vector<char> src(size), a(size), b(size);
+    std::vector<float> fa(size), fb(size);
+    std::mt19937_64 rng(42);
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        const uint64_t v = rng();
+        std::memcpy(&src[i], &v, sizeof(v));
+    }
+
+    // 최소 3 회, 합계 0.5 초 이상 반복해서 가장 빠른 시간
+    auto measure = [](const auto& fn) {
+        double best = 1e30, total = 0;
+        for (int iter = 0; iter < 3 || total < 0.5; ++iter) {
+            auto t = std::chrono::high_resolution_clock::now();
+            fn();
+            const double sec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t).count();
+            best = std::min(best, sec);
+            total += sec;
+        }
+        return best;
+    };
+    auto rate = [&](double sec) { return static_cast<double>(size) / sec / 1e9; };
+
+    std::cout << std::left << std::setw(10) << "dtype" << std::setw(14) << "kernel" << std::right
+              << std::setw(12) << "generic" << std::setw(14) << "specialized" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const char* name : { "BF16", "F16", "F32", "F8_E4M3", "I64" }) {
+        const DTypeKernels& k = *dtype_kernels(name);
+        const size_t count = size / k.width;
+        struct Row { const char* op; double generic; double special; bool same; };
+        Row rows[3];
+
+        rows[0] = { "fold+split", measure([&] { generic_fold_split(k, src.data(), count, a.data()); }),
+                    measure([&] { k.fold_split(src.data(), count, b.data()); }), a == b };
+        rows[1] = { "merge+unfold", measure([&] { generic_merge_unfold(k, b.data(), count, a.data()); }),
+                    measure([&] { k.merge_unfold(b.data(), count, a.data()); }), a == src };
+        generic_to_float(k, src.data(), count, fa.data());
+        k.to_float(src.data(), count, fb.data());
+        rows[2] = { "to_float", measure([&] { generic_to_float(k, src.data(), count, fa.data()); }),
+                    measure([&] { k.to_float(src.data(), count, fb.data()); }),
+                    std::memcmp(fa.data(), fb.data(), count * sizeof(float)) == 0 };
+        for (const Row& r : rows) {
+            std::cout << std::left << std::setw(10) << name << std::setw(14) << r.op << std::right
+                      << std::setw(7) << rate(r.generic) << " GB/s" << std::setw(9) << rate(r.special) << " GB/s"
+                      << (r.same ? "" : "  MISMATCH") << std::endl;
+        }
+    }
+}
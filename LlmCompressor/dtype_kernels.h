@@ -0,0 +1,54 @@
+#ifndef DTYPE_KERNELS_H
+#define DTYPE_KERNELS_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// dtype 별로 특수화한 원소 변환 커널
+// 커널은 원소 저장형(uint8/16/32/64)과 부호 종류를 템플릿 인자로 받아 컴파일 시간에 인스턴스화되고,
+// dtype 문자열 -> 커널 묶음 표(constexpr)로 청크/텐서마다 한 번만 고름. 내부 루프에는 dtype 분기가 없음.
+// 모든 커널은 count 개 원소 단위 (리틀 엔디안 safetensors 기준, 끝의 나머지 바이트는 호출자가 처리)
+
+// 아카이브에 기록되는 dtype 번호 (ChunkTransform::SignSplit 의 transform_param). 값 변경 금지
+enum class DType : uint8_t {
+    Unknown = 0,
+    Bool = 1, U8 = 2, I8 = 3, F8_E4M3 = 4, F8_E5M2 = 5,
+    U16 = 6, I16 = 7, F16 = 8, BF16 = 9,
+    U32 = 10, I32 = 11, F32 = 12,
+    U64 = 13, I64 = 14, F64 = 15,
+};
+
+enum class DTypeKind : uint8_t {
+    Unsigned,
+    Signed,     // 2의 보수 정수
+    Float,      // 최상위 비트가 부호
+};
+
+struct DTypeKernels {
+    DType dtype;
+    const char* name;       // safetensors 헤더 표기
+    uint8_t width;          // 원소 바이트 수
+    DTypeKind kind;
+
+    // 바이트 자리별 평면으로 분할 / 병합 (평면 b = dst[b * count ...])
+    void (*split)(const char* src, size_t count, char* dst);
+    void (*merge)(const char* src, size_t count, char* dst);
+    // 부호를 최하위 비트로 옮긴 뒤 분할 (실수: 1비트 회전 -> 최상위 평면 = 지수, 정수: zigzag) / 역변환
+    void (*fold_split)(const char* src, size_t count, char* dst);
+    void (*merge_unfold)(const char* src, size_t count, char* dst);
+    // 이웃 원소 차분 (비트 패턴의 모듈러 뺄셈) / 누적합
+    void (*delta_encode)(const char* src, size_t count, char* dst);
+    void (*delta_decode)(const char* src, size_t count, char* dst);
+    // float 로 변환 (통계/추정용)
+    void (*to_float)(const char* src, size_t count, float* dst);
+};
+
+// dtype 문자열/번호 -> 커널 묶음 (모르는 dtype 이면 nullptr)
+const DTypeKernels* dtype_kernels(const std::string& dtype);
+const DTypeKernels* dtype_kernels(DType dtype);
+
+// 특수화 커널과 원소마다 dtype 을 분기하는 일반 구현의 처리량 비교 (단일 스레드)
+void handle_bench_transforms(size_t megabytes);
+
+#endif //DTYPE_KERNELS_H
@@ -0,0 +1,144 @@
+#include "file_util.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+std::FILE* file_open(const std::filesystem::path& path, const char* mode)
+{
+#ifdef _WIN32
+    // 유니코드 경로 대응
+    std::wstring wmode(mode, mode + std::char_traits<char>::length(mode));
+    return _wfopen(path.c_str(), wmode.c_str());
+#else
+    return std::fopen(path.c_str(), mode);
+#endif
+}
+
+bool file_seek(std::FILE* f, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(f, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(f, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+bool file_seek_end(std::FILE* f)
+{
+#ifdef _WIN32
+    return _fseeki64(f, 0, SEEK_END) == 0;
+#else
+    return fseeko(f, 0, SEEK_END) == 0;
+#endif
+}
+
+uint64_t file_tell(std::FILE* f)
+{
+#ifdef _WIN32
+    return static_cast<uint64_t>(_ftelli64(f));
+#else
+    return static_cast<uint64_t>(ftello(f));
+#endif
+}
+
+bool file_sync(std::FILE* f)
+{
+    if (std::fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+bool file_write_u64(std::FILE* f, uint64_t v)
+{
+    return std::fwrite(&v, sizeof(v), 1, f) == 1;
+}
+
+bool file_read_u64(std::FILE* f, uint64_t& v)
+{
+    return std::fread(&v, sizeof(v), 1, f) == 1;
+}
+
+bool file_read_at(std::FILE* f, uint64_t offset, void* dst, size_t size)
+{
+    if (!file_seek(f, offset)) return false;
+    return size == 0 || std::fread(dst, 1, size, f) == size;
+}
+
+bool map_file(const std::filesystem::path& path, MappedFile& mapped)
+{
+    mapped = MappedFile();
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    mapped.data = static_cast<const char*>(view);
+    mapped.size = static_cast<size_t>(size.QuadPart);
+    mapped.file_handle = file;
+    mapped.mapping_handle = mapping;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+    mapped.data = static_cast<const char*>(view);
+    mapped.size = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void unmap_file(MappedFile& mapped)
+{
+    if (!mapped.data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapped.data);
+    CloseHandle(static_cast<HANDLE>(mapped.mapping_handle));
+    CloseHandle(static_cast<HANDLE>(mapped.file_handle));
+#else
+    munmap(const_cast<char*>(mapped.data), mapped.size);
+#endif
+    mapped = MappedFile();
+}
+
+uint64_t fnv1a64(const void* data, size_t size, uint64_t seed)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = seed;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
@@ -0,0 +1,35 @@
+#ifndef FILE_UTIL_H
+#define FILE_UTIL_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+
+// FILE* 기반 입출력 헬퍼 (2GB 초과 오프셋, 디스크 동기화 지원)
+std::FILE* file_open(const std::filesystem::path& path, const char* mode);
+bool file_seek(std::FILE* f, uint64_t offset);
+bool file_seek_end(std::FILE* f);
+uint64_t file_tell(std::FILE* f);
+
+// OS 버퍼까지 디스크에 반영 (선점/전원 손실 대비)
+bool file_sync(std::FILE* f);
+
+bool file_write_u64(std::FILE* f, uint64_t v);
+bool file_read_u64(std::FILE* f, uint64_t& v);
+bool file_read_at(std::FILE* f, uint64_t offset, void* dst, size_t size);
+
+// 읽기 전용 메모리 매핑 (인덱스 등을 파싱 없이 바로 참조)
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+};
+bool map_file(const std::filesystem::path& path, MappedFile& mapped);
+void unmap_file(MappedFile& mapped);
+
+// FNV-1a 64비트 해시 (무결성 확인용, 암호학적 용도 아님)
+uint64_t fnv1a64(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ULL);
+
+#endif //FILE_UTIL_H
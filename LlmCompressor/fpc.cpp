@@ -0,0 +1,309 @@
+#include "fpc.h"
+#include "chunk_codec.h"
+#include "file_util.h"
+#include "safetensors.h"
+#include "parallel.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+template <typename T>
+void put(std::vector<char>& out, T v)
+{
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &v, sizeof(T));
+}
+
+template <typename T>
+bool get(const char*& p, const char* end, T& v)
+{
+    if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+// 해시에 넣을 상위 비트 (FCM 은 값의 상위 16비트, DFCM 은 차분의 상위 24비트)
+template <typename T> struct FpcShift;
+template <> struct FpcShift<uint32_t> { static constexpr int FCM = 16; static constexpr int DFCM = 8; };
+template <> struct FpcShift<uint64_t> { static constexpr int FCM = 48; static constexpr int DFCM = 40; };
+
+// 두 예측기의 상태. 인코더와 디코더가 같은 순서로 update 하므로 예측이 같음
+template <typename T>
+class FpcPredictor {
+public:
+    FpcPredictor() : fcm_(TABLE_SIZE, 0), dfcm_(TABLE_SIZE, 0) {}
+
+    T fcm() const { return fcm_[fcm_hash_]; }
+    T dfcm() const { return static_cast<T>(last_ + dfcm_[dfcm_hash_]); }
+
+    void update(T value)
+    {
+        fcm_[fcm_hash_] = value;
+        fcm_hash_ = ((fcm_hash_ << 6) ^ static_cast<size_t>(value >> FpcShift<T>::FCM)) & MASK;
+        const T delta = static_cast<T>(value - last_);
+        dfcm_[dfcm_hash_] = delta;
+        dfcm_hash_ = ((dfcm_hash_ << 2) ^ static_cast<size_t>(delta >> FpcShift<T>::DFCM)) & MASK;
+        last_ = value;
+    }
+
+private:
+    static constexpr size_t TABLE_SIZE = size_t(1) << FPC_TABLE_BITS;
+    static constexpr size_t MASK = TABLE_SIZE - 1;
+
+    std::vector<T> fcm_;
+    std::vector<T> dfcm_;
+    size_t fcm_hash_ = 0;
+    size_t dfcm_hash_ = 0;
+    T last_ = 0;
+};
+
+template <typename T>
+int leading_zero_bytes(T x)
+{
+    int n = 0;
+    for (int b = static_cast<int>(sizeof(T)) - 1; b >= 0 && ((x >> (b * 8)) & 0xFF) == 0; --b) ++n;
+    return n;
+}
+
+// 선행 0 바이트 수 <-> 3비트 코드 (fp64 는 4 가 드물어 3 으로 내려 기록하고 5~8 을 4~7 로)
+template <typename T>
+uint8_t zero_code(int& zeros)
+{
+    if (sizeof(T) == 8) {
+        if (zeros == 4) zeros = 3;
+        return static_cast<uint8_t>(zeros > 4 ? zeros - 1 : zeros);
+    }
+    return static_cast<uint8_t>(zeros);
+}
+
+template <typename T>
+int zeros_from_code(uint8_t code)
+{
+    return sizeof(T) == 8 && code >= 4 ? code + 1 : code;
+}
+
+template <typename T>
+void encode_block(const char* src, size_t count, std::vector<char>& out)
+{
+    FpcPredictor<T> predictor;
+    const size_t headers = (count + 1) / 2;
+    out.assign(headers + (count + 1) * sizeof(T), 0); // 잔차는 항상 sizeof(T) 를 쓰고 실제 길이만큼 전진
+    size_t pos = headers;
+    for (size_t i = 0; i < count; ++i) {
+        T value;
+        std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+        const T by_fcm = value ^ predictor.fcm();
+        const T by_dfcm = value ^ predictor.dfcm();
+        int zeros_fcm = leading_zero_bytes(by_fcm);
+        int zeros_dfcm = leading_zero_bytes(by_dfcm);
+        const bool dfcm = zeros_dfcm > zeros_fcm;
+        const T residual = dfcm ? by_dfcm : by_fcm;
+        int zeros = dfcm ? zeros_dfcm : zeros_fcm;
+        const uint8_t code = zero_code<T>(zeros);
+        out[i / 2] |= static_cast<char>(((dfcm ? 8 : 0) | code) << ((i & 1) * 4));
+        std::memcpy(out.data() + pos, &residual, sizeof(T));
+        pos += sizeof(T) - static_cast<size_t>(zeros);
+        predictor.update(value);
+    }
+    out.resize(pos);
+}
+
+template <typename T>
+bool decode_block(const char* src, size_t size, size_t count, char* dst)
+{
+    FpcPredictor<T> predictor;
+    const size_t headers = (count + 1) / 2;
+    if (size < headers) return false;
+    size_t pos = headers;
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t nibble = static_cast<uint8_t>(static_cast<uint8_t>(src[i / 2]) >> ((i & 1) * 4)) & 0xF;
+        const int zeros = zeros_from_code<T>(nibble & 7);
+        if (zeros > static_cast<int>(sizeof(T))) return false;
+        const size_t n = sizeof(T) - static_cast<size_t>(zeros);
+        if (pos + n > size) return false;
+        T residual = 0;
+        std::memcpy(&residual, src + pos, n); // 리틀 엔디안: 하위 바이트부터
+        pos += n;
+        const T value = residual ^ ((nibble & 8) ? predictor.dfcm() : predictor.fcm());
+        std::memcpy(dst + i * sizeof(T), &value, sizeof(T));
+        predictor.update(value);
+    }
+    return pos == size;
+}
+
+} // namespace
+
+bool fpc_compress_chunk(const char* src, size_t size, uint8_t width, std::vector<char>& out, size_t threads)
+{
+    if (width != 4 && width != 8) {
+        std::cerr << "Error: FPC needs 4 or 8 byte elements (got " << static_cast<int>(width) << ")." << std::endl;
+        return false;
+    }
+    const size_t count = size / width;
+    const size_t num_blocks = (count + FPC_BLOCK_VALUES - 1) / FPC_BLOCK_VALUES;
+    std::vector<std::vector<char>> blocks(num_blocks);
+    parallel_for(num_blocks, threads, [&](size_t b) {
+        const size_t first = b * FPC_BLOCK_VALUES;
+        const size_t n = std::min<size_t>(FPC_BLOCK_VALUES, count - first);
+        if (width == 4) encode_block<uint32_t>(src + first * 4, n, blocks[b]);
+        else encode_block<uint64_t>(src + first * 8, n, blocks[b]);
+    });
+
+    out.clear();
+    put<uint8_t>(out, width);
+    put<uint32_t>(out, static_cast<uint32_t>(num_blocks));
+    for (const auto& block : blocks) put<uint32_t>(out, static_cast<uint32_t>(block.size()));
+    for (const auto& block : blocks) out.insert(out.end(), block.begin(), block.end());
+    out.insert(out.end(), src + count * width, src + size);
+    return true;
+}
+
+bool fpc_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size, size_t threads)
+{
+    const char* p = src;
+    const char* end = src + compressed_size;
+    uint8_t width = 0;
+    uint32_t num_blocks = 0;
+    bool ok = get(p, end, width) && (width == 4 || width == 8) && get(p, end, num_blocks);
+    const size_t count = ok ? original_size / width : 0;
+    ok = ok && num_blocks == (count + FPC_BLOCK_VALUES - 1) / FPC_BLOCK_VALUES &&
+         static_cast<size_t>(end - p) / sizeof(uint32_t) >= num_blocks;
+    // 블록 시작 위치 (크기 표 누적)
+    std::vector<size_t> block_start(ok ? num_blocks + 1 : 0, 0);
+    if (ok) {
+        const size_t base = static_cast<size_t>(p - src) + num_blocks * sizeof(uint32_t);
+        block_start[0] = base;
+        for (uint32_t b = 0; b < num_blocks && ok; ++b) {
+            uint32_t block_size = 0;
+            ok = get(p, end, block_size);
+            block_start[b + 1] = block_start[b] + block_size;
+        }
+        ok = ok && block_start[num_blocks] + (original_size - count * width) == compressed_size;
+    }
+    if (!ok) {
+        std::cerr << "Error: FPC chunk is corrupted." << std::endl;
+        return false;
+    }
+
+    std::atomic<bool> failed{ false };
+    parallel_for(num_blocks, threads, [&](size_t b) {
+        const size_t first = b * FPC_BLOCK_VALUES;
+        const size_t n = std::min<size_t>(FPC_BLOCK_VALUES, count - first);
+        const char* block = src + block_start[b];
+        const size_t block_size = block_start[b + 1] - block_start[b];
+        const bool r = width == 4 ? decode_block<uint32_t>(block, block_size, n, dst + first * 4)
+                                  : decode_block<uint64_t>(block, block_size, n, dst + first * 8);
+        if (!r) failed = true;
+    });
+    if (failed) {
+        std::cerr << "Error: FPC chunk is corrupted." << std::endl;
+        return false;
+    }
+    std::memcpy(dst + count * width, src + block_start[num_blocks], original_size - count * width);
+    return true;
+}
+
+void handle_bench_fpc(const fs::path& input_path, size_t megabytes)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "FPC benchmark (" << FPC_BLOCK_VALUES << "-value independent blocks)" << std::endl;
+    const size_t limit = std::max<size_t>(megabytes, 1) * 1024 * 1024;
+
+    // 표본: F32 (없으면 F64) 텐서를 이어 붙인 것, 아니면 합성 fp32 (위치 코사인 + 느린 EMA 를 이어 붙인 모양)
+    std::vector<char> sample;
+    uint8_t width = 4;
+    if (!input_path.empty()) {
+        std::FILE* in = file_open(input_path, "rb");
+        if (!in) {
+            std::cerr << "Error: Cannot open file " << input_path.string() << std::endl;
+            return;
+        }
+        const uint64_t file_size = fs::file_size(input_path);
+        std::string json_header;
+        uint64_t data_offset = 0;
+        std::vector<TensorInfo> tensors;
+        if (!read_safetensors_header(in, file_size, json_header, data_offset) ||
+            !parse_safetensors_header(json_header, tensors)) {
+            std::fclose(in);
+            return;
+        }
+        bool any_f32 = false;
+        for (const auto& t : tensors) any_f32 = any_f32 || t.dtype == "F32";
+        const std::string wanted = any_f32 ? "F32" : "F64";
+        width = any_f32 ? 4 : 8;
+        bool ok = true;
+        for (const auto& t : tensors) {
+            if (t.dtype != wanted || sample.size() >= limit || t.data_end + data_offset > file_size) continue;
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(t.data_end - t.data_begin, limit - sample.size()));
+            const size_t at = sample.size();
+            sample.resize(at + n / width * width);
+            ok = ok && file_read_at(in, data_offset + t.data_begin, sample.data() + at, sample.size() - at);
+        }
+        std::fclose(in);
+        if (!ok || sample.empty()) {
+            std::cerr << "Error: No F32/F64 tensor data in " << input_path.string() << std::endl;
+            return;
+        }
+    }
+    else {
+        std::mt19937 rng(1234);
+        std::normal_distribution<float> noise(0.0f, 1.0f);
+        const size_t count = limit / 4;
+        sample.resize(count * 4);
+        float ema = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            float v;
+            if (i < count / 2) {
+                v = std::cos(static_cast<float>(i % 4096) / std::pow(10000.0f, static_cast<float>(i / 4096 % 64) / 64.0f));
+            } else {
+                ema = 0.999f * ema + 0.001f * noise(rng) * noise(rng);
+                v = ema;
+            }
+            std::memcpy(&sample[i * 4], &v, 4);
+        }
+    }
+
+    const size_t threads = default_thread_count();
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::vector<char> comp;
+    fpc_compress_chunk(sample.data(), sample.size(), width, comp, threads);
+    const double encode_sec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+    std::vector<char> lz4, lzma;
+    lz4_compress_chunk(sample.data(), sample.size(), 9, lz4);
+    lzma_compress_chunk(sample.data(), sample.size(), 6, width, lzma);
+    auto percent = [&](size_t n) { return 100.0 * static_cast<double>(n) / static_cast<double>(sample.size()); };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Sample: " << sample.size() << " bytes of fp" << width * 8 << std::endl;
+    std::cout << "  FPC     " << std::setw(12) << comp.size() << " bytes (" << percent(comp.size()) << "%), encode "
+              << static_cast<double>(sample.size()) / encode_sec / 1e9 << " GB/s with " << threads << " thread(s)" << std::endl;
+    std::cout << "  LZ4-HC  " << std::setw(12) << lz4.size() << " bytes (" << percent(lz4.size()) << "%)" << std::endl;
+    std::cout << "  LZMA -6 " << std::setw(12) << lzma.size() << " bytes (" << percent(lzma.size()) << "%)" << std::endl;
+
+    std::vector<char> decoded(sample.size());
+    for (size_t n : { size_t(1), threads }) {
+        double best = 1e30, total = 0;
+        bool ok = true;
+        for (int iter = 0; ok && (iter < 3 || total < 1.0); ++iter) {
+            auto t = std::chrono::high_resolution_clock::now();
+            ok = fpc_decompress_chunk(comp.data(), comp.size(), decoded.data(), decoded.size(), n);
+            const double sec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t).count();
+            best = std::min(best, sec);
+            total += sec;
+        }
+        std::cout << "  decode " << std::setw(3) << n << " thread(s) " << std::setw(8)
+                  << static_cast<double>(sample.size()) / best / 1e9 << " GB/s"
+                  << (ok && decoded == sample ? "  (round trip OK)" : "  MISMATCH") << std::endl;
+        if (threads == 1) break;
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef FPC_H
+#define FPC_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// FPC 예측 부동소수 코더 (ChunkCodec::Fpc)
+// fp32/fp64 옵티마이저 상태, EMA, 위치 버퍼처럼 이웃 값이 이어지는 텐서는 바이트 단위 LZ 가 상관을 보지 못함.
+// 값마다 두 예측기 (FCM: 최근 값 이력 해시 -> 다음 값, DFCM: 최근 차분 이력 해시 -> 다음 차분) 중 맞은 쪽과 XOR 하고
+// 잔차의 선행 0 바이트 수와 나머지 바이트만 기록 (Burtscher & Ratanaworabhan).
+// 블록마다 예측 표를 새로 시작하므로 블록들은 서로 독립이고 해제/압축을 스레드 여러 개로 나눠 돌릴 수 있음.
+//
+// 청크 = [u8 원소 크기 (4|8)][u32 블록 수][u32 x 블록 수 블록 압축 크기][블록...][원소 크기로 나눈 나머지 바이트 원본]
+// 블록 = FPC_BLOCK_VALUES 개 값 (마지막 블록은 나머지). [값 2개당 헤더 1바이트][잔차 바이트...]
+// 헤더 니블 = 예측기 (0 FCM, 1 DFCM) << 3 | 선행 0 바이트 코드 (fp64 는 0~8 중 4 를 3 으로 내려 3비트에 맞춤)
+constexpr uint32_t FPC_BLOCK_VALUES = 1u << 16;
+constexpr uint32_t FPC_TABLE_BITS = 16;          // 예측 표 2^16 항목 (fp64 는 블록당 1MB)
+
+// size 바이트를 width (4|8) 바이트 원소로 보고 인코딩. threads 개 스레드로 블록을 나눠 처리
+bool fpc_compress_chunk(const char* src, size_t size, uint8_t width, std::vector<char>& out, size_t threads = 1);
+bool fpc_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size, size_t threads = 1);
+
+// 압축률(LZ4-HC/LZMA 대비)과 1 스레드/전체 코어 해제 속도 출력
+// input_path 가 비어 있으면 EMA 모양의 합성 fp32 데이터, 아니면 F32/F64 텐서만 모아 씀
+void handle_bench_fpc(const std::filesystem::path& input_path, size_t megabytes);
+
+#endif //FPC_H
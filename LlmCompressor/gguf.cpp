@@ -0,0 +1,496 @@
+#include "gguf.h"
+#include "chunk_codec.h"
+#include "rans.h"
+#include "file_util.h"
+#include "scratch_pool.h"
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <lz4hc.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// ggml 형 표 (ggml-common.h 의 block_* 구조체 필드 순서)
+constexpr GgufType GGUF_TYPES[] = {
+    { 0, "F32", 1, 4, 0, {} },
+    { 1, "F16", 1, 2, 0, {} },
+    { 2, "Q4_0", 32, 18, 2, { { 2, 2 }, { 16, 1 } } },
+    { 3, "Q4_1", 32, 20, 3, { { 2, 2 }, { 2, 2 }, { 16, 1 } } },
+    { 6, "Q5_0", 32, 22, 3, { { 2, 2 }, { 4, 1 }, { 16, 1 } } },
+    { 7, "Q5_1", 32, 24, 4, { { 2, 2 }, { 2, 2 }, { 4, 1 }, { 16, 1 } } },
+    { 8, "Q8_0", 32, 34, 2, { { 2, 2 }, { 32, 1 } } },
+    { 9, "Q8_1", 32, 36, 3, { { 2, 2 }, { 2, 2 }, { 32, 1 } } },
+    { 10, "Q2_K", 256, 84, 4, { { 16, 1 }, { 64, 1 }, { 2, 2 }, { 2, 2 } } },
+    { 11, "Q3_K", 256, 110, 4, { { 32, 1 }, { 64, 1 }, { 12, 1 }, { 2, 2 } } },
+    { 12, "Q4_K", 256, 144, 4, { { 2, 2 }, { 2, 2 }, { 12, 1 }, { 128, 1 } } },
+    { 13, "Q5_K", 256, 176, 5, { { 2, 2 }, { 2, 2 }, { 12, 1 }, { 32, 1 }, { 128, 1 } } },
+    { 14, "Q6_K", 256, 210, 4, { { 128, 1 }, { 64, 1 }, { 16, 1 }, { 2, 2 } } },
+    { 15, "Q8_K", 256, 292, 3, { { 4, 4 }, { 256, 1 }, { 32, 2 } } },
+    { 16, "IQ2_XXS", 256, 66, 2, { { 2, 2 }, { 64, 1 } } },
+    { 17, "IQ2_XS", 256, 74, 3, { { 2, 2 }, { 64, 1 }, { 8, 1 } } },
+    { 18, "IQ3_XXS", 256, 98, 2, { { 2, 2 }, { 96, 1 } } },
+    { 19, "IQ1_S", 256, 50, 3, { { 2, 2 }, { 32, 1 }, { 16, 2 } } },
+    { 20, "IQ4_NL", 32, 18, 2, { { 2, 2 }, { 16, 1 } } },
+    { 21, "IQ3_S", 256, 110, 5, { { 2, 2 }, { 64, 1 }, { 8, 1 }, { 32, 1 }, { 4, 1 } } },
+    { 22, "IQ2_S", 256, 82, 4, { { 2, 2 }, { 64, 1 }, { 8, 1 }, { 8, 1 } } },
+    { 23, "IQ4_XS", 256, 136, 4, { { 2, 2 }, { 2, 2 }, { 4, 1 }, { 128, 1 } } },
+    { 24, "I8", 1, 1, 0, {} },
+    { 25, "I16", 1, 2, 0, {} },
+    { 26, "I32", 1, 4, 0, {} },
+    { 27, "I64", 1, 8, 0, {} },
+    { 28, "F64", 1, 8, 0, {} },
+    { 29, "IQ1_M", 256, 56, 3, { { 32, 1 }, { 16, 1 }, { 8, 2 } } },
+    { 30, "BF16", 1, 2, 0, {} },
+    { 34, "TQ1_0", 256, 54, 3, { { 48, 1 }, { 4, 1 }, { 2, 2 } } },
+    { 35, "TQ2_0", 256, 66, 2, { { 64, 1 }, { 2, 2 } } },
+};
+
+// GGUF KV 값 형
+enum GgufValueType : uint32_t {
+    GGUF_U8 = 0, GGUF_I8, GGUF_U16, GGUF_I16, GGUF_U32, GGUF_I32, GGUF_F32, GGUF_BOOL,
+    GGUF_STRING, GGUF_ARRAY, GGUF_U64, GGUF_I64, GGUF_F64,
+};
+
+constexpr uint32_t GGUF_MAX_DIMS = 8;
+
+template <typename T>
+void put(std::vector<char>& out, T v)
+{
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &v, sizeof(T));
+}
+
+template <typename T>
+bool get(const char*& p, const char* end, T& v)
+{
+    if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+// 헤더 읽기 커서. 끝을 넘으면 truncated 를 세움 (잘못된 값과 구분해 더 읽고 다시 시도)
+struct Cursor {
+    const char* p;
+    const char* end;
+    bool truncated = false;
+
+    template <typename T>
+    bool read(T& v)
+    {
+        if (get(p, end, v)) return true;
+        truncated = true;
+        return false;
+    }
+
+    bool skip(uint64_t n)
+    {
+        if (static_cast<uint64_t>(end - p) < n) {
+            truncated = true;
+            return false;
+        }
+        p += n;
+        return true;
+    }
+
+    bool string(std::string* out)
+    {
+        uint64_t n = 0;
+        if (!read(n)) return false;
+        if (n > (1ULL << 32)) return false;
+        const char* at = p;
+        if (!skip(n)) return false;
+        if (out) out->assign(at, static_cast<size_t>(n));
+        return true;
+    }
+};
+
+size_t scalar_size(uint32_t type)
+{
+    switch (type) {
+    case GGUF_U8: case GGUF_I8: case GGUF_BOOL: return 1;
+    case GGUF_U16: case GGUF_I16: return 2;
+    case GGUF_U32: case GGUF_I32: case GGUF_F32: return 4;
+    case GGUF_U64: case GGUF_I64: case GGUF_F64: return 8;
+    default: return 0;
+    }
+}
+
+// KV 값 하나 건너뜀 (정수면 value 에 읽음, general.alignment 용)
+bool skip_value(Cursor& c, uint32_t type, uint64_t* value, int depth = 0)
+{
+    if (type == GGUF_STRING) return c.string(nullptr);
+    if (type == GGUF_ARRAY) {
+        uint32_t item = 0;
+        uint64_t count = 0;
+        if (depth > 4 || !c.read(item) || !c.read(count)) return false;
+        const size_t width = scalar_size(item);
+        if (width > 0) return count <= UINT64_MAX / width && c.skip(count * width);
+        for (uint64_t i = 0; i < count; ++i) {
+            if (!skip_value(c, item, nullptr, depth + 1)) return false;
+        }
+        return true;
+    }
+    const size_t width = scalar_size(type);
+    if (width == 0) return false;
+    uint64_t v = 0;
+    const char* at = c.p;
+    if (!c.skip(width)) return false;
+    std::memcpy(&v, at, width);
+    if (value) *value = v;
+    return true;
+}
+
+// 헤더를 GGUF_HEADER_PROBE 부터 두 배씩 읽어 파싱 (read(offset, size, out))
+bool probe_gguf_header(uint64_t file_size, const std::function<bool(uint64_t, size_t, std::vector<char>&)>& read,
+                       GgufHeader& header, std::vector<char>* bytes = nullptr)
+{
+    std::vector<char> buf;
+    size_t probe = static_cast<size_t>(std::min<uint64_t>(GGUF_HEADER_PROBE, file_size));
+    for (;;) {
+        if (!read(0, probe, buf)) return false;
+        bool truncated = false;
+        if (parse_gguf_header(buf.data(), buf.size(), file_size, header, truncated)) {
+            if (bytes) *bytes = std::move(buf);
+            return true;
+        }
+        if (!truncated || probe == file_size) {
+            std::cerr << "Error: Not a valid GGUF file (bad header)." << std::endl;
+            return false;
+        }
+        probe = static_cast<size_t>(std::min<uint64_t>(static_cast<uint64_t>(probe) * 2, file_size));
+    }
+}
+
+// 배치 순서대로 필드 평면마다 f(필드의 블록 내 오프셋, 필드 원소 수, 원소 크기, 바이트 자리) 호출
+template <typename F>
+void for_each_plane(const GgufType& t, F&& f)
+{
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < t.field_count; ++i) {
+        const GgufField& field = t.fields[i];
+        for (uint32_t b = 0; b < field.width; ++b) f(offset, field.bytes / field.width, field.width, b);
+        offset += field.bytes;
+    }
+}
+
+} // namespace
+
+const GgufType* gguf_type(uint32_t id)
+{
+    for (const auto& t : GGUF_TYPES) {
+        if (t.id == id) return &t;
+    }
+    return nullptr;
+}
+
+bool is_gguf_file(std::FILE* f)
+{
+    char magic[4];
+    return file_read_at(f, 0, magic, sizeof(magic)) && std::memcmp(magic, GGUF_MAGIC, sizeof(magic)) == 0;
+}
+
+bool parse_gguf_header(const char* data, size_t size, uint64_t file_size, GgufHeader& header, bool& truncated)
+{
+    header = GgufHeader();
+    Cursor c{ data, data + size };
+    char magic[4];
+    uint64_t tensor_count = 0;
+    bool ok = c.read(magic) && std::memcmp(magic, GGUF_MAGIC, sizeof(magic)) == 0 && c.read(header.version) &&
+              (header.version == 2 || header.version == 3) && c.read(tensor_count) && c.read(header.kv_count);
+    header.kv_begin = static_cast<uint64_t>(c.p - data);
+
+    // KV: general.alignment 만 해석하고 나머지는 원문 그대로 (헤더 청크에 보존)
+    for (uint64_t i = 0; ok && i < header.kv_count; ++i) {
+        std::string key;
+        uint32_t type = 0;
+        uint64_t value = 0;
+        ok = c.string(&key) && c.read(type) && skip_value(c, type, &value);
+        if (ok && key == "general.alignment") {
+            ok = (type <= GGUF_I32 || type == GGUF_U64 || type == GGUF_I64) && value > 0 && (value & (value - 1)) == 0;
+            header.alignment = value;
+        }
+    }
+    header.kv_end = static_cast<uint64_t>(c.p - data);
+
+    // 텐서 정보
+    std::vector<uint64_t> offsets;
+    for (uint64_t i = 0; ok && i < tensor_count; ++i) {
+        TensorInfo t;
+        uint32_t dims = 0, type = 0;
+        uint64_t offset = 0;
+        ok = c.string(&t.name) && c.read(dims) && dims <= GGUF_MAX_DIMS;
+        t.shape.resize(ok ? dims : 0);
+        for (uint32_t d = 0; ok && d < dims; ++d) ok = c.read(t.shape[dims - 1 - d]); // ne0 = 행 길이 -> 마지막 축
+        ok = ok && c.read(type) && c.read(offset) && offset % header.alignment == 0;
+        if (!ok) break;
+        const GgufType* gt = gguf_type(type);
+        t.dtype = gt ? gt->name : "GGML_" + std::to_string(type);
+        t.data_begin = offset;
+        header.tensors.push_back(std::move(t));
+        header.types.push_back(type);
+        offsets.push_back(offset);
+    }
+    truncated = c.truncated;
+    if (!ok) return false;
+    const uint64_t end = static_cast<uint64_t>(c.p - data);
+    header.data_offset = (end + header.alignment - 1) / header.alignment * header.alignment;
+    if (header.data_offset > file_size) return false;
+    const uint64_t data_size = file_size - header.data_offset;
+
+    // 텐서 크기: 원소 수 / 블록 원소 수 x 블록 바이트. 모르는 형은 다음 텐서 시작까지
+    std::sort(offsets.begin(), offsets.end());
+    for (size_t i = 0; i < header.tensors.size(); ++i) {
+        TensorInfo& t = header.tensors[i];
+        const GgufType* gt = gguf_type(header.types[i]);
+        uint64_t elements = 1;
+        for (uint64_t d : t.shape) elements *= d;
+        if (gt && elements % gt->block_elements == 0) {
+            t.data_end = t.data_begin + elements / gt->block_elements * gt->block_bytes;
+        } else {
+            auto next = std::upper_bound(offsets.begin(), offsets.end(), t.data_begin);
+            t.data_end = next == offsets.end() ? data_size : *next;
+        }
+        if (t.data_end > data_size) return false;
+    }
+    return true;
+}
+
+bool read_gguf_header(std::FILE* in, uint64_t file_size, GgufHeader& header)
+{
+    return probe_gguf_header(file_size, [&](uint64_t offset, size_t size, std::vector<char>& out) {
+        out.resize(size);
+        if (file_read_at(in, offset, out.data(), size)) return true;
+        std::cerr << "Error: Cannot read GGUF header." << std::endl;
+        return false;
+    }, header);
+}
+
+std::vector<PlannedChunk> plan_gguf_chunks(const GgufHeader& header, const std::vector<TensorSpan>& spans, size_t chunk_size)
+{
+    // 블록 분할할 양자화 텐서 (데이터 시작 -> 텐서 번호)
+    std::map<uint64_t, size_t> quant;
+    for (size_t i = 0; i < header.tensors.size(); ++i) {
+        const GgufType* t = gguf_type(header.types[i]);
+        if (t && t->field_count > 0 && header.tensors[i].data_end > header.tensors[i].data_begin) {
+            quant[header.tensors[i].data_begin] = i;
+        }
+    }
+
+    std::vector<PlannedChunk> plan;
+    std::vector<TensorSpan> rest;
+    for (const auto& s : spans) {
+        auto it = quant.find(s.offset);
+        const TensorInfo* t = it == quant.end() ? nullptr : &header.tensors[it->second];
+        if (!t || t->data_end - t->data_begin != s.length) {
+            rest.push_back(s);
+            continue;
+        }
+        const GgufType* gt = gguf_type(header.types[it->second]);
+        const uint64_t step = std::max<uint64_t>(chunk_size / gt->block_bytes, 1) * gt->block_bytes;
+        for (uint64_t done = 0; done < s.length;) {
+            const uint64_t n = std::min<uint64_t>(s.length - done, step);
+            PlannedChunk c;
+            c.ranges.push_back({ s.offset + done, n });
+            c.quant = gt->id;
+            c.rule = s.rule;
+            plan.push_back(std::move(c));
+            done += n;
+        }
+    }
+    for (auto& c : plan_solid_chunks(rest, chunk_size)) plan.push_back(std::move(c));
+    return plan;
+}
+
+bool quant_split(const char* src, size_t size, uint32_t type, char* dst)
+{
+    const GgufType* t = gguf_type(type);
+    if (!t || t->field_count == 0) return false;
+    const size_t blocks = size / t->block_bytes;
+    char* out = dst;
+    for_each_plane(*t, [&](uint32_t offset, uint32_t count, uint32_t width, uint32_t byte) {
+        for (size_t b = 0; b < blocks; ++b) {
+            const char* block = src + b * t->block_bytes + offset + byte;
+            if (width == 1) {
+                std::memcpy(out, block, count);
+                out += count;
+                continue;
+            }
+            for (uint32_t e = 0; e < count; ++e) *out++ = block[e * width];
+        }
+    });
+    std::memcpy(out, src + blocks * t->block_bytes, size - blocks * t->block_bytes);
+    return true;
+}
+
+bool quant_merge(const char* src, size_t size, uint32_t type, char* dst)
+{
+    const GgufType* t = gguf_type(type);
+    if (!t || t->field_count == 0) return false;
+    const size_t blocks = size / t->block_bytes;
+    const char* in = src;
+    for_each_plane(*t, [&](uint32_t offset, uint32_t count, uint32_t width, uint32_t byte) {
+        for (size_t b = 0; b < blocks; ++b) {
+            char* block = dst + b * t->block_bytes + offset + byte;
+            if (width == 1) {
+                std::memcpy(block, in, count);
+                in += count;
+                continue;
+            }
+            for (uint32_t e = 0; e < count; ++e) block[e * width] = *in++;
+        }
+    });
+    std::memcpy(dst + blocks * t->block_bytes, in, size - blocks * t->block_bytes);
+    return true;
+}
+
+bool encode_quant_chunk(ChunkCodec codec, const char* data, size_t size, int level, uint32_t type,
+                        ArchiveChunk& meta, std::vector<char>& out)
+{
+    const GgufType* t = gguf_type(type);
+    const size_t blocks = t ? size / t->block_bytes : 0;
+    if (!t || t->field_count == 0 || blocks == 0 || codec == ChunkCodec::Fpc) {
+        return encode_cpu_chunk(codec, data, size, level, DType::Unknown, false, meta, out);
+    }
+    ScratchPool::Lease buffer = scratch_pool().acquire(size);
+    quant_split(data, size, type, buffer.data());
+    meta.original_size = size;
+    bool ok = false;
+    if (codec == ChunkCodec::Rans) {
+        // 필드 평면마다 스트림 하나 (나머지 바이트는 마지막 스트림에)
+        std::vector<size_t> lengths;
+        for_each_plane(*t, [&](uint32_t, uint32_t count, uint32_t, uint32_t) { lengths.push_back(blocks * count); });
+        lengths.back() += size - blocks * t->block_bytes;
+        ok = rans_compress_streams(buffer.data(), lengths, out);
+    }
+    else if (codec == ChunkCodec::Lzma) ok = lzma_compress_chunk(buffer.data(), size, level, 0, out);
+    else if (codec == ChunkCodec::Zstd) ok = zstd_compress_chunk(buffer.data(), size, level, out);
+    else ok = lz4_compress_chunk(buffer.data(), size, level, out);
+    if (!ok) return false;
+    if (out.size() >= size) {
+        out.assign(data, data + size);
+        meta.codec = static_cast<uint8_t>(ChunkCodec::Stored);
+        meta.level = 0;
+        meta.transform = static_cast<uint8_t>(ChunkTransform::None);
+        meta.transform_param = 0;
+        meta.aux = 0;
+        return true;
+    }
+    meta.codec = static_cast<uint8_t>(codec);
+    meta.level = static_cast<int8_t>(clamp_codec_level(codec, level));
+    meta.transform = static_cast<uint8_t>(ChunkTransform::QuantSplit);
+    meta.transform_param = static_cast<uint8_t>(type);
+    meta.aux = 0;
+    return true;
+}
+
+bool is_gguf_archive(const fs::path& archive_path)
+{
+    if (!is_v2_archive(archive_path)) return false;
+    std::FILE* f = file_open(archive_path, "rb");
+    if (!f) return false;
+    ArchiveIndex index;
+    std::vector<char> magic;
+    const bool ok = read_archive_index(f, index) && !index.files.empty() && index.files[0].size >= sizeof(GGUF_MAGIC) &&
+                    read_archive_file_range(f, index, index.files[0], 0, sizeof(GGUF_MAGIC), magic) &&
+                    std::memcmp(magic.data(), GGUF_MAGIC, sizeof(GGUF_MAGIC)) == 0;
+    std::fclose(f);
+    return ok;
+}
+
+void handle_extract_gguf(const fs::path& archive_path, const fs::path& output_path, const std::vector<std::string>& names)
+{
+    std::cout << "----------------------------------------------------" << std::endl;
+    std::cout << "Extracting " << names.size() << " tensors from " << archive_path.string()
+              << "\n-> to ->    " << output_path.string() << " (GGUF)" << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::FILE* f = file_open(archive_path, "rb");
+    if (!f) {
+        std::cerr << "Error: Cannot open input file " << archive_path.string() << std::endl;
+        return;
+    }
+    ArchiveIndex index;
+    if (!read_archive_index(f, index) || index.files.empty()) {
+        std::cerr << "Error: Cannot read the archive index." << std::endl;
+        std::fclose(f);
+        return;
+    }
+    const ArchiveFile& file = index.files[0];
+
+    // 1. 헤더 청크에서 GGUF 헤더 (KV 원문은 그대로 옮김)
+    GgufHeader header;
+    std::vector<char> header_bytes;
+    bool ok = probe_gguf_header(file.size, [&](uint64_t offset, size_t size, std::vector<char>& out) {
+        return read_archive_file_range(f, index, file, offset, size, out);
+    }, header, &header_bytes);
+
+    // 2. 지정한 텐서와 새 데이터 오프셋 (정렬 유지)
+    std::vector<size_t> selected;
+    std::vector<uint64_t> new_offsets;
+    uint64_t data_size = 0;
+    for (const auto& name : names) {
+        if (!ok) break;
+        auto it = std::find_if(header.tensors.begin(), header.tensors.end(),
+                               [&](const TensorInfo& t) { return t.name == name; });
+        if (it == header.tensors.end()) {
+            std::cerr << "Error: Tensor not found: " << name << std::endl;
+            ok = false;
+            break;
+        }
+        selected.push_back(static_cast<size_t>(it - header.tensors.begin()));
+        data_size = (data_size + header.alignment - 1) / header.alignment * header.alignment;
+        new_offsets.push_back(data_size);
+        data_size += it->data_end - it->data_begin;
+    }
+
+    // 3. [매직, 버전, 텐서 수, KV 수][KV 원문][텐서 정보][정렬][텐서 데이터 (텐서가 걸친 청크만 해제)]
+    std::vector<char> head(GGUF_MAGIC, GGUF_MAGIC + sizeof(GGUF_MAGIC));
+    put<uint32_t>(head, header.version);
+    put<uint64_t>(head, selected.size());
+    put<uint64_t>(head, header.kv_count);
+    if (ok) head.insert(head.end(), header_bytes.begin() + header.kv_begin, header_bytes.begin() + header.kv_end);
+    for (size_t k = 0; k < selected.size(); ++k) {
+        const TensorInfo& t = header.tensors[selected[k]];
+        put<uint64_t>(head, t.name.size());
+        head.insert(head.end(), t.name.begin(), t.name.end());
+        put<uint32_t>(head, static_cast<uint32_t>(t.shape.size()));
+        for (size_t d = t.shape.size(); d-- > 0;) put<uint64_t>(head, t.shape[d]);
+        put<uint32_t>(head, header.types[selected[k]]);
+        put<uint64_t>(head, new_offsets[k]);
+    }
+    head.resize((head.size() + header.alignment - 1) / header.alignment * header.alignment, 0);
+
+    std::FILE* out = ok ? file_open(output_path, "wb") : nullptr;
+    ok = out && std::fwrite(head.data(), 1, head.size(), out) == head.size();
+    std::vector<char> data;
+    uint64_t written = 0;
+    for (size_t k = 0; ok && k < selected.size(); ++k) {
+        const TensorInfo& t = header.tensors[selected[k]];
+        const std::vector<char> pad(static_cast<size_t>(new_offsets[k] - written), 0);
+        ok = std::fwrite(pad.data(), 1, pad.size(), out) == pad.size() &&
+             read_archive_file_range(f, index, file, header.data_offset + t.data_begin, t.data_end - t.data_begin, data) &&
+             std::fwrite(data.data(), 1, data.size(), out) == data.size();
+        written = new_offsets[k] + data.size();
+    }
+    std::fclose(f);
+    if (out) ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::error_code ec;
+        if (out) fs::remove(output_path, ec);
+        std::cerr << "Extraction failed." << std::endl;
+        return;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Extracted " << selected.size() << " tensors (" << data_size << " bytes of " << header.tensors.size()
+              << " tensors' data)." << std::endl;
+    std::cout << "Extraction successful! Took " << diff.count() << " seconds." << std::endl;
+}
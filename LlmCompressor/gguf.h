@@ -0,0 +1,89 @@
+#ifndef GGUF_H
+#define GGUF_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "archive.h"
+#include "chunking.h"
+#include "safetensors.h"
+
+// GGUF (llama.cpp) 입력
+// [4B "GGUF"][u32 버전 (2|3)][u64 텐서 수][u64 KV 수][KV...][텐서 정보...][general.alignment 정렬][텐서 데이터]
+// KV = [문자열 키][u32 값 형][값], 텐서 정보 = [문자열 이름][u32 차원 수][u64 x 차원 수 (ne0 부터)][u32 ggml 형][u64 오프셋]
+// 문자열 = [u64 길이][바이트]. 헤더 전체(KV + 텐서 정보 + 정렬 빈틈)는 청크 0 으로 그대로 압축하므로 해제는 바이트 단위로 같음.
+//
+// 양자화 블록 분할 (ChunkTransform::QuantSplit, transform_param = ggml 형)
+// Q4_K 같은 블록은 [f16 스케일/최솟값][6비트 부분 스케일][4비트 양자 값] 이 블록마다 번갈아 나와 LZ 창과 order-0 통계가
+// 섞임. 블록의 필드마다 모든 블록의 같은 필드를 모으고, 여러 바이트 필드(f16 스케일, i16 부분합)는 바이트 평면으로 나눠
+// [필드 0 평면들][필드 1 평면들]...[블록 크기로 나눈 나머지 바이트] 순으로 배치. rANS 는 필드 평면마다 스트림 하나.
+constexpr char GGUF_MAGIC[4] = { 'G', 'G', 'U', 'F' };
+constexpr uint32_t GGUF_DEFAULT_ALIGNMENT = 32;
+constexpr uint32_t GGUF_MAX_FIELDS = 6;
+constexpr size_t GGUF_HEADER_PROBE = 1024ULL * 1024ULL; // 헤더를 이 크기부터 두 배씩 읽어 파싱
+
+// 블록 필드 하나: bytes 바이트를 width 바이트 원소로 보고 바이트 평면 분할 (1 이면 분할 없음)
+struct GgufField {
+    uint16_t bytes;
+    uint8_t width;
+};
+
+// ggml 형. block_elements 원소가 block_bytes 바이트 블록 하나 (실수/정수 형은 원소 하나가 블록)
+// field_count 가 0 이면 블록 분할하지 않음 (실수/정수는 기존 바이트 분할 경로)
+struct GgufType {
+    uint32_t id;
+    const char* name;         // 실수/정수는 safetensors 표기 ("F16", "BF16" ...) 라 dtype_kernels 가 알아봄
+    uint32_t block_elements;
+    uint32_t block_bytes;
+    uint32_t field_count;
+    GgufField fields[GGUF_MAX_FIELDS];
+};
+
+// ggml 형 번호 -> 형 정보 (모르는 형이면 nullptr)
+const GgufType* gguf_type(uint32_t id);
+
+struct GgufHeader {
+    uint32_t version = 0;
+    uint64_t kv_count = 0;
+    uint64_t kv_begin = 0;            // KV 원문 구간 (파일 오프셋)
+    uint64_t kv_end = 0;
+    uint64_t alignment = GGUF_DEFAULT_ALIGNMENT;
+    uint64_t data_offset = 0;         // 텐서 데이터 영역 시작 (정렬됨)
+    std::vector<TensorInfo> tensors;  // shape 는 safetensors 처럼 행 우선 (GGUF ne 의 역순), data_* 는 데이터 영역 기준
+    std::vector<uint32_t> types;      // tensors 와 같은 순서의 ggml 형 번호
+};
+
+// 파일 앞 4바이트가 GGUF 매직인지
+bool is_gguf_file(std::FILE* f);
+
+// 메모리의 헤더 파싱. 바이트가 모자라면 truncated = true 로 false (더 읽고 다시 호출)
+// 크기를 모르는 ggml 형의 텐서는 다음 텐서 오프셋 (마지막이면 데이터 영역 끝) 까지로 봄
+bool parse_gguf_header(const char* data, size_t size, uint64_t file_size, GgufHeader& header, bool& truncated);
+
+// 입력 GGUF 의 헤더를 GGUF_HEADER_PROBE 부터 늘려 가며 읽어 파싱
+bool read_gguf_header(std::FILE* in, uint64_t file_size, GgufHeader& header);
+
+// GGUF 텐서 데이터 계획: 블록 분할 가능한 양자화 텐서는 블록 경계에서 자른 자기 청크 (PlannedChunk::quant),
+// 나머지 (실수 텐서, 정렬 빈틈) 는 plan_solid_chunks. spans 는 tensor_spans(header.tensors, ...) 결과, 오프셋은 데이터 영역 기준
+std::vector<PlannedChunk> plan_gguf_chunks(const GgufHeader& header, const std::vector<TensorSpan>& spans, size_t chunk_size);
+
+// ChunkTransform::QuantSplit 변환/역변환 (모르는 형이면 false)
+bool quant_split(const char* src, size_t size, uint32_t type, char* dst);
+bool quant_merge(const char* src, size_t size, uint32_t type, char* dst);
+
+// 양자화 청크를 블록 분할 후 CPU 코덱 (Lz4/Lzma/Zstd/Rans) 으로 인코딩하고 meta 를 채움 (커지면 Stored)
+bool encode_quant_chunk(ChunkCodec codec, const char* data, size_t size, int level, uint32_t type,
+                        ArchiveChunk& meta, std::vector<char>& out);
+
+// v2 아카이브의 첫 파일이 GGUF 인지 (헤더 청크만 해제해 매직 확인)
+bool is_gguf_archive(const std::filesystem::path& archive_path);
+
+// 텐서별 랜덤 액세스: 아카이브의 헤더 청크로 GGUF 헤더를 읽고 지정한 텐서가 걸친 청크만 해제해
+// 같은 KV 메타데이터와 지정한 텐서만 담은 GGUF 로 기록
+void handle_extract_gguf(const std::filesystem::path& archive_path, const std::filesystem::path& output_path,
+                         const std::vector<std::string>& names);
+
+#endif //GGUF_H
@@ -0,0 +1,350 @@
+#include "journal.h"
+#include "compressor.cuh"
+#include "file_util.h"
+#include "kang_format.h"
+#include "dictionary.h"
+#include "tensor_index.h"
+#include "chunking.h"
+#include "safetensors.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstddef>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char JOURNAL_SIGNATURE[8] = { 'K', 'A', 'N', 'G', 'J', 'R', 'N', 'L' };
+const uint64_t JOURNAL_VERSION = 1;
+
+// 저널 헤더: 입력/설정이 재실행 시와 같은지 확인하는 용도
+struct JournalHeader {
+    char signature[8];
+    uint64_t version;
+    uint64_t input_size;
+    uint64_t header_hash;      // JSON 헤더 FNV-1a
+    int64_t compression_level;
+    uint64_t chunk_size;
+    uint64_t num_chunks;
+    uint64_t payload_offset;   // 출력 파일 내 압축 텐서 데이터 시작 위치
+};
+
+// 청크 완료 레코드 (출력에 청크가 기록/동기화된 뒤에 추가됨)
+struct JournalRecord {
+    uint64_t chunk_index;
+    uint64_t offset;           // 출력 파일 내 절대 오프셋
+    uint64_t original_size;
+    uint64_t compressed_size;
+    uint64_t data_hash;        // 압축 청크 FNV-1a
+    uint64_t record_hash;      // 위 필드들의 FNV-1a (찢어진 쓰기 감지)
+};
+
+uint64_t record_hash(const JournalRecord& r)
+{
+    return fnv1a64(&r, offsetof(JournalRecord, record_hash));
+}
+
+fs::path journal_path_for(const fs::path& output_path)
+{
+    fs::path p = output_path;
+    p += ".journal";
+    return p;
+}
+
+// 저널이 없을 때, 이미 완성된 v1 출력인지 확인 (일괄 재실행 시 건너뛰기용)
+bool is_complete_v1_archive(const fs::path& path)
+{
+    std::FILE* f = file_open(path, "rb");
+    if (!f) return false;
+    bool complete = false;
+    char sig[8];
+    uint64_t header_size = 0, num_chunks = 0;
+    if (file_read_at(f, 0, sig, sizeof(sig)) &&
+        std::string(sig, sig + 8) == KANG_SIGNATURE &&
+        file_read_u64(f, header_size) &&
+        file_read_at(f, kang_v1_table_offset(header_size) - sizeof(uint64_t), &num_chunks, sizeof(num_chunks))) {
+        uint64_t payload = 0;
+        bool ok = true;
+        for (uint64_t i = 0; i < num_chunks && ok; ++i) {
+            uint64_t orig = 0, comp = 0;
+            ok = file_read_u64(f, orig) && file_read_u64(f, comp) && orig != 0 && comp != 0;
+            payload += comp;
+        }
+        std::error_code ec;
+        uint64_t size = fs::file_size(path, ec);
+        complete = ok && !ec && size == kang_v1_payload_offset(header_size, num_chunks) + payload;
+    }
+    std::fclose(f);
+    return complete;
+}
+
+// 기존 저널 검증 후 유효한 레코드만 남김. 실패 시 false (새로 시작해야 함)
+bool load_journal(const fs::path& journal_path, const fs::path& output_path,
+                  JournalHeader& expected, std::vector<JournalRecord>& records)
+{
+    records.clear();
+    std::FILE* jf = file_open(journal_path, "rb");
+    if (!jf) return false;
+
+    JournalHeader h{};
+    bool ok = std::fread(&h, sizeof(h), 1, jf) == 1 &&
+              std::memcmp(h.signature, JOURNAL_SIGNATURE, sizeof(JOURNAL_SIGNATURE)) == 0 &&
+              h.version == JOURNAL_VERSION;
+    if (!ok) {
+        std::fclose(jf);
+        std::cerr << "Warning: Journal is unreadable, starting over." << std::endl;
+        return false;
+    }
+    if (h.input_size != expected.input_size || h.header_hash != expected.header_hash ||
+        h.compression_level != expected.compression_level || h.chunk_size != expected.chunk_size ||
+        h.num_chunks != expected.num_chunks) {
+        std::fclose(jf);
+        std::cerr << "Warning: Journal does not match the input file or options, starting over." << std::endl;
+        return false;
+    }
+
+    std::error_code ec;
+    const uint64_t output_size = fs::exists(output_path) ? fs::file_size(output_path, ec) : 0;
+    if (ec || output_size < h.payload_offset) {
+        std::fclose(jf);
+        std::cerr << "Warning: Output file is missing or truncated, starting over." << std::endl;
+        return false;
+    }
+
+    // 순서/오프셋이 연속이고 체크섬이 맞는 레코드까지만 신뢰
+    uint64_t expected_offset = h.payload_offset;
+    JournalRecord r{};
+    while (std::fread(&r, sizeof(r), 1, jf) == 1) {
+        if (r.record_hash != record_hash(r) ||
+            r.chunk_index != records.size() ||
+            r.offset != expected_offset ||
+            r.offset + r.compressed_size > output_size) {
+            break;
+        }
+        records.push_back(r);
+        expected_offset += r.compressed_size;
+    }
+    std::fclose(jf);
+
+    // 출력 파일 자체도 확인: 헤더 레이아웃 일치 + 마지막 청크 내용 검증
+    std::FILE* of = file_open(output_path, "rb");
+    if (!of) return false;
+    char sig[8];
+    uint64_t header_size = 0, num_chunks = 0;
+    ok = file_read_at(of, 0, sig, sizeof(sig)) && std::string(sig, sig + 8) == KANG_SIGNATURE &&
+         file_read_u64(of, header_size) &&
+         file_read_at(of, kang_v1_table_offset(header_size) - sizeof(uint64_t), &num_chunks, sizeof(num_chunks)) &&
+         num_chunks == h.num_chunks &&
+         kang_v1_payload_offset(header_size, num_chunks) == h.payload_offset;
+    std::vector<char> buf;
+    while (ok && !records.empty()) {
+        const JournalRecord& last = records.back();
+        buf.resize(static_cast<size_t>(last.compressed_size));
+        if (file_read_at(of, last.offset, buf.data(), buf.size()) &&
+            fnv1a64(buf.data(), buf.size()) == last.data_hash) {
+            break;
+        }
+        records.pop_back(); // 손상된 꼬리 청크는 다시 압축
+    }
+    std::fclose(of);
+    if (!ok) {
+        std::cerr << "Warning: Output file layout does not match the journal, starting over." << std::endl;
+        records.clear();
+        return false;
+    }
+    expected.payload_offset = h.payload_offset;
+    return true;
+}
+
+} // namespace
+
+void handle_compression_journaled(const fs::path& input_path, const fs::path& output_path, const CompressOptions& options)
+{
+    const int compression_level = options.level;
+    const bool resume = options.resume;
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Compressing " << input_path.string() << "\n-> to ->    " << output_path.string()
+              << (resume ? " (journaled, resume)" : " (journaled)") << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    const fs::path journal_path = journal_path_for(output_path);
+
+    if (resume && !fs::exists(journal_path) && fs::exists(output_path) && is_complete_v1_archive(output_path)) {
+        std::cout << "Output is already complete, skipping." << std::endl;
+        return;
+    }
+
+    // 1. 입력 헤더만 읽음 (텐서 데이터는 청크 단위 스트리밍)
+    std::FILE* in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open file " << input_path.string() << std::endl;
+        return;
+    }
+    const uint64_t input_size = fs::file_size(input_path);
+    std::string json_header;
+    uint64_t data_offset = 0;
+    if (!read_safetensors_header(in, input_size, json_header, data_offset)) {
+        std::fclose(in);
+        return;
+    }
+    const uint64_t data_size = input_size - data_offset;
+    std::vector<size_t> chunk_plan = fixed_chunk_plan(static_cast<size_t>(data_size));
+    if (options.rsyncable) {
+        // 텐서 경계 분할은 헤더로부터 결정적이므로 재개 시 같은 계획이 다시 나옴
+        std::vector<TensorInfo> tensors;
+        if (!parse_safetensors_header(json_header, tensors)) {
+            std::fclose(in);
+            return;
+        }
+        chunk_plan = plan_tensor_aligned_chunks(tensors, data_size);
+    }
+    std::vector<uint64_t> chunk_start(chunk_plan.size() + 1, 0);
+    for (size_t i = 0; i < chunk_plan.size(); ++i) chunk_start[i + 1] = chunk_start[i] + chunk_plan[i];
+    const uint64_t num_chunks = chunk_plan.size();
+
+    JournalHeader jh{};
+    std::memcpy(jh.signature, JOURNAL_SIGNATURE, sizeof(JOURNAL_SIGNATURE));
+    jh.version = JOURNAL_VERSION;
+    jh.input_size = input_size;
+    jh.header_hash = fnv1a64(json_header.data(), json_header.size());
+    jh.compression_level = compression_level;
+    jh.chunk_size = options.rsyncable ? 0 : KANG_CHUNK_SIZE; // 0 = 텐서 경계 분할
+    jh.num_chunks = num_chunks;
+
+    // 2. 기존 저널 검증 (resume 시)
+    std::vector<JournalRecord> records;
+    bool resumed = false;
+    if (resume) {
+        if (fs::exists(journal_path)) {
+            resumed = load_journal(journal_path, output_path, jh, records);
+        } else {
+            std::cout << "No journal found, starting from the beginning." << std::endl;
+        }
+    } else if (fs::exists(journal_path)) {
+        std::cout << "Note: Existing journal is discarded (use --resume to continue it)." << std::endl;
+    }
+
+    std::FILE* out = nullptr;
+    std::FILE* jf = nullptr;
+    if (resumed) {
+        // 마지막 유효 청크 뒤를 잘라내고 이어서 기록
+        std::error_code ec;
+        const uint64_t durable_end = records.empty() ? jh.payload_offset
+                                                     : records.back().offset + records.back().compressed_size;
+        fs::resize_file(output_path, durable_end, ec);
+        if (!ec) fs::resize_file(journal_path, sizeof(JournalHeader) + records.size() * sizeof(JournalRecord), ec);
+        if (ec) {
+            std::cerr << "Error: Cannot truncate output/journal: " << ec.message() << std::endl;
+            std::fclose(in);
+            return;
+        }
+        out = file_open(output_path, "r+b");
+        jf = file_open(journal_path, "ab");
+        if (!out || !jf || !file_seek_end(out)) {
+            std::cerr << "Error: Cannot reopen output/journal for resume." << std::endl;
+            if (out) std::fclose(out);
+            if (jf) std::fclose(jf);
+            std::fclose(in);
+            return;
+        }
+        std::cout << "Resuming: " << records.size() << " of " << num_chunks << " chunks already durable." << std::endl;
+    } else {
+        // 3. 새로 시작: 헤더 압축 후 청크 테이블 자리를 비워 둔 채 기록
+        std::vector<char> compressed_header;
+        if (!compress_header_blob(json_header, options, compressed_header)) {
+            std::cerr << "Compression failed." << std::endl;
+            std::fclose(in);
+            return;
+        }
+        out = file_open(output_path, "wb");
+        if (!out) {
+            std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+            std::fclose(in);
+            return;
+        }
+        const uint64_t compressed_header_size = compressed_header.size();
+        bool ok = std::fwrite(KANG_SIGNATURE.data(), 1, KANG_SIGNATURE.size(), out) == KANG_SIGNATURE.size() &&
+                  file_write_u64(out, compressed_header_size) &&
+                  (compressed_header.empty() ||
+                   std::fwrite(compressed_header.data(), 1, compressed_header.size(), out) == compressed_header.size()) &&
+                  file_write_u64(out, num_chunks);
+        for (uint64_t i = 0; i < num_chunks * 2 && ok; ++i) {
+            ok = file_write_u64(out, 0); // 완료 시 채움
+        }
+        jh.payload_offset = kang_v1_payload_offset(compressed_header_size, num_chunks);
+        jf = ok ? file_open(journal_path, "wb") : nullptr;
+        ok = ok && jf && std::fwrite(&jh, sizeof(jh), 1, jf) == 1 && file_sync(out) && file_sync(jf);
+        if (!ok) {
+            std::cerr << "Error: Cannot initialize output/journal." << std::endl;
+            if (jf) std::fclose(jf);
+            std::fclose(out);
+            std::fclose(in);
+            return;
+        }
+    }
+
+    // 4. 남은 청크 압축: 청크 기록/동기화 -> 저널 레코드 추가/동기화 순서 유지
+    std::vector<char> host_in_buf;
+    uint64_t next_offset = records.empty() ? jh.payload_offset
+                                           : records.back().offset + records.back().compressed_size;
+    bool ok = compress_chunks_streaming(
+        chunk_plan, records.size(),
+        [&](size_t chunk_index, size_t size) -> const char* {
+            host_in_buf.resize(size);
+            if (!file_read_at(in, data_offset + chunk_start[chunk_index], host_in_buf.data(), size)) return nullptr;
+            return host_in_buf.data();
+        },
+        [&](size_t chunk_index, const char* data, size_t original_size, size_t compressed_size) {
+            if (std::fwrite(data, 1, compressed_size, out) != compressed_size || !file_sync(out)) return false;
+            JournalRecord r{};
+            r.chunk_index = chunk_index;
+            r.offset = next_offset;
+            r.original_size = original_size;
+            r.compressed_size = compressed_size;
+            r.data_hash = fnv1a64(data, compressed_size);
+            r.record_hash = record_hash(r);
+            if (std::fwrite(&r, sizeof(r), 1, jf) != 1 || !file_sync(jf)) return false;
+            records.push_back(r);
+            next_offset += compressed_size;
+            return true;
+        },
+        compression_level);
+    std::fclose(in);
+    std::fclose(jf);
+
+    if (!ok || records.size() != num_chunks) {
+        std::fclose(out);
+        std::cerr << "Compression failed. Rerun with --resume to continue from the last durable chunk." << std::endl;
+        return;
+    }
+
+    // 5. 청크 테이블 채우고 저널 제거
+    ok = file_seek(out, jh.payload_offset - num_chunks * KANG_CHUNK_ENTRY_SIZE);
+    for (const auto& r : records) {
+        ok = ok && file_write_u64(out, r.original_size) && file_write_u64(out, r.compressed_size);
+    }
+    ok = ok && file_sync(out);
+    std::fclose(out);
+    if (!ok) {
+        std::cerr << "Error: Cannot finalize chunk table. Rerun with --resume." << std::endl;
+        return;
+    }
+    std::error_code ec;
+    fs::remove(journal_path, ec);
+    if (options.write_index) {
+        KidxChunkLayout chunks;
+        chunks.archive_size = next_offset;
+        chunks.payload_offset = jh.payload_offset;
+        for (const auto& r : records) chunks.chunk_info.emplace_back(r.original_size, r.compressed_size);
+        write_tensor_index_file(json_header, data_size, tensor_index_path_for(output_path), &chunks);
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Tensor data compressed (GPU): " << data_size << " -> " << (next_offset - jh.payload_offset)
+              << " bytes" << std::endl;
+    std::cout << "Compression successful! Took " << diff.count() << " seconds." << std::endl;
+}
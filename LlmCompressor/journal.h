@@ -0,0 +1,16 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <filesystem>
+#include "options.h"
+
+// 저널 모드 압축
+// 완료된 청크를 즉시 출력 파일에 기록하고, 사이드카(<출력>.journal)에 청크 오프셋/크기를 남김.
+// options.resume 이면 저널을 검증한 뒤 마지막으로 기록이 보장된 청크 다음부터 이어서 압축.
+void handle_compression_journaled(
+    const std::filesystem::path& input_path,
+    const std::filesystem::path& output_path,
+    const CompressOptions& options
+);
+
+#endif //JOURNAL_H
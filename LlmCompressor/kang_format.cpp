@@ -0,0 +1,54 @@
+#include "kang_format.h"
+#include "file_util.h"
+#include <iostream>
+#include <filesystem>
+
+bool read_kang_v1_layout(std::FILE* f, KangV1Layout& layout)
+{
+    layout = KangV1Layout();
+
+    char sig[8];
+    if (!file_read_at(f, 0, sig, sizeof(sig)) || std::string(sig, sig + 8) != KANG_SIGNATURE) {
+        std::cerr << "Error: Not a valid .kang file (invalid signature)." << std::endl;
+        return false;
+    }
+    if (!file_seek_end(f)) return false;
+    layout.file_size = file_tell(f);
+
+    uint64_t compressed_header_size = 0;
+    if (!file_read_at(f, KANG_SIGNATURE.size(), &compressed_header_size, sizeof(compressed_header_size)) ||
+        compressed_header_size > layout.file_size) {
+        std::cerr << "Error reading header size." << std::endl;
+        return false;
+    }
+    layout.compressed_header.resize(static_cast<size_t>(compressed_header_size));
+    if (!layout.compressed_header.empty() &&
+        std::fread(layout.compressed_header.data(), 1, layout.compressed_header.size(), f) != layout.compressed_header.size()) {
+        std::cerr << "Error reading compressed header." << std::endl;
+        return false;
+    }
+
+    uint64_t num_chunks = 0;
+    if (!file_read_u64(f, num_chunks) || num_chunks > layout.file_size / KANG_CHUNK_ENTRY_SIZE) {
+        std::cerr << "Error reading num chunks." << std::endl;
+        return false;
+    }
+    layout.chunk_info.reserve(static_cast<size_t>(num_chunks));
+    for (uint64_t i = 0; i < num_chunks; ++i) {
+        uint64_t orig = 0, comp = 0;
+        if (!file_read_u64(f, orig) || !file_read_u64(f, comp)) {
+            std::cerr << "Error reading chunk info." << std::endl;
+            return false;
+        }
+        layout.chunk_info.emplace_back(static_cast<size_t>(orig), static_cast<size_t>(comp));
+    }
+    layout.payload_offset = kang_v1_payload_offset(compressed_header_size, num_chunks);
+
+    uint64_t payload = 0;
+    for (const auto& info : layout.chunk_info) payload += info.second;
+    if (layout.payload_offset + payload > layout.file_size) {
+        std::cerr << "Error: Chunk table points past the end of the file (incomplete write?)." << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef KANG_FORMAT_H
+#define KANG_FORMAT_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+// .kang v1 레이아웃
+// [8B 시그니처][u64 압축 헤더 크기][압축 헤더][u64 청크 수][청크 수 x (u64 원본, u64 압축)][압축 텐서 데이터]
+inline const std::string KANG_SIGNATURE = "KANGCOMP";
+
+// 청크 테이블 한 항목 크기 (u64 원본, u64 압축)
+constexpr uint64_t KANG_CHUNK_ENTRY_SIZE = 16;
+
+// 청크 테이블 시작 오프셋
+inline uint64_t kang_v1_table_offset(uint64_t compressed_header_size)
+{
+    return KANG_SIGNATURE.size() + sizeof(uint64_t) + compressed_header_size + sizeof(uint64_t);
+}
+
+// 압축 텐서 데이터 시작 오프셋
+inline uint64_t kang_v1_payload_offset(uint64_t compressed_header_size, uint64_t num_chunks)
+{
+    return kang_v1_table_offset(compressed_header_size) + num_chunks * KANG_CHUNK_ENTRY_SIZE;
+}
+
+// 페이로드를 읽지 않고 파악한 v1 파일 구조
+struct KangV1Layout {
+    std::vector<char> compressed_header;
+    std::vector<std::pair<size_t, size_t>> chunk_info; // <original_size, compressed_size>
+    uint64_t payload_offset = 0; // 첫 압축 청크의 절대 오프셋
+    uint64_t file_size = 0;
+};
+
+// 시그니처/헤더/청크 테이블만 읽음 (청크 오프셋은 payload_offset 부터 누적)
+bool read_kang_v1_layout(std::FILE* f, KangV1Layout& layout);
+
+#endif //KANG_FORMAT_H
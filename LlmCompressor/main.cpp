@@ -4,7 +4,33 @@
 #include <string>
 #include <chrono>
 #include <filesystem>
+#include <cstring>
+#include <algorithm>
+#include <cstdlib>
 #include "compressor.cuh"
+#include "file_util.h"
+#include "kang_format.h"
+#include "journal.h"
+#include "options.h"
+#include "dictionary.h"
+#include "tensor_index.h"
+#include "archive.h"
+#include "pack.h"
+#include "parallel.h"
+#include "random_access.h"
+#include "transcode.h"
+#include "update.h"
+#include "chunking.h"
+#include "safetensors.h"
+#include "store.h"
+#include "parts.h"
+#include "seekable.h"
+#include "tiers.h"
+#include "rans.h"
+#include "fpc.h"
+#include "gguf.h"
+#include "rules.h"
+#include "dtype_kernels.h"
 
 namespace fs = std::filesystem;
 
@@ -13,17 +39,92 @@ void print_usage() {
     std::cout << "Usage:" << std::endl;
     std::cout << "  kang <command> [options] <input_path> <output_path>" << std::endl;
     std::cout << "\nCommands:" << std::endl;
-    std::cout << "  compress      Compress a .safetensors file or a folder of them." << std::endl;
+    std::cout << "  compress      Compress a .safetensors (or, with --profile, .gguf) file or a folder of them." << std::endl;
     std::cout << "  decompress    Decompress a .kang file or a folder of them." << std::endl;
+    std::cout << "  pack          Pack a whole model repository folder into one archive." << std::endl;
+    std::cout << "  unpack        Unpack an archive (optionally only the listed files)." << std::endl;
+    std::cout << "  list          List the files in an archive." << std::endl;
+    std::cout << "  train-dict    Train a zstd dictionary from headers/small tensors of sample files." << std::endl;
+    std::cout << "  lookup        Look up tensors in a .kidx tensor index (written next to each .kang)." << std::endl;
+    std::cout << "  transcode     Convert a .kang (v1 or v2) to the v2 container, re-encoding only changed chunks." << std::endl;
+    std::cout << "  update        Replace or add tensors in a v2 archive by appending only the changed chunks." << std::endl;
+    std::cout << "  compact       Rewrite an archive without the chunks superseded by updates." << std::endl;
+    std::cout << "  store         Deduplicating chunk store: store add|get|rm|gc|stat (see below)." << std::endl;
+    std::cout << "  index         Build the .kidx index for an existing .kang without decompressing it." << std::endl;
+    std::cout << "  extract       Extract only the listed tensors from a .kang into a new .safetensors (.gguf for GGUF archives)." << std::endl;
+    std::cout << "  merge         Join part files from 'compress --part' into one .kang without recompressing." << std::endl;
+    std::cout << "  bench-rans    Measure rANS decode speed per SIMD level ('kang bench-rans [--size MB] [file.safetensors]')." << std::endl;
+    std::cout << "  bench-transforms  Compare generic and dtype-specialized transform kernels ('--size MB')." << std::endl;
+    std::cout << "  bench-fpc     Measure FPC ratio and 1/N-thread decode speed ('kang bench-fpc [--size MB] [file.safetensors]')." << std::endl;
     std::cout << "\nOptions for 'compress':" << std::endl;
     std::cout << "  -l, --level   Compression level (1-19, default: 10)." << std::endl;
+    std::cout << "  --journal     Write chunks as they finish and keep a resume journal (<output>.journal)." << std::endl;
+    std::cout << "  --resume      Continue an interrupted journaled compression from the last durable chunk." << std::endl;
+    std::cout << "  --dict FILE   Compress the JSON header (and small files entirely) with a trained dictionary." << std::endl;
+    std::cout << "  --embed-dict  Store the dictionary inside the .kang instead of referencing it by ID." << std::endl;
+    std::cout << "  --no-index    Do not write the .kidx binary tensor index." << std::endl;
+    std::cout << "  --rsyncable   Cut chunks only at tensor boundaries so unchanged tensors compress identically." << std::endl;
+    std::cout << "  --part N/M    Compress only the N-th of M equal chunk ranges into a part file (N counts from 0)." << std::endl;
+    std::cout << "  --range A:B   With --part N: compress tensor data bytes [A, B) instead (K/M/G suffixes, empty B = end)." << std::endl;
+    std::cout << "  --profile fast-load  LZ4-HC (-l 3-12, below 3 = plain LZ4) in small chunks for the fastest parallel load." << std::endl;
+    std::cout << "  --profile cold       LZMA2 (-l 0-9 = xz preset, 10+ = 9e) for archival: slow, higher ratio than zstd -19." << std::endl;
+    std::cout << "  --profile entropy    Byte planes coded with interleaved rANS (SIMD decode): no match search, fast load." << std::endl;
+    std::cout << "  --byte-split  With fast-load/cold: split each chunk into byte planes of its dominant dtype before LZ4." << std::endl;
+    std::cout << "  --solid       With --profile: large tensors get their own chunks, small ones are grouped by dtype." << std::endl;
+    std::cout << "  --reorder     With --profile: chunk tensors grouped by dtype, shape and name role (layout restored on decompress)." << std::endl;
+    std::cout << "  --fpc         With --profile: code fp32/fp64 chunks with the FPC predictive float coder." << std::endl;
+    std::cout << "  --moe         With --profile (implies --solid): store similar MoE experts as XOR residuals against a reference expert." << std::endl;
+    std::cout << "  --rule SPEC   With --profile (implies --solid): per-tensor override 'pattern=codec[:level[:transform]]'," << std::endl;
+    std::cout << "                codec zstd (CPU, level 1-22)|lz4|lzma|rans|fpc|store, transform split|plain|transpose. First match wins." << std::endl;
+    std::cout << "  --rules FILE  Read rules from FILE (one per line, # comments), checked before --rule." << std::endl;
+    std::cout << "  --transpose   With --byte-split (implies --solid): lay out matrix chunks column-major when an entropy estimate favours it." << std::endl;
+    std::cout << "  --seekable    Write standard zstd frames with a seekable-format seek table ('zstd -d' restores the file)." << std::endl;
+    std::cout << "  --volume-size SIZE  Split the output into <output>.000, .001 ... of at most SIZE bytes (e.g. 4G)." << std::endl;
+    std::cout << "\nOptions for 'merge' ('kang merge [--no-index] <output.kang> <parts...>'):" << std::endl;
+    std::cout << "  --no-index    Do not write the .kidx binary tensor index." << std::endl;
+    std::cout << "\nOptions for 'decompress':" << std::endl;
+    std::cout << "  --dict FILE   Dictionary to use (otherwise embedded, $KANG_DICT_DIR/<id>.zdict or next to the file)." << std::endl;
+    std::cout << "  --wait SEC    For volumes (<input>.000 ...): wait up to SEC seconds for missing volumes to arrive." << std::endl;
+    std::cout << "\nOptions for 'transcode':" << std::endl;
+    std::cout << "  -l, --level   Re-encode LZ4/LZMA chunks written with a different level (nvCOMP zstd has no level)." << std::endl;
+    std::cout << "  --codec NAME  Re-encode chunks to another codec (zstd, lz4, lzma, rans, store) to move between tiers." << std::endl;
+    std::cout << "  -j, --threads Number of parallel workers (default: number of CPU cores)." << std::endl;
+    std::cout << "  --dict FILE   Dictionary for v1 headers/small files compressed with one." << std::endl;
+    std::cout << "\nOptions for 'update':" << std::endl;
+    std::cout << "  --replace FILE  .safetensors with the new tensors (existing names are replaced, others added)." << std::endl;
+    std::cout << "  --file NAME     File inside a multi-file archive to update." << std::endl;
+    std::cout << "  -l, --level     Compression level for the new chunks (default: level of the archive's chunks)." << std::endl;
+    std::cout << "  --codec NAME    Codec for the new chunks (zstd, lz4, lzma, rans, store; default: the archive's tier codec)." << std::endl;
+    std::cout << "\nChunk store ('kang store <sub> [--store DIR] ...', default DIR: $KANG_STORE):" << std::endl;
+    std::cout << "  add [-l N] [-j N] <input> <manifest.kang>   Store a file/folder, write thin manifest(s)." << std::endl;
+    std::cout << "  get <manifest.kang> <output>                Restore a file from its manifest." << std::endl;
+    std::cout << "  rm <manifest.kang...>                       Delete manifests and drop their references." << std::endl;
+    std::cout << "  gc                                          Remove unreferenced chunks and compact packs." << std::endl;
+    std::cout << "  stat                                        Show logical/unique/stored sizes." << std::endl;
+    std::cout << "\nOptions for 'index' / 'extract':" << std::endl;
+    std::cout << "  --dict FILE   Dictionary used for the header (same lookup as 'decompress')." << std::endl;
+    std::cout << "\nOptions for 'train-dict':" << std::endl;
+    std::cout << "  --size BYTES  Dictionary size (default: 112640)." << std::endl;
+    std::cout << "\nOptions for 'pack' / 'unpack':" << std::endl;
+    std::cout << "  -l, --level   Compression level (pack only)." << std::endl;
+    std::cout << "  -j, --threads Number of parallel workers (default: number of CPU cores)." << std::endl;
     std::cout << "\nExamples:" << std::endl;
     std::cout << "  kang compress model.safetensors model.kang" << std::endl;
     std::cout << "  kang compress -l 15 models_folder/ compressed_folder/" << std::endl;
+    std::cout << "  kang compress --resume huge.safetensors huge.kang" << std::endl;
+    std::cout << "  kang train-dict adapters/ headers.zdict" << std::endl;
+    std::cout << "  kang compress --dict headers.zdict adapters/ compressed/" << std::endl;
+    std::cout << "  kang compress --profile fast-load --rule 'model.embed_tokens.*=lzma:9' --rule '*.self_attn.*=zstd:3:split' model.safetensors model.kang" << std::endl;
+    std::cout << "  kang pack my-model/ my-model.kang" << std::endl;
+    std::cout << "  kang unpack my-model.kang out/ config.json tokenizer.json" << std::endl;
+    std::cout << "  kang transcode old-model.kang model-v2.kang" << std::endl;
+    std::cout << "  kang update model.kang --replace patched.safetensors" << std::endl;
+    std::cout << "  kang compact model.kang" << std::endl;
+    std::cout << "  kang store add --store /data/kstore finetunes/ manifests/" << std::endl;
+    std::cout << "  kang index old-model.kang" << std::endl;
+    std::cout << "  kang extract model.kang embed.safetensors model.embed_tokens.weight" << std::endl;
 }
 
-const std::string KANG_SIGNATURE = "KANGCOMP";
-
 static bool read_all(const fs::path& path, std::vector<char>& buffer)
 {
     std::ifstream in(path, std::ios::binary);
@@ -38,7 +139,7 @@ static bool read_all(const fs::path& path, std::vector<char>& buffer)
 }
 
 //     (   ߰)
-void handle_compression(const fs::path& input_path, const fs::path& output_path, int compression_level) {
+void handle_compression(const fs::path& input_path, const fs::path& output_path, const CompressOptions& options) {
     std::cout << "--------------------------------------------------" << std::endl;
     std::cout << "Compressing " << input_path.string() << "\n-> to ->    " << output_path.string() << std::endl;
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -66,8 +167,28 @@ void handle_compression(const fs::path& input_path, const fs::path& output_path,
     std::vector<char> tensor_data(file_buffer.begin() + 8 + header_len, file_buffer.end());
 
     // 3.   (  )
+    std::vector<size_t> chunk_plan;
+    if (options.rsyncable) {
+        std::vector<TensorInfo> tensors;
+        if (!parse_safetensors_header(json_header, tensors)) return;
+        chunk_plan = plan_tensor_aligned_chunks(tensors, tensor_data.size());
+    }
     CompressionResult comp_result;
-    if (!compress_safetensor(json_header, tensor_data, comp_result, compression_level)) {
+    bool compressed = false;
+    if (options.dict_path.empty()) {
+        compressed = compress_safetensor(json_header, tensor_data, comp_result, options.level, chunk_plan);
+    }
+    else if (tensor_data.size() <= KANG_DICT_MAX_SMALL_DATA) {
+        //   GPU ʱȭ  CPU zstd+ ó
+        compressed = compress_small_with_dictionary(json_header, tensor_data, options, comp_result.compressed_header,
+                                                    comp_result.compressed_tensors, comp_result.chunk_info);
+    }
+    else {
+        // ټ GPU,   
+        compressed = compress_safetensor(std::string(), tensor_data, comp_result, options.level, chunk_plan) &&
+                     compress_header_blob(json_header, options, comp_result.compressed_header);
+    }
+    if (!compressed) {
         std::cerr << "Compression failed." << std::endl;
         return;
     }
@@ -95,13 +216,52 @@ void handle_compression(const fs::path& input_path, const fs::path& output_path,
         out_file.write(comp_result.compressed_tensors.data(), comp_result.compressed_tensors.size());
     out_file.close();
 
+    // 5. ̳ʸ ټ ε (.kidx)
+    if (options.write_index) {
+        KidxChunkLayout chunks;
+        chunks.archive_size = fs::file_size(output_path);
+        chunks.payload_offset = kang_v1_payload_offset(compressed_header_size, num_chunks);
+        chunks.chunk_info = comp_result.chunk_info;
+        write_tensor_index_file(json_header, tensor_data.size(), tensor_index_path_for(output_path), &chunks);
+    }
+
     auto end_time = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> diff = end_time - start_time;
     std::cout << "Compression successful! Took " << diff.count() << " seconds." << std::endl;
 }
 
 //     
-void handle_decompression(const fs::path& input_path, const fs::path& output_path) {
+// v2 ̳ʿ  ϳ̸ (transcode  ) decompress ε Ǯ  ְ 
+static void decompress_v2_single_file(const fs::path& input_path, const fs::path& output_path,
+                                      std::chrono::high_resolution_clock::time_point start_time)
+{
+    std::FILE* in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open input file " << input_path.string() << std::endl;
+        return;
+    }
+    ArchiveIndex index;
+    bool ok = read_archive_index(in, index);
+    std::fclose(in);
+    if (!ok) return;
+    if (index.files.size() != 1) {
+        std::cerr << "Error: " << input_path.string() << " is a multi-file archive, use 'kang unpack'." << std::endl;
+        return;
+    }
+
+    size_t decoded = 0;
+    std::vector<fs::path> out_paths{ output_path };
+    if (!extract_archive_files(input_path, index, { 0 }, out_paths, default_thread_count(), decoded)) {
+        std::cerr << "Decompression failed." << std::endl;
+        return;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Decompression successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+void handle_decompression(const fs::path& input_path, const fs::path& output_path, const fs::path& dict_path) {
     std::cout << "----------------------------------------------------" << std::endl;
     std::cout << "Decompressing " << input_path.string() << "\n-> to ->      " << output_path.string() << std::endl;
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -115,6 +275,32 @@ void handle_decompression(const fs::path& input_path, const fs::path& output_pat
     std::vector<char> signature_buf(KANG_SIGNATURE.size());
     in_file.read(signature_buf.data(), signature_buf.size());
     if (!in_file.good() || std::string(signature_buf.begin(), signature_buf.end()) != KANG_SIGNATURE) {
+        if (std::string(signature_buf.begin(), signature_buf.end()) == KANG_MANIFEST_SIGNATURE) {
+            // ûũ  Ŵ佺Ʈ:  ġ ȯ 
+            in_file.close();
+            if (const char* store_dir = std::getenv(KANG_STORE_ENV)) {
+                handle_store_get(store_dir, input_path, output_path);
+            } else {
+                std::cerr << "Error: " << input_path.string() << " is a chunk store manifest, set " << KANG_STORE_ENV
+                          << " or use 'kang store get'." << std::endl;
+            }
+            return;
+        }
+        if (is_seekable_zstd(input_path)) {
+            in_file.close();
+            handle_decompress_seekable(input_path, output_path);
+            return;
+        }
+        if (std::string(signature_buf.begin(), signature_buf.end()) == KANG_PART_SIGNATURE) {
+            std::cerr << "Error: " << input_path.string() << " is a part file, join the parts with 'kang merge' first."
+                      << std::endl;
+            return;
+        }
+        if (std::string(signature_buf.begin(), signature_buf.end()) == KANG_V2_SIGNATURE) {
+            in_file.close();
+            decompress_v2_single_file(input_path, output_path, start_time);
+            return;
+        }
         std::cerr << "Error: Not a valid .kang file (invalid signature)." << std::endl;
         return;
     }
@@ -158,12 +344,31 @@ void handle_decompression(const fs::path& input_path, const fs::path& output_pat
     }
     in_file.close();
 
+    //  (CPU zstd)  CPU ,  GPU  
     std::string json_header;
     std::vector<char> tensor_data;
-    if (!decompress_kang(compressed_header, compressed_tensors, chunk_info, json_header, tensor_data)) {
+    ZstdDictionary dict;
+    if (!decompress_header_blob(compressed_header, input_path, dict_path, json_header, dict)) {
         std::cerr << "Decompression failed." << std::endl;
         return;
     }
+    const bool cpu_tensors = chunk_info.size() == 1 &&
+                             is_cpu_zstd_blob(compressed_tensors.data(), std::min(compressed_tensors.size(), chunk_info[0].second));
+    if (cpu_tensors) {
+        if ((dict.id == 0 && !resolve_dictionary(compressed_tensors.data(), chunk_info[0].second, input_path, dict_path, dict)) ||
+            !decompress_with_dictionary(compressed_tensors.data(), chunk_info[0].second, dict, tensor_data) ||
+            tensor_data.size() != chunk_info[0].first) {
+            std::cerr << "Decompression failed." << std::endl;
+            return;
+        }
+    }
+    else {
+        std::string unused_header;
+        if (!decompress_kang(std::vector<char>(), compressed_tensors, chunk_info, unused_header, tensor_data)) {
+            std::cerr << "Decompression failed." << std::endl;
+            return;
+        }
+    }
 
     std::ofstream out_file(output_path, std::ios::binary);
     if (!out_file) { std::cerr << "Error: Cannot create output file." << std::endl; return; }
@@ -178,8 +383,73 @@ void handle_decompression(const fs::path& input_path, const fs::path& output_pat
     std::cout << "Decompression successful! Took " << diff.count() << " seconds." << std::endl;
 }
 
+// pack / unpack / list  ó
+static int run_archive_command(const std::vector<std::string>& args)
+{
+    const std::string& command = args[0];
+    int compression_level = 10;
+    size_t threads = default_thread_count();
+
+    size_t i = 1;
+    while (i < args.size() && args[i].size() > 1 && args[i][0] == '-') {
+        const std::string& opt = args[i];
+        if ((opt == "-l" || opt == "--level" || opt == "-j" || opt == "--threads") && i + 1 < args.size()) {
+            try {
+                int v = std::stoi(args[i + 1]);
+                if (opt == "-l" || opt == "--level") compression_level = v;
+                else threads = static_cast<size_t>(std::max(1, v));
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid value for " << opt << std::endl;
+                print_usage();
+                return 1;
+            }
+            i += 2;
+        }
+        else {
+            std::cerr << "Error: Unknown option " << opt << std::endl;
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (command == "list") {
+        if (i + 1 != args.size()) { print_usage(); return 1; }
+        handle_list(args[i]);
+        return 0;
+    }
+    if (args.size() < i + 2) {
+        print_usage();
+        return 1;
+    }
+    if (command == "pack") {
+        if (!fs::is_directory(args[i])) {
+            std::cerr << "Error: Input path is not a directory: " << args[i] << std::endl;
+            return 1;
+        }
+        handle_pack(args[i], args[i + 1], compression_level, threads);
+    }
+    else {
+        std::vector<std::string> files(args.begin() + static_cast<std::ptrdiff_t>(i + 2), args.end());
+        handle_unpack(args[i], args[i + 1], files, threads);
+    }
+    return 0;
+}
+
+// Ʈ ũ Ľ (K/M/G ̻ = 1024 )
+uint64_t parse_byte_size(const std::string& text) {
+    size_t used = 0;
+    uint64_t value = std::stoull(text, &used);
+    const std::string suffix = text.substr(used);
+    if (suffix == "K" || suffix == "k") value <<= 10;
+    else if (suffix == "M" || suffix == "m") value <<= 20;
+    else if (suffix == "G" || suffix == "g") value <<= 30;
+    else if (!suffix.empty()) throw std::invalid_argument(text);
+    return value;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 3) { // kang <command> <input> [<output>]
+    const bool bench = argc >= 2 && std::strncmp(argv[1], "bench-", 6) == 0; // ġũ  ̵ 
+    if (argc < 3 && !bench) { // kang <command> <input> [<output>]
         print_usage();
         return 1;
     }
@@ -188,25 +458,475 @@ int main(int argc, char* argv[]) {
     std::string command;
     fs::path input_path;
     fs::path output_path;
-    int compression_level = 10; // ⺻  
+    CompressOptions options; // ⺻   10
+    fs::path dict_path;      // decompress  
+    unsigned wait_seconds = 0; //    (decompress --wait)
 
     command = args[0];
-    
-    size_t path_arg_index = 1;
-    if (command == "compress" && args.size() > 3) {
-        if (args[1] == "-l" || args[1] == "--level") {
-            if (args.size() < 5) { // kang compress -l 15 <input> <output>
-                print_usage();
+
+    if (command == "pack" || command == "unpack" || command == "list") {
+        try {
+            return run_archive_command(args);
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (command == "train-dict") {
+        // kang train-dict [--size N] <inputs...> <output.zdict>
+        size_t dict_size = KANG_DICT_DEFAULT_SIZE;
+        size_t i = 1;
+        if (i + 1 < args.size() && args[i] == "--size") {
+            try {
+                dict_size = static_cast<size_t>(std::stoull(args[i + 1]));
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid dictionary size." << std::endl;
                 return 1;
             }
+            i += 2;
+        }
+        if (args.size() < i + 2) {
+            print_usage();
+            return 1;
+        }
+        std::vector<fs::path> inputs(args.begin() + static_cast<std::ptrdiff_t>(i), args.end() - 1);
+        try {
+            handle_train_dict(inputs, args.back(), dict_size);
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "bench-rans" || command == "bench-transforms" || command == "bench-fpc") {
+        // kang bench-rans|bench-fpc [--size MB] [model.safetensors] / kang bench-transforms [--size MB]
+        size_t megabytes = command == "bench-rans" ? 64 : 32;
+        size_t i = 1;
+        if (i + 1 < args.size() && args[i] == "--size") {
             try {
-                compression_level = std::stoi(args[2]);
+                megabytes = static_cast<size_t>(std::stoull(args[i + 1]));
             } catch (const std::exception&) {
-                std::cerr << "Error: Invalid compression level." << std::endl;
+                std::cerr << "Error: Invalid benchmark size." << std::endl;
+                return 1;
+            }
+            i += 2;
+        }
+        if (args.size() > i + (command == "bench-transforms" ? 0 : 1)) {
+            print_usage();
+            return 1;
+        }
+        if (command == "bench-transforms") {
+            handle_bench_transforms(megabytes);
+            return 0;
+        }
+        try {
+            const fs::path sample = i < args.size() ? fs::path(args[i]) : fs::path();
+            if (command == "bench-fpc") handle_bench_fpc(sample, megabytes);
+            else handle_bench_rans(sample, megabytes);
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "lookup") {
+        // kang lookup <model.kidx> [tensor names...]
+        std::vector<std::string> names(args.begin() + 2, args.end());
+        handle_lookup(args[1], names);
+        return 0;
+    }
+
+    if (command == "transcode") {
+        // kang transcode [-l N] [--codec zstd|lz4|lzma|rans|store] [-j N] [--dict d.zdict] <input.kang> <output.kang>
+        TranscodeOptions options;
+        options.threads = default_thread_count();
+        size_t i = 1;
+        while (i + 1 < args.size() && args[i].size() > 1 && args[i][0] == '-') {
+            const std::string& opt = args[i];
+            const std::string& value = args[i + 1];
+            if (opt == "-l" || opt == "--level" || opt == "-j" || opt == "--threads") {
+                try {
+                    int v = std::stoi(value);
+                    if (opt == "-l" || opt == "--level") options.level = v;
+                    else options.threads = static_cast<size_t>(std::max(1, v));
+                } catch (const std::exception&) {
+                    std::cerr << "Error: Invalid value for " << opt << std::endl;
+                    return 1;
+                }
+            }
+            else if (opt == "--codec" &&
+                     (value == "zstd" || value == "lz4" || value == "lzma" || value == "rans" || value == "store")) {
+                options.codec = static_cast<int>(value == "zstd" ? ChunkCodec::NvcompZstd
+                                                 : value == "lz4" ? ChunkCodec::Lz4
+                                                 : value == "lzma" ? ChunkCodec::Lzma
+                                                 : value == "rans" ? ChunkCodec::Rans : ChunkCodec::Stored);
+            }
+            else if (opt == "--dict") {
+                options.dict_path = value;
+            }
+            else {
+                std::cerr << "Error: Unknown option " << opt << " " << value << std::endl;
+                print_usage();
+                return 1;
+            }
+            i += 2;
+        }
+        if (args.size() != i + 2) {
+            print_usage();
+            return 1;
+        }
+        try {
+            handle_transcode(args[i], args[i + 1], options);
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "update") {
+        // kang update [-l N] [--codec NAME] [--file NAME] <archive.kang> --replace <tensors.safetensors>
+        int compression_level = -1, codec = -1;
+        fs::path archive_path, replace_path;
+        std::string file_name;
+        for (size_t i = 1; i < args.size(); ++i) {
+            const std::string& opt = args[i];
+            if ((opt == "-l" || opt == "--level") && i + 1 < args.size()) {
+                try {
+                    compression_level = std::stoi(args[++i]);
+                } catch (const std::exception&) {
+                    std::cerr << "Error: Invalid value for " << opt << std::endl;
+                    return 1;
+                }
+            }
+            else if (opt == "--codec" && i + 1 < args.size()) {
+                const std::string& value = args[++i];
+                if (value == "zstd") codec = static_cast<int>(ChunkCodec::NvcompZstd);
+                else if (value == "lz4") codec = static_cast<int>(ChunkCodec::Lz4);
+                else if (value == "lzma") codec = static_cast<int>(ChunkCodec::Lzma);
+                else if (value == "rans") codec = static_cast<int>(ChunkCodec::Rans);
+                else if (value == "store") codec = static_cast<int>(ChunkCodec::Stored);
+                else {
+                    std::cerr << "Error: Unknown codec (available: zstd, lz4, lzma, rans, store)." << std::endl;
+                    return 1;
+                }
+            }
+            else if (opt == "--replace" && i + 1 < args.size()) replace_path = args[++i];
+            else if (opt == "--file" && i + 1 < args.size()) file_name = args[++i];
+            else if (archive_path.empty() && opt[0] != '-') archive_path = opt;
+            else {
+                std::cerr << "Error: Unknown option " << opt << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
+        if (archive_path.empty() || replace_path.empty()) {
+            print_usage();
+            return 1;
+        }
+        try {
+            handle_update(archive_path, replace_path, file_name, compression_level, codec);
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "merge") {
+        // kang merge [--no-index] <output.kang> <part files...>
+        size_t i = 1;
+        bool write_index = true;
+        if (i < args.size() && args[i] == "--no-index") {
+            write_index = false;
+            ++i;
+        }
+        if (args.size() < i + 2) {
+            print_usage();
+            return 1;
+        }
+        try {
+            std::vector<fs::path> parts(args.begin() + static_cast<std::ptrdiff_t>(i + 1), args.end());
+            handle_merge(args[i], parts, write_index);
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "compact") {
+        // kang compact <archive.kang> [output.kang]
+        if (args.size() != 2 && args.size() != 3) {
+            print_usage();
+            return 1;
+        }
+        try {
+            handle_compact(args[1], args.size() == 3 ? fs::path(args[2]) : fs::path());
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "store") {
+        // kang store <add|get|rm|gc|stat> [--store DIR] [-l N] [-j N] <args...>
+        if (args.size() < 2) {
+            print_usage();
+            return 1;
+        }
+        const std::string& sub = args[1];
+        fs::path store_dir;
+        if (const char* env = std::getenv(KANG_STORE_ENV)) store_dir = env;
+        int compression_level = 10;
+        size_t threads = default_thread_count();
+        std::vector<fs::path> rest;
+        for (size_t i = 2; i < args.size(); ++i) {
+            const std::string& opt = args[i];
+            if (opt == "--store" && i + 1 < args.size()) {
+                store_dir = args[++i];
+            }
+            else if ((opt == "-l" || opt == "--level" || opt == "-j" || opt == "--threads") && i + 1 < args.size()) {
+                try {
+                    int v = std::stoi(args[++i]);
+                    if (opt == "-l" || opt == "--level") compression_level = v;
+                    else threads = static_cast<size_t>(std::max(1, v));
+                } catch (const std::exception&) {
+                    std::cerr << "Error: Invalid value for " << opt << std::endl;
+                    return 1;
+                }
+            }
+            else {
+                rest.push_back(opt);
+            }
+        }
+        if (store_dir.empty()) {
+            std::cerr << "Error: No store given (use --store DIR or set " << KANG_STORE_ENV << ")." << std::endl;
+            return 1;
+        }
+        try {
+            if (sub == "add" && rest.size() == 2) handle_store_add(store_dir, rest[0], rest[1], compression_level, threads);
+            else if (sub == "get" && rest.size() == 2) handle_store_get(store_dir, rest[0], rest[1]);
+            else if (sub == "rm" && !rest.empty()) handle_store_remove(store_dir, rest);
+            else if (sub == "gc" && rest.empty()) handle_store_gc(store_dir);
+            else if (sub == "stat" && rest.empty()) handle_store_stat(store_dir);
+            else {
+                print_usage();
+                return 1;
+            }
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "index" || command == "extract") {
+        // kang index [--dict d.zdict] <model.kang>
+        // kang extract [--dict d.zdict] <model.kang> <out.safetensors|out.gguf> <tensor names...>
+        fs::path dict_path;
+        size_t i = 1;
+        if (i + 1 < args.size() && args[i] == "--dict") {
+            dict_path = args[i + 1];
+            i += 2;
+        }
+        const size_t required = (command == "index") ? 1 : 3;
+        if (args.size() < i + required) {
+            print_usage();
+            return 1;
+        }
+        try {
+            if (command == "index") {
+                handle_build_index(args[i], dict_path);
+            }
+            else {
+                std::vector<std::string> names(args.begin() + static_cast<std::ptrdiff_t>(i + 2), args.end());
+                handle_extract(args[i], args[i + 1], names, dict_path);
+            }
+        }
+        catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    size_t path_arg_index = 1;
+    if (command == "compress" || command == "decompress") {
+        // ɼ  տ ġ: kang compress [-l 15] [--journal|--resume] [--dict d.zdict] <input> <output>
+        while (path_arg_index < args.size() && args[path_arg_index].size() > 1 && args[path_arg_index][0] == '-') {
+            const std::string& opt = args[path_arg_index];
+            if (opt == "--dict") {
+                if (path_arg_index + 1 >= args.size()) {
+                    print_usage();
+                    return 1;
+                }
+                options.dict_path = args[path_arg_index + 1];
+                dict_path = options.dict_path;
+                path_arg_index += 2;
+            }
+            else if (opt == "--wait" && command == "decompress") {
+                if (path_arg_index + 1 >= args.size()) {
+                    print_usage();
+                    return 1;
+                }
+                try {
+                    wait_seconds = static_cast<unsigned>(std::stoul(args[path_arg_index + 1]));
+                } catch (const std::exception&) {
+                    std::cerr << "Error: Invalid --wait value." << std::endl;
+                    return 1;
+                }
+                path_arg_index += 2;
+            }
+            else if (command == "decompress") {
+                std::cerr << "Error: Unknown option " << opt << std::endl;
+                print_usage();
+                return 1;
+            }
+            else if (opt == "--embed-dict") {
+                options.embed_dict = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--no-index") {
+                options.write_index = false;
+                path_arg_index += 1;
+            }
+            else if (opt == "--rsyncable") {
+                options.rsyncable = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--profile") {
+                const std::string profile = path_arg_index + 1 < args.size() ? args[path_arg_index + 1] : std::string();
+                if (profile == "fast-load") options.profile = CompressProfile::FastLoad;
+                else if (profile == "cold") options.profile = CompressProfile::Cold;
+                else if (profile == "entropy") options.profile = CompressProfile::Entropy;
+                else {
+                    std::cerr << "Error: Unknown profile (available: fast-load, cold, entropy)." << std::endl;
+                    return 1;
+                }
+                path_arg_index += 2;
+            }
+            else if (opt == "--byte-split") {
+                options.byte_split = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--solid") {
+                options.solid = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--reorder") {
+                options.reorder = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--fpc") {
+                options.fpc = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--moe") {
+                options.moe = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--rule" || opt == "--rules") {
+                if (path_arg_index + 1 >= args.size()) {
+                    print_usage();
+                    return 1;
+                }
+                if (opt == "--rule") options.rules.push_back(args[path_arg_index + 1]);
+                else options.rules_file = args[path_arg_index + 1];
+                path_arg_index += 2;
+            }
+            else if (opt == "--transpose") {
+                options.transpose = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--seekable") {
+                options.seekable = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--volume-size") {
+                if (path_arg_index + 1 >= args.size()) {
+                    print_usage();
+                    return 1;
+                }
+                try {
+                    options.volume_size = parse_byte_size(args[path_arg_index + 1]);
+                } catch (const std::exception&) {
+                    options.volume_size = 0;
+                }
+                if (options.volume_size == 0) {
+                    std::cerr << "Error: Invalid --volume-size value." << std::endl;
+                    return 1;
+                }
+                path_arg_index += 2;
+            }
+            else if (opt == "--part" || opt == "--range") {
+                // --part N/M (ûũ ȹ M ) Ǵ --part N --range A:B
+                if (path_arg_index + 1 >= args.size()) {
+                    print_usage();
+                    return 1;
+                }
+                const std::string& value = args[path_arg_index + 1];
+                options.partial = true;
+                try {
+                    if (opt == "--part") {
+                        const size_t slash = value.find('/');
+                        options.part_index = static_cast<uint32_t>(std::stoul(value.substr(0, slash)));
+                        options.part_count = slash == std::string::npos ? 0
+                                           : static_cast<uint32_t>(std::stoul(value.substr(slash + 1)));
+                        if (slash != std::string::npos && options.part_count == 0) throw std::invalid_argument(value);
+                    } else {
+                        const size_t colon = value.find(':');
+                        if (colon == std::string::npos) throw std::invalid_argument(value);
+                        options.range_begin = parse_byte_size(value.substr(0, colon));
+                        options.range_end = colon + 1 == value.size() ? UINT64_MAX : parse_byte_size(value.substr(colon + 1));
+                    }
+                } catch (const std::exception&) {
+                    std::cerr << "Error: Invalid " << opt << " value " << value << std::endl;
+                    print_usage();
+                    return 1;
+                }
+                path_arg_index += 2;
+            }
+            else if (opt == "-l" || opt == "--level") {
+                if (path_arg_index + 1 >= args.size()) {
+                    print_usage();
+                    return 1;
+                }
+                try {
+                    options.level = std::stoi(args[path_arg_index + 1]);
+                } catch (const std::exception&) {
+                    std::cerr << "Error: Invalid compression level." << std::endl;
+                    print_usage();
+                    return 1;
+                }
+                path_arg_index += 2;
+            }
+            else if (opt == "--journal") {
+                options.journal = true;
+                path_arg_index += 1;
+            }
+            else if (opt == "--resume") {
+                options.journal = true;
+                options.resume = true;
+                path_arg_index += 1;
+            }
+            else {
+                std::cerr << "Error: Unknown option " << opt << std::endl;
                 print_usage();
                 return 1;
             }
-            path_arg_index = 3;
         }
     }
 
@@ -214,6 +934,53 @@ int main(int argc, char* argv[]) {
         print_usage();
         return 1;
     }
+    if ((options.partial || options.volume_size) && options.journal) {
+        std::cerr << "Error: --part/--range/--volume-size cannot be combined with --journal or --resume." << std::endl;
+        return 1;
+    }
+    if (options.partial && options.volume_size) {
+        std::cerr << "Error: --volume-size cannot be combined with --part/--range." << std::endl;
+        return 1;
+    }
+    const bool tiered = options.profile != CompressProfile::Default;
+    if (options.byte_split && !tiered) {
+        std::cerr << "Error: --byte-split needs --profile fast-load or cold." << std::endl;
+        return 1;
+    }
+    if (options.transpose && !options.byte_split) {
+        std::cerr << "Error: --transpose needs --byte-split (it reorders elements before the plane split)." << std::endl;
+        return 1;
+    }
+    if (options.fpc && !tiered) {
+        std::cerr << "Error: --fpc needs --profile fast-load, cold or entropy." << std::endl;
+        return 1;
+    }
+    if ((options.solid || options.reorder || options.transpose || options.moe) && (!tiered || options.rsyncable)) {
+        std::cerr << "Error: --solid/--reorder/--transpose/--moe need --profile and cannot be combined with --rsyncable." << std::endl;
+        return 1;
+    }
+    if (!options.rules.empty() || !options.rules_file.empty()) {
+        if (!tiered || options.rsyncable) {
+            std::cerr << "Error: --rule/--rules need --profile and cannot be combined with --rsyncable." << std::endl;
+            return 1;
+        }
+        std::vector<TensorRule> rules; // ϸ  ϱ  Ģ   ˸
+        if (!load_tensor_rules(options.rules, options.rules_file, rules)) return 1;
+    }
+    if (tiered && (options.journal || options.partial || options.volume_size || options.seekable)) {
+        std::cerr << "Error: --profile cannot be combined with --journal, --part, --volume-size or --seekable."
+                  << std::endl;
+        return 1;
+    }
+    if (options.seekable && (options.journal || options.partial || options.volume_size)) {
+        std::cerr << "Error: --seekable writes a single plain zstd file and cannot be combined with "
+                     "--journal, --part or --volume-size." << std::endl;
+        return 1;
+    }
+    if (options.part_count > 0 && (options.range_begin != 0 || options.range_end != UINT64_MAX)) {
+        std::cerr << "Error: --range takes a plain part number (--part N), not N/M." << std::endl;
+        return 1;
+    }
     input_path = args[path_arg_index];
     output_path = args[path_arg_index + 1];
 
@@ -224,13 +991,22 @@ int main(int argc, char* argv[]) {
                 fs::create_directories(output_path);
             }
 
+            if (options.partial) {
+                std::cerr << "Error: --part/--range work on a single .safetensors file." << std::endl;
+                return 1;
+            }
             int count = 0;
             if (command == "compress") {
                 std::cout << "Starting batch compression from: " << input_path.string() << std::endl;
                 for (const auto& entry : fs::directory_iterator(input_path)) {
-                    if (entry.is_regular_file() && entry.path().extension() == ".safetensors") {
+                    const bool gguf = tiered && entry.path().extension() == ".gguf";
+                    if (entry.is_regular_file() && (entry.path().extension() == ".safetensors" || gguf)) {
                         fs::path out_file = output_path / entry.path().filename().replace_extension(".kang");
-                        handle_compression(entry.path(), out_file, compression_level);
+                        if (tiered) handle_compression_tiered(entry.path(), out_file, options);
+                        else if (options.seekable) handle_compression_seekable(entry.path(), out_file, options);
+                        else if (options.volume_size) handle_compression_volumes(entry.path(), out_file, options);
+                        else if (options.journal) handle_compression_journaled(entry.path(), out_file, options);
+                        else handle_compression(entry.path(), out_file, options);
                         count++;
                     }
                 }
@@ -239,8 +1015,9 @@ int main(int argc, char* argv[]) {
                 std::cout << "Starting batch decompression from: " << input_path.string() << std::endl;
                 for (const auto& entry : fs::directory_iterator(input_path)) {
                     if (entry.is_regular_file() && entry.path().extension() == ".kang") {
-                        fs::path out_file = output_path / entry.path().filename().replace_extension(".safetensors");
-                        handle_decompression(entry.path(), out_file);
+                        const char* extension = is_gguf_archive(entry.path()) ? ".gguf" : ".safetensors";
+                        fs::path out_file = output_path / entry.path().filename().replace_extension(extension);
+                        handle_decompression(entry.path(), out_file, dict_path);
                         count++;
                     }
                 }
@@ -254,16 +1031,33 @@ int main(int argc, char* argv[]) {
         }
         else if (fs::is_regular_file(input_path)) {
             if (command == "compress") {
-                handle_compression(input_path, output_path, compression_level);
+                if (input_path.extension() == ".gguf" && !tiered) {
+                    std::cerr << "Error: GGUF input needs --profile fast-load, cold or entropy." << std::endl;
+                    return 1;
+                }
+                if (options.partial) handle_compression_part(input_path, output_path, options);
+                else if (tiered) handle_compression_tiered(input_path, output_path, options);
+                else if (options.seekable) handle_compression_seekable(input_path, output_path, options);
+                else if (options.volume_size) handle_compression_volumes(input_path, output_path, options);
+                else if (options.journal) handle_compression_journaled(input_path, output_path, options);
+                else handle_compression(input_path, output_path, options);
             }
             else if (command == "decompress") {
-                handle_decompression(input_path, output_path);
+                fs::path volume_base;
+                if (volume_base_path(input_path, volume_base) && is_part_file(input_path)) {
+                    handle_decompress_volumes(volume_base, output_path, dict_path, wait_seconds);
+                }
+                else handle_decompression(input_path, output_path, dict_path);
             }
             else {
                 print_usage();
                 return 1;
             }
         }
+        else if (command == "decompress" && (wait_seconds > 0 || fs::exists(volume_path_for(input_path, 0)))) {
+            // model.kang  model.kang.000, .001 ...  (--wait ̸  ϳ  ʾҾ )
+            handle_decompress_volumes(input_path, output_path, dict_path, wait_seconds);
+        }
         else {
             std::cerr << "Error: Input path is not a valid file or directory: " << input_path.string() << std::endl;
             return 1;
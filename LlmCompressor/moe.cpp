@@ -0,0 +1,142 @@
+#include "moe.h"
+#include "dtype_kernels.h"
+#include "file_util.h"
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <cmath>
+
+namespace {
+
+// 표본을 width 바이트 원소의 바이트 평면별 order-0 엔트로피 합으로 본 비트 수 (xor_with 가 있으면 XOR 잔차의 비용)
+double plane_cost_bits(const std::vector<char>& sample, const std::vector<char>* xor_with, size_t width)
+{
+    double bits = 0;
+    for (size_t plane = 0; plane < width; ++plane) {
+        uint64_t counts[256] = {};
+        uint64_t total = 0;
+        for (size_t i = plane; i < sample.size(); i += width) {
+            uint8_t v = static_cast<uint8_t>(sample[i]);
+            if (xor_with) v ^= static_cast<uint8_t>((*xor_with)[i]);
+            ++counts[v];
+            ++total;
+        }
+        for (uint64_t c : counts) {
+            if (c == 0) continue;
+            bits -= static_cast<double>(c) * std::log2(static_cast<double>(c) / static_cast<double>(total));
+        }
+    }
+    return bits;
+}
+
+} // namespace
+
+std::string expert_group_key(const std::string& name)
+{
+    std::string key;
+    bool after_experts = false;
+    bool found = false;
+    size_t begin = 0;
+    while (begin <= name.size()) {
+        size_t end = name.find('.', begin);
+        if (end == std::string::npos) end = name.size();
+        const std::string part = name.substr(begin, end - begin);
+        const bool numeric = !part.empty() &&
+            std::all_of(part.begin(), part.end(), [](char c) { return c >= '0' && c <= '9'; });
+        if (begin > 0) key += '.';
+        if (after_experts && numeric) {
+            key += '#';
+            found = true;
+        } else {
+            key += part;
+        }
+        after_experts = part == "experts";
+        begin = end + 1;
+    }
+    return found ? key : std::string();
+}
+
+bool plan_expert_deltas(std::FILE* in, uint64_t data_offset, const std::vector<TensorInfo>& tensors, uint64_t min_size,
+                        std::vector<ExpertDelta>& deltas, size_t& clusters)
+{
+    deltas.clear();
+    clusters = 0;
+
+    // 1. (묶음 키, dtype, shape) 로 전문가 모으기
+    std::map<std::string, std::vector<size_t>> groups;
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        const TensorInfo& t = tensors[i];
+        const DTypeKernels* k = dtype_kernels(t.dtype);
+        if (!k || t.data_end - t.data_begin < min_size) continue;
+        const std::string key = expert_group_key(t.name);
+        if (key.empty()) continue;
+        std::string shape;
+        for (uint64_t d : t.shape) shape += std::to_string(d) + "x";
+        groups[key + "|" + t.dtype + "|" + shape].push_back(i);
+    }
+
+    for (const auto& g : groups) {
+        const std::vector<size_t>& members = g.second;
+        if (members.size() < 2) continue;
+        const size_t width = dtype_kernels(tensors[members[0]].dtype)->width;
+
+        // 2. 모든 전문가의 같은 상대 위치에서 표본 창 읽기 (원소 정렬)
+        const uint64_t size = tensors[members[0]].data_end - tensors[members[0]].data_begin;
+        const uint64_t window = std::min<uint64_t>(KANG_MOE_SAMPLE_WINDOW / width * width, size / width * width);
+        std::vector<std::vector<char>> samples(members.size());
+        for (size_t m = 0; m < members.size(); ++m) {
+            for (size_t w = 0; w < KANG_MOE_SAMPLE_WINDOWS; ++w) {
+                const uint64_t at = (size - window) * w / std::max<size_t>(KANG_MOE_SAMPLE_WINDOWS - 1, 1) / width * width;
+                const size_t pos = samples[m].size();
+                samples[m].resize(pos + static_cast<size_t>(window));
+                if (!file_read_at(in, data_offset + tensors[members[m]].data_begin + at, samples[m].data() + pos,
+                                  static_cast<size_t>(window))) {
+                    std::cerr << "Error: Cannot read expert tensor " << tensors[members[m]].name << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        // 3. 이득 행렬: gain[a][r] = 자체 비용 - r 과의 XOR 비용 (KANG_MOE_MIN_GAIN 을 넘지 못하면 0)
+        const size_t n = members.size();
+        std::vector<double> own(n);
+        for (size_t a = 0; a < n; ++a) own[a] = plane_cost_bits(samples[a], nullptr, width);
+        std::vector<std::vector<double>> gain(n, std::vector<double>(n, 0.0));
+        for (size_t a = 0; a < n; ++a) {
+            for (size_t r = a + 1; r < n; ++r) {
+                const double x = plane_cost_bits(samples[a], &samples[r], width); // XOR 은 대칭
+                if (x < KANG_MOE_MIN_GAIN * own[a]) gain[a][r] = own[a] - x;
+                if (x < KANG_MOE_MIN_GAIN * own[r]) gain[r][a] = own[r] - x;
+            }
+        }
+
+        // 4. 탐욕적 묶음: 남은 전문가 중 다른 남은 전문가들에게 주는 이득 합이 가장 큰 것을 참조로 삼고
+        //    이득이 있는 전문가를 붙임. 붙일 것이 없으면 나머지는 그대로 저장
+        std::vector<bool> assigned(n, false);
+        for (;;) {
+            size_t best = n;
+            double best_total = 0;
+            for (size_t r = 0; r < n; ++r) {
+                if (assigned[r]) continue;
+                double total = 0;
+                for (size_t a = 0; a < n; ++a) {
+                    if (!assigned[a] && a != r) total += gain[a][r];
+                }
+                if (total > best_total) {
+                    best_total = total;
+                    best = r;
+                }
+            }
+            if (best == n) break;
+            assigned[best] = true;
+            for (size_t a = 0; a < n; ++a) {
+                if (!assigned[a] && gain[a][best] > 0) {
+                    assigned[a] = true;
+                    deltas.push_back({ members[a], members[best] });
+                }
+            }
+            ++clusters;
+        }
+    }
+    return true;
+}
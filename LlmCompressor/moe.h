@@ -0,0 +1,35 @@
+#ifndef MOE_H
+#define MOE_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "safetensors.h"
+
+// --moe: 전문가 간 XOR 잔차
+// MoE 체크포인트는 층마다 같은 모양의 전문가 FFN (experts.N.w1 ...) 이 수십 개이고, 업사이클한 모델은 같은 밀집 FFN 에서
+// 갈라져 나와 비트 패턴이 많이 겹침. 층/투영마다 전문가를 싼 유사도로 묶어 묶음마다 참조 전문가 하나는 그대로,
+// 나머지는 참조와 XOR 한 잔차를 압축 (상위 바이트가 대부분 0 이 됨). 청크 단위 XOR 이라 해제는 전문가마다 병렬.
+constexpr size_t KANG_MOE_SAMPLE_WINDOWS = 4;          // 전문가마다 고르게 떨어진 표본 창 수
+constexpr size_t KANG_MOE_SAMPLE_WINDOW = 4096;        // 표본 창 크기 (바이트)
+constexpr double KANG_MOE_MIN_GAIN = 0.9;              // XOR 잔차 추정 비용이 자체 비용의 이 비율 미만일 때만 잔차로
+
+// 전문가 텐서 tensor 를 reference 와의 XOR 잔차로 저장 (tensors 인덱스, 두 텐서는 dtype/shape 가 같음)
+struct ExpertDelta {
+    size_t tensor = 0;
+    size_t reference = 0;
+};
+
+// 전문가 묶음 키: 이름의 "experts" 다음 숫자 구성요소를 # 로 바꾼 것 (층 번호는 유지). 전문가가 아니면 빈 문자열
+// "model.layers.3.mlp.experts.17.w1.weight" -> "model.layers.3.mlp.experts.#.w1.weight"
+std::string expert_group_key(const std::string& name);
+
+// 헤더의 이름/모양으로 전문가를 층/투영별로 모으고, 표본 창의 바이트 평면 엔트로피로 XOR 이득을 추정해
+// 탐욕적으로 묶음(참조 + 잔차 전문가들)을 만듦. min_size 보다 작은 전문가는 (솔리드 블록에 들어가므로) 제외
+// clusters 에 만든 묶음 수
+bool plan_expert_deltas(std::FILE* in, uint64_t data_offset, const std::vector<TensorInfo>& tensors, uint64_t min_size,
+                        std::vector<ExpertDelta>& deltas, size_t& clusters);
+
+#endif //MOE_H
@@ -0,0 +1,52 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <filesystem>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 저장 등급 (Default = GPU nvCOMP zstd v1)
+enum class CompressProfile {
+    Default,
+    FastLoad,   // CPU LZ4/LZ4-HC
+    Cold,       // CPU LZMA2
+    Entropy,    // CPU 바이트 분할 + rANS
+};
+
+// compress 명령 옵션
+struct CompressOptions {
+    int level = 10;                       // 압축 레벨 (1-19)
+    bool journal = false;                 // 청크 단위 기록 + 재개 저널
+    bool resume = false;                  // 저널에서 이어서 압축
+    std::filesystem::path dict_path;      // 학습된 zstd 사전 (비어 있으면 사용 안 함)
+    bool embed_dict = false;              // 사전을 아카이브에 포함
+    bool write_index = true;              // .kidx 바이너리 텐서 인덱스 생성
+    bool rsyncable = false;               // 청크 경계를 텐서 경계에 고정 (chunking.h)
+    bool partial = false;                 // 파트 파일 생성 (parts.h)
+    uint64_t range_begin = 0;             // --range 시작 (텐서 데이터 기준)
+    uint64_t range_end = UINT64_MAX;      // --range 끝 (기본: 데이터 끝)
+    uint32_t part_index = 0;              // --part N
+    uint32_t part_count = 0;              // --part N/M 의 M (0 = --range 사용)
+    uint64_t volume_size = 0;             // --volume-size (0 = 단일 파일)
+    bool seekable = false;                // 표준 zstd 프레임 + seekable 시크 테이블 (seekable.h)
+    CompressProfile profile = CompressProfile::Default; // --profile (tiers.h)
+    bool byte_split = false;              // fast-load/cold 청크에 바이트 분할 변환 적용
+    bool solid = false;                   // 작은 텐서를 dtype 별 솔리드 블록으로 (chunking.h)
+    bool reorder = false;                 // 텐서를 (dtype, shape, 이름 역할) 순으로 모아 청크 분할 (chunking.h)
+    bool transpose = false;               // 행렬 청크를 추정으로 골라 열 우선 전치 후 바이트 분할 (solid 포함)
+    bool fpc = false;                     // fp32/fp64 청크를 FPC 예측 코더로 (fpc.h)
+    bool moe = false;                     // 비슷한 전문가를 참조 전문가와의 XOR 잔차로 (moe.h), solid 포함
+    std::vector<std::string> rules;       // --rule 'pattern=codec[:level[:transform]]' (rules.h), solid 포함
+    std::filesystem::path rules_file;     // --rules 파일 (한 줄에 규칙 하나, --rule 보다 먼저 봄)
+};
+
+// transcode 명령 옵션 (-1 = 원본 유지)
+struct TranscodeOptions {
+    int level = -1;                       // 지정 시 레벨이 다른 zstd 청크만 다시 압축
+    int codec = -1;                       // ChunkCodec. 지정 시 코덱이 다른 청크만 다시 압축
+    size_t threads = 1;
+    std::filesystem::path dict_path;      // v1 사전 압축 헤더/작은 파일용
+};
+
+#endif //OPTIONS_H
@@ -0,0 +1,383 @@
+#include "pack.h"
+#include "archive.h"
+#include "compressor.cuh"
+#include "file_util.h"
+#include "parallel.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <set>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct PackInput {
+    fs::path source;
+    std::string name;   // 아카이브 내 경로
+    uint64_t size = 0;
+};
+
+// 압축 작업 하나: 큰 파일 1개 또는 작은 파일 여러 개를 이어 붙인 솔리드 스트림
+struct PackJob {
+    std::vector<size_t> members; // PackInput 번호
+    uint64_t total_size = 0;
+};
+
+// 상대 경로가 출력 디렉터리 밖을 가리키지 않는지 확인
+bool is_safe_relative_path(const std::string& name)
+{
+    fs::path p(name);
+    if (name.empty() || p.is_absolute() || p.has_root_name() || p.has_root_directory()) return false;
+    for (const auto& part : p) {
+        if (part == "..") return false;
+    }
+    return true;
+}
+
+// 작업 하나를 압축해 아카이브에 기록하고, 멤버 파일들의 익스텐트를 채움
+bool compress_pack_job(const PackJob& job, const std::vector<PackInput>& inputs, int compression_level,
+                       std::FILE* out, std::mutex& out_mutex, ArchiveIndex& index)
+{
+    // 입력: 멤버 파일들을 순서대로 읽어 청크 버퍼를 채움 (청크는 순서대로 요청됨)
+    std::vector<char> in_buf;
+    size_t member = 0;
+    uint64_t member_pos = 0;
+    std::FILE* cur = nullptr;
+    bool read_ok = true;
+
+    auto read_chunk = [&](size_t, size_t size) -> const char* {
+        in_buf.resize(size);
+        size_t filled = 0;
+        while (filled < size && member < job.members.size()) {
+            const PackInput& in = inputs[job.members[member]];
+            if (!cur) {
+                cur = file_open(in.source, "rb");
+                if (!cur) {
+                    std::cerr << "Error: Cannot open file " << in.source.string() << std::endl;
+                    read_ok = false;
+                    return nullptr;
+                }
+            }
+            const size_t want = static_cast<size_t>(std::min<uint64_t>(size - filled, in.size - member_pos));
+            if (want > 0 && std::fread(in_buf.data() + filled, 1, want, cur) != want) {
+                std::cerr << "Error: Short read from " << in.source.string() << std::endl;
+                read_ok = false;
+                return nullptr;
+            }
+            filled += want;
+            member_pos += want;
+            if (member_pos == in.size) {
+                std::fclose(cur);
+                cur = nullptr;
+                ++member;
+                member_pos = 0;
+            }
+        }
+        return filled == size ? in_buf.data() : nullptr;
+    };
+
+    // 출력: 완료된 청크를 잠금 하에 아카이브 끝에 붙임
+    std::vector<uint64_t> job_chunks;
+    auto write_chunk = [&](size_t, const char* data, size_t original_size, size_t compressed_size) {
+        std::lock_guard<std::mutex> lock(out_mutex);
+        ArchiveChunk c;
+        c.offset = file_tell(out);
+        c.compressed_size = compressed_size;
+        c.original_size = original_size;
+        c.codec = static_cast<uint8_t>(ChunkCodec::NvcompZstd);
+        c.level = static_cast<int8_t>(NVCOMP_ZSTD_LEVEL);
+        if (std::fwrite(data, 1, compressed_size, out) != compressed_size) return false;
+        job_chunks.push_back(index.chunks.size());
+        index.chunks.push_back(c);
+        return true;
+    };
+
+    bool ok = compress_chunks_streaming(static_cast<size_t>(job.total_size), 0, read_chunk, write_chunk, compression_level);
+    if (cur) std::fclose(cur);
+    if (!ok || !read_ok) return false;
+
+    // 스트림 내 위치 -> (청크, 청크 내 위치) 로 익스텐트 구성
+    std::lock_guard<std::mutex> lock(out_mutex);
+    uint64_t stream_pos = 0;
+    for (size_t m : job.members) {
+        ArchiveFile& af = index.files[m];
+        uint64_t remaining = af.size;
+        uint64_t pos = stream_pos;
+        while (remaining > 0) {
+            const size_t ci = static_cast<size_t>(pos / KANG_CHUNK_SIZE);
+            const uint64_t in_chunk = pos % KANG_CHUNK_SIZE;
+            const uint64_t len = std::min<uint64_t>(remaining, index.chunks[job_chunks[ci]].original_size - in_chunk);
+            af.extents.push_back({ job_chunks[ci], in_chunk, len });
+            pos += len;
+            remaining -= len;
+        }
+        stream_pos += af.size;
+    }
+    return true;
+}
+
+} // namespace
+
+void handle_pack(const fs::path& input_dir, const fs::path& output_path, int compression_level, size_t threads)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Packing " << input_dir.string() << "\n-> to -> " << output_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    // 1. 파일 수집 (출력 파일 자신은 제외)
+    std::vector<PackInput> inputs;
+    std::error_code ec;
+    const fs::path output_abs = fs::weakly_canonical(output_path, ec);
+    for (const auto& entry : fs::recursive_directory_iterator(input_dir)) {
+        if (!entry.is_regular_file()) continue;
+        std::error_code ec2;
+        if (!ec && fs::weakly_canonical(entry.path(), ec2) == output_abs) continue;
+        PackInput in;
+        in.source = entry.path();
+        in.name = fs::relative(entry.path(), input_dir).generic_string();
+        in.size = entry.file_size();
+        inputs.push_back(in);
+    }
+    if (inputs.empty()) {
+        std::cerr << "Error: No files found in " << input_dir.string() << std::endl;
+        return;
+    }
+    std::sort(inputs.begin(), inputs.end(), [](const PackInput& a, const PackInput& b) { return a.name < b.name; });
+
+    // 2. 작은 파일은 확장자별로 모아 솔리드 스트림 하나로, 큰 파일(샤드)은 파일별 작업으로
+    std::vector<size_t> small;
+    std::vector<PackJob> jobs;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs[i].size < KANG_SOLID_THRESHOLD) {
+            small.push_back(i);
+        } else {
+            PackJob job;
+            job.members.push_back(i);
+            job.total_size = inputs[i].size;
+            jobs.push_back(job);
+        }
+    }
+    std::stable_sort(small.begin(), small.end(), [&](size_t a, size_t b) {
+        return fs::path(inputs[a].name).extension() < fs::path(inputs[b].name).extension();
+    });
+    if (!small.empty()) {
+        PackJob solid;
+        solid.members = small;
+        for (size_t i : small) solid.total_size += inputs[i].size;
+        jobs.push_back(solid);
+    }
+    // 큰 작업부터 배분 (스레드 간 균형)
+    std::sort(jobs.begin(), jobs.end(), [](const PackJob& a, const PackJob& b) { return a.total_size > b.total_size; });
+
+    std::cout << inputs.size() << " files: " << (inputs.size() - small.size()) << " chunked, "
+              << small.size() << " solid-compressed together." << std::endl;
+
+    // 3. 작업 병렬 압축 (작업마다 독립 GPU 스트림), 청크는 끝나는 순서대로 기록
+    std::FILE* out = file_open(output_path, "wb");
+    if (!out || !write_v2_signature(out)) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        if (out) std::fclose(out);
+        return;
+    }
+
+    ArchiveIndex index;
+    index.files.resize(inputs.size());
+    uint64_t total_input = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        index.files[i].path = inputs[i].name;
+        index.files[i].size = inputs[i].size;
+        total_input += inputs[i].size;
+    }
+
+    std::mutex out_mutex;
+    std::atomic<bool> failed{ false };
+    parallel_for(jobs.size(), threads, [&](size_t j) {
+        if (failed) return;
+        if (!compress_pack_job(jobs[j], inputs, compression_level, out, out_mutex, index)) failed = true;
+    });
+
+    bool ok = !failed && write_archive_index(out, index);
+    const uint64_t archive_size = file_tell(out);
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Packing failed." << std::endl;
+        fs::remove(output_path, ec);
+        return;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Packed " << inputs.size() << " files: " << total_input << " -> " << archive_size
+              << " bytes (" << index.chunks.size() << " chunks)" << std::endl;
+    std::cout << "Packing successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+void handle_unpack(const fs::path& input_path, const fs::path& output_dir,
+                   const std::vector<std::string>& files, size_t threads)
+{
+    std::cout << "----------------------------------------------------" << std::endl;
+    std::cout << "Unpacking " << input_path.string() << "\n-> to ->   " << output_dir.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::FILE* in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open input file " << input_path.string() << std::endl;
+        return;
+    }
+    ArchiveIndex index;
+    bool ok = read_archive_index(in, index);
+    std::fclose(in);
+    if (!ok) return;
+
+    // 1. 추출 대상 선택
+    std::vector<size_t> selected;
+    if (files.empty()) {
+        for (size_t i = 0; i < index.files.size(); ++i) selected.push_back(i);
+    } else {
+        for (const auto& name : files) {
+            auto it = std::find_if(index.files.begin(), index.files.end(),
+                                   [&](const ArchiveFile& f) { return f.path == name; });
+            if (it == index.files.end()) {
+                std::cerr << "Error: File not found in archive: " << name << std::endl;
+                return;
+            }
+            selected.push_back(static_cast<size_t>(it - index.files.begin()));
+        }
+    }
+
+    std::vector<fs::path> out_paths(index.files.size());
+    uint64_t total_output = 0;
+    for (size_t fi : selected) {
+        const ArchiveFile& af = index.files[fi];
+        if (!is_safe_relative_path(af.path)) {
+            std::cerr << "Error: Unsafe path in archive, refusing to extract: " << af.path << std::endl;
+            return;
+        }
+        out_paths[fi] = output_dir / fs::path(af.path);
+        fs::create_directories(out_paths[fi].parent_path());
+        total_output += af.size;
+    }
+
+    size_t decoded = 0;
+    if (!extract_archive_files(input_path, index, selected, out_paths, threads, decoded)) {
+        std::cerr << "Unpacking failed." << std::endl;
+        return;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Extracted " << selected.size() << " files (" << total_output << " bytes, "
+              << decoded << " of " << index.chunks.size() << " chunks decoded)" << std::endl;
+    std::cout << "Unpacking successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+bool extract_archive_files(const fs::path& input_path, const ArchiveIndex& index,
+                           const std::vector<size_t>& selected, const std::vector<fs::path>& out_paths,
+                           size_t threads, size_t& chunks_decoded)
+{
+    // 1. 출력 파일 미리 할당 + 청크별로 써야 할 조각 정리
+    struct Piece {
+        size_t file;
+        uint64_t file_offset;
+        uint64_t chunk_offset;
+        uint64_t length;
+    };
+    std::vector<std::vector<Piece>> pieces(index.chunks.size());
+    for (size_t fi : selected) {
+        const ArchiveFile& af = index.files[fi];
+        std::FILE* created = file_open(out_paths[fi], "wb");
+        if (!created) {
+            std::cerr << "Error: Cannot create output file " << out_paths[fi].string() << std::endl;
+            return false;
+        }
+        std::fclose(created);
+        fs::resize_file(out_paths[fi], af.size);
+
+        uint64_t file_offset = 0;
+        for (const auto& e : af.extents) {
+            if (e.chunk >= index.chunks.size() || e.chunk_offset + e.length > index.chunks[e.chunk].original_size) {
+                std::cerr << "Error: Archive index is corrupted (bad extent)." << std::endl;
+                return false;
+            }
+            pieces[e.chunk].push_back({ fi, file_offset, e.chunk_offset, e.length });
+            file_offset += e.length;
+        }
+    }
+    std::vector<size_t> needed;
+    for (size_t c = 0; c < pieces.size(); ++c) {
+        if (!pieces[c].empty()) needed.push_back(c);
+    }
+    chunks_decoded = needed.size();
+
+    // 2. 필요한 청크만 병렬 해제해 각 파일 위치에 기록 (워커마다 GPU 스트림/파일 핸들 분리)
+    const size_t batch = 8;
+    const size_t num_batches = (needed.size() + batch - 1) / batch;
+    std::atomic<bool> failed{ false };
+    parallel_for(num_batches, threads, [&](size_t b) {
+        if (failed) return;
+        std::FILE* f = file_open(input_path, "rb");
+        if (!f) { failed = true; return; }
+        std::vector<size_t> ids(needed.begin() + b * batch,
+                                needed.begin() + std::min(needed.size(), (b + 1) * batch));
+        bool ok = decode_archive_chunks(f, index, ids, [&](size_t chunk, const char* data, size_t) {
+            // 솔리드 블록은 한 파일에 조각이 많으므로 같은 파일 조각이 이어지는 동안 핸들을 재사용
+            const auto& list = pieces[chunk];
+            for (size_t i = 0; i < list.size();) {
+                const size_t file = list[i].file;
+                std::FILE* of = file_open(out_paths[file], "r+b");
+                bool w = of != nullptr;
+                for (; i < list.size() && list[i].file == file; ++i) {
+                    const Piece& p = list[i];
+                    w = w && file_seek(of, p.file_offset) &&
+                        std::fwrite(data + p.chunk_offset, 1, static_cast<size_t>(p.length), of) == p.length;
+                }
+                if (of) w = (std::fclose(of) == 0) && w;
+                if (!w) {
+                    std::cerr << "Error: Cannot write " << out_paths[file].string() << std::endl;
+                    return false;
+                }
+            }
+            return true;
+        });
+        std::fclose(f);
+        if (!ok) failed = true;
+    });
+    return !failed;
+}
+
+void handle_list(const fs::path& input_path)
+{
+    std::FILE* in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open input file " << input_path.string() << std::endl;
+        return;
+    }
+    ArchiveIndex index;
+    bool ok = read_archive_index(in, index);
+    std::fclose(in);
+    if (!ok) return;
+
+    // 청크를 여러 파일이 공유하면 솔리드 블록
+    std::vector<size_t> users(index.chunks.size(), 0);
+    for (const auto& f : index.files) {
+        std::set<uint64_t> seen;
+        for (const auto& e : f.extents) {
+            if (e.chunk < users.size() && seen.insert(e.chunk).second) ++users[e.chunk];
+        }
+    }
+    uint64_t total = 0;
+    for (const auto& f : index.files) {
+        bool solid = false;
+        std::set<uint64_t> chunks;
+        for (const auto& e : f.extents) {
+            chunks.insert(e.chunk);
+            if (e.chunk < users.size() && users[e.chunk] > 1) solid = true;
+        }
+        std::cout << f.size << "\t" << chunks.size() << (solid ? " chunk(s), solid\t" : " chunk(s)\t") << f.path << std::endl;
+        total += f.size;
+    }
+    std::cout << index.files.size() << " files, " << total << " bytes, " << index.chunks.size() << " chunks" << std::endl;
+}
@@ -0,0 +1,29 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct ArchiveIndex;
+
+// 이 크기 미만 파일은 한 스트림으로 이어 붙여 솔리드 압축 (config/tokenizer/어댑터 등)
+constexpr unsigned long long KANG_SOLID_THRESHOLD = 1024ULL * 1024ULL * 16ULL; // 16MB
+
+// 모델 저장소 디렉터리 전체를 v2 아카이브 하나로 묶음
+void handle_pack(const std::filesystem::path& input_dir, const std::filesystem::path& output_path,
+                 int compression_level, size_t threads);
+
+// 아카이브 풀기. files 가 비어 있지 않으면 해당 파일만 추출
+void handle_unpack(const std::filesystem::path& input_path, const std::filesystem::path& output_dir,
+                   const std::vector<std::string>& files, size_t threads);
+
+// 선택한 파일들을 out_paths[파일 번호] 로 추출 (필요한 청크만 병렬 해제)
+bool extract_archive_files(const std::filesystem::path& input_path, const ArchiveIndex& index,
+                           const std::vector<size_t>& selected, const std::vector<std::filesystem::path>& out_paths,
+                           size_t threads, size_t& chunks_decoded);
+
+// 아카이브 파일 목록 출력
+void handle_list(const std::filesystem::path& input_path);
+
+#endif //PACK_H
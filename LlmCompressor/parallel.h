@@ -0,0 +1,41 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+
+// 기본 작업 스레드 수
+inline size_t default_thread_count()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 4;
+}
+
+// 작업 count 개를 threads 개 스레드로 처리 (작업 단위 동적 분배, fn 은 예외를 던지지 않아야 함)
+inline void parallel_for(size_t count, size_t threads, const std::function<void(size_t)>& fn)
+{
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    std::atomic<size_t> next{ 0 };
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&]() {
+            for (;;) {
+                size_t i = next.fetch_add(1);
+                if (i >= count) break;
+                fn(i);
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+}
+
+#endif //PARALLEL_H
@@ -0,0 +1,665 @@
+#include "parts.h"
+#include "compressor.cuh"
+#include "file_util.h"
+#include "kang_format.h"
+#include "dictionary.h"
+#include "tensor_index.h"
+#include "chunking.h"
+#include "safetensors.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include "parallel.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 병합용으로 읽어 둔 파트 정보
+struct PartInfo {
+    fs::path path;
+    PartHeader header{};
+    std::vector<char> compressed_header;
+    std::vector<std::pair<uint64_t, uint64_t>> chunk_info; // <원본, 압축>
+    uint64_t payload_offset = 0;
+    uint64_t payload_size = 0;
+};
+
+// report_errors = false: 전송 중인 볼륨처럼 아직 불완전할 수 있는 파일을 조용히 확인
+bool read_part(const fs::path& path, PartInfo& part, bool report_errors = true)
+{
+    part = PartInfo();
+    part.path = path;
+    std::FILE* f = file_open(path, "rb");
+    if (!f) {
+        if (report_errors) std::cerr << "Error: Cannot open part " << path.string() << std::endl;
+        return false;
+    }
+    PartHeader& h = part.header;
+    bool ok = std::fread(&h, sizeof(h), 1, f) == 1 &&
+              std::string(h.signature, h.signature + 8) == KANG_PART_SIGNATURE;
+    if (!ok || h.version != KANG_PART_VERSION) {
+        std::fclose(f);
+        if (report_errors) std::cerr << "Error: " << path.string() << " is not a kang part file." << std::endl;
+        return false;
+    }
+    std::error_code ec;
+    const uint64_t file_size = fs::file_size(path, ec);
+    ok = !ec && h.range_begin <= h.range_end && h.range_end <= h.data_size &&
+         h.num_chunks <= file_size / KANG_CHUNK_ENTRY_SIZE && h.compressed_header_size <= file_size &&
+         sizeof(h) + h.compressed_header_size + h.num_chunks * KANG_CHUNK_ENTRY_SIZE <= h.payload_offset &&
+         h.payload_offset <= file_size;
+    if (ok) {
+        part.compressed_header.resize(static_cast<size_t>(h.compressed_header_size));
+        ok = part.compressed_header.empty() ||
+             std::fread(part.compressed_header.data(), 1, part.compressed_header.size(), f) == part.compressed_header.size();
+    }
+    uint64_t original_total = 0;
+    for (uint64_t i = 0; i < h.num_chunks && ok; ++i) {
+        uint64_t orig = 0, comp = 0;
+        ok = file_read_u64(f, orig) && file_read_u64(f, comp) && orig != 0 && comp != 0;
+        part.chunk_info.emplace_back(orig, comp);
+        original_total += orig;
+        part.payload_size += comp;
+    }
+    std::fclose(f);
+    part.payload_offset = h.payload_offset;
+    if (!ok || original_total != h.range_end - h.range_begin || part.payload_offset + part.payload_size != file_size) {
+        if (report_errors) std::cerr << "Error: Part " << path.string() << " is truncated or corrupted." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 파트 페이로드를 그대로 복사 (재압축 없음)
+bool copy_payload(const PartInfo& part, std::FILE* out)
+{
+    std::FILE* f = file_open(part.path, "rb");
+    if (!f) return false;
+    std::vector<char> buf(8 * 1024 * 1024);
+    uint64_t pos = part.payload_offset;
+    uint64_t left = part.payload_size;
+    bool ok = true;
+    while (left > 0 && ok) {
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(left, buf.size()));
+        ok = file_read_at(f, pos, buf.data(), n) && std::fwrite(buf.data(), 1, n, out) == n;
+        pos += n;
+        left -= n;
+    }
+    std::fclose(f);
+    return ok;
+}
+
+// 입력 헤더를 읽고 단일 압축과 같은 청크 계획(고정 또는 텐서 경계)을 세움
+bool open_input_with_plan(const fs::path& input_path, const CompressOptions& options, std::FILE*& in,
+                          uint64_t& input_size, std::string& json_header, uint64_t& data_offset,
+                          std::vector<size_t>& plan)
+{
+    in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open file " << input_path.string() << std::endl;
+        return false;
+    }
+    input_size = fs::file_size(input_path);
+    if (!read_safetensors_header(in, input_size, json_header, data_offset)) {
+        std::fclose(in);
+        return false;
+    }
+    const uint64_t data_size = input_size - data_offset;
+    plan = fixed_chunk_plan(static_cast<size_t>(data_size));
+    if (options.rsyncable) {
+        std::vector<TensorInfo> tensors;
+        if (!parse_safetensors_header(json_header, tensors)) {
+            std::fclose(in);
+            return false;
+        }
+        plan = plan_tensor_aligned_chunks(tensors, data_size);
+    }
+    return true;
+}
+
+PartHeader make_part_header(const std::string& json_header, uint64_t input_size, uint64_t data_size,
+                            const std::vector<char>& compressed_header)
+{
+    PartHeader ph{};
+    std::memcpy(ph.signature, KANG_PART_SIGNATURE.data(), sizeof(ph.signature));
+    ph.version = KANG_PART_VERSION;
+    ph.input_size = input_size;
+    ph.header_hash = fnv1a64(json_header.data(), json_header.size());
+    ph.data_size = data_size;
+    ph.compressed_header_size = compressed_header.size();
+    return ph;
+}
+
+} // namespace
+
+void handle_compression_part(const fs::path& input_path, const fs::path& output_path, const CompressOptions& options)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Compressing " << input_path.string() << "\n-> to ->    " << output_path.string()
+              << " (part " << options.part_index;
+    if (options.part_count > 0) std::cout << "/" << options.part_count;
+    std::cout << ")" << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    // 1. 단일 압축과 같은 청크 계획을 세우고 이 파트의 구간을 정함
+    std::FILE* in = nullptr;
+    uint64_t input_size = 0, data_offset = 0;
+    std::string json_header;
+    std::vector<size_t> full_plan;
+    if (!open_input_with_plan(input_path, options, in, input_size, json_header, data_offset, full_plan)) return;
+    const uint64_t data_size = input_size - data_offset;
+    std::vector<uint64_t> full_start(full_plan.size() + 1, 0);
+    for (size_t i = 0; i < full_plan.size(); ++i) full_start[i + 1] = full_start[i] + full_plan[i];
+
+    uint64_t range_begin = options.range_begin;
+    uint64_t range_end = std::min(options.range_end, data_size);
+    if (options.part_count > 0) {
+        if (options.part_index >= options.part_count) {
+            std::cerr << "Error: Part index must be less than the part count." << std::endl;
+            std::fclose(in);
+            return;
+        }
+        const size_t n = full_plan.size();
+        range_begin = full_start[n * options.part_index / options.part_count];
+        range_end = full_start[n * (options.part_index + 1) / options.part_count];
+    }
+    if (range_begin > range_end) {
+        std::cerr << "Error: Range " << range_begin << ":" << range_end << " is outside the tensor data ("
+                  << data_size << " bytes)." << std::endl;
+        std::fclose(in);
+        return;
+    }
+
+    // 구간 양끝이 전체 계획의 청크 경계면 그 청크들을 그대로 사용 (병합 결과가 단일 압축과 동일)
+    std::vector<size_t> chunk_plan;
+    auto b = std::lower_bound(full_start.begin(), full_start.end(), range_begin);
+    auto e = std::lower_bound(full_start.begin(), full_start.end(), range_end);
+    if (b != full_start.end() && *b == range_begin && e != full_start.end() && *e == range_end) {
+        chunk_plan.assign(full_plan.begin() + (b - full_start.begin()), full_plan.begin() + (e - full_start.begin()));
+    } else {
+        chunk_plan = fixed_chunk_plan(static_cast<size_t>(range_end - range_begin));
+        std::cout << "Note: Range is not on chunk boundaries; merged output will differ from a single-process run." << std::endl;
+    }
+    std::vector<uint64_t> chunk_start(chunk_plan.size() + 1, range_begin);
+    for (size_t i = 0; i < chunk_plan.size(); ++i) chunk_start[i + 1] = chunk_start[i] + chunk_plan[i];
+
+    // 2. 파트 헤더 + 압축 JSON 헤더 + 빈 청크 테이블 기록
+    std::vector<char> compressed_header;
+    if (!compress_header_blob(json_header, options, compressed_header)) {
+        std::cerr << "Compression failed." << std::endl;
+        std::fclose(in);
+        return;
+    }
+    PartHeader ph = make_part_header(json_header, input_size, data_size, compressed_header);
+    ph.part_index = options.part_index;
+    ph.range_begin = range_begin;
+    ph.range_end = range_end;
+    ph.num_chunks = chunk_plan.size();
+    ph.payload_offset = sizeof(ph) + compressed_header.size() + ph.num_chunks * KANG_CHUNK_ENTRY_SIZE;
+
+    std::FILE* out = file_open(output_path, "wb");
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        std::fclose(in);
+        return;
+    }
+    bool ok = std::fwrite(&ph, sizeof(ph), 1, out) == 1 &&
+              (compressed_header.empty() ||
+               std::fwrite(compressed_header.data(), 1, compressed_header.size(), out) == compressed_header.size());
+    for (uint64_t i = 0; i < ph.num_chunks * 2 && ok; ++i) {
+        ok = file_write_u64(out, 0); // 완료 시 채움
+    }
+
+    // 3. 구간 스트리밍 압축
+    std::vector<char> host_in_buf;
+    std::vector<std::pair<uint64_t, uint64_t>> chunk_info;
+    uint64_t compressed_total = 0;
+    ok = ok && compress_chunks_streaming(
+        chunk_plan, 0,
+        [&](size_t chunk_index, size_t size) -> const char* {
+            host_in_buf.resize(size);
+            if (!file_read_at(in, data_offset + chunk_start[chunk_index], host_in_buf.data(), size)) return nullptr;
+            return host_in_buf.data();
+        },
+        [&](size_t, const char* data, size_t original_size, size_t compressed_size) {
+            if (std::fwrite(data, 1, compressed_size, out) != compressed_size) return false;
+            chunk_info.emplace_back(original_size, compressed_size);
+            compressed_total += compressed_size;
+            return true;
+        },
+        options.level);
+    std::fclose(in);
+
+    ok = ok && chunk_info.size() == chunk_plan.size() && file_seek(out, sizeof(ph) + compressed_header.size());
+    for (const auto& c : chunk_info) {
+        ok = ok && file_write_u64(out, c.first) && file_write_u64(out, c.second);
+    }
+    ok = ok && std::fflush(out) == 0;
+    std::fclose(out);
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(output_path, ec);
+        std::cerr << "Compression failed." << std::endl;
+        return;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Tensor data range " << range_begin << ":" << range_end << " compressed (GPU): "
+              << (range_end - range_begin) << " -> " << compressed_total << " bytes in " << chunk_info.size()
+              << " chunks" << std::endl;
+    std::cout << "Compression successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+bool is_part_file(const fs::path& path)
+{
+    std::FILE* f = file_open(path, "rb");
+    if (!f) return false;
+    char sig[8];
+    bool ok = std::fread(sig, 1, sizeof(sig), f) == sizeof(sig) &&
+              std::string(sig, sig + 8) == KANG_PART_SIGNATURE;
+    std::fclose(f);
+    return ok;
+}
+
+bool volume_base_path(const fs::path& volume_path, fs::path& base)
+{
+    const std::string ext = volume_path.extension().string();
+    if (ext.size() < 4 || !std::all_of(ext.begin() + 1, ext.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    base = volume_path.parent_path() / volume_path.stem();
+    return true;
+}
+
+fs::path volume_path_for(const fs::path& base, size_t index)
+{
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%03zu", index);
+    fs::path p = base;
+    p += suffix;
+    return p;
+}
+
+void handle_compression_volumes(const fs::path& input_path, const fs::path& output_path, const CompressOptions& options)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Compressing " << input_path.string() << "\n-> to ->    " << volume_path_for(output_path, 0).string()
+              << " ... (volumes of at most " << options.volume_size << " bytes)" << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::FILE* in = nullptr;
+    uint64_t input_size = 0, data_offset = 0;
+    std::string json_header;
+    std::vector<size_t> chunk_plan;
+    if (!open_input_with_plan(input_path, options, in, input_size, json_header, data_offset, chunk_plan)) return;
+    const uint64_t data_size = input_size - data_offset;
+    std::vector<uint64_t> chunk_start(chunk_plan.size() + 1, 0);
+    for (size_t i = 0; i < chunk_plan.size(); ++i) chunk_start[i + 1] = chunk_start[i] + chunk_plan[i];
+
+    // 볼륨마다 헤더를 포함해 단독으로 풀 수 있게 함
+    std::vector<char> compressed_header;
+    if (!compress_header_blob(json_header, options, compressed_header)) {
+        std::cerr << "Compression failed." << std::endl;
+        std::fclose(in);
+        return;
+    }
+    const PartHeader base_header = make_part_header(json_header, input_size, data_size, compressed_header);
+
+    // 현재 볼륨 상태. 청크 수는 압축이 끝나야 알 수 있으므로 남은 청크 전부를 담을 테이블 자리를 예약
+    // (64MB 청크당 16바이트라 100GB 모델도 볼륨당 수십 KB)
+    std::FILE* vol = nullptr;
+    PartHeader ph = base_header;
+    std::vector<std::pair<uint64_t, uint64_t>> vol_chunks;
+    uint64_t vol_payload = 0;
+    size_t num_volumes = 0;
+    uint64_t compressed_total = 0;
+
+    auto open_volume = [&](size_t first_chunk) {
+        ph = base_header;
+        ph.part_index = static_cast<uint32_t>(num_volumes);
+        ph.range_begin = chunk_start[first_chunk];
+        ph.payload_offset = sizeof(ph) + compressed_header.size() +
+                            (chunk_plan.size() - first_chunk) * KANG_CHUNK_ENTRY_SIZE;
+        vol_chunks.clear();
+        vol_payload = 0;
+        const fs::path path = volume_path_for(output_path, num_volumes++);
+        vol = file_open(path, "wb");
+        if (!vol) {
+            std::cerr << "Error: Cannot create output file " << path.string() << std::endl;
+            return false;
+        }
+        bool ok = std::fwrite(&ph, sizeof(ph), 1, vol) == 1 &&
+                  (compressed_header.empty() ||
+                   std::fwrite(compressed_header.data(), 1, compressed_header.size(), vol) == compressed_header.size());
+        for (uint64_t i = 0; i < (chunk_plan.size() - first_chunk) * 2 && ok; ++i) {
+            ok = file_write_u64(vol, 0); // 닫을 때 채움
+        }
+        return ok;
+    };
+    auto close_volume = [&]() {
+        ph.num_chunks = vol_chunks.size();
+        ph.range_end = ph.range_begin;
+        for (const auto& c : vol_chunks) ph.range_end += c.first;
+        bool ok = file_seek(vol, 0) && std::fwrite(&ph, sizeof(ph), 1, vol) == 1 &&
+                  file_seek(vol, sizeof(ph) + compressed_header.size());
+        for (const auto& c : vol_chunks) {
+            ok = ok && file_write_u64(vol, c.first) && file_write_u64(vol, c.second);
+        }
+        ok = ok && std::fflush(vol) == 0;
+        std::fclose(vol);
+        vol = nullptr;
+        return ok;
+    };
+
+    std::vector<char> host_in_buf;
+    bool ok = open_volume(0);
+    ok = ok && compress_chunks_streaming(
+        chunk_plan, 0,
+        [&](size_t chunk_index, size_t size) -> const char* {
+            host_in_buf.resize(size);
+            if (!file_read_at(in, data_offset + chunk_start[chunk_index], host_in_buf.data(), size)) return nullptr;
+            return host_in_buf.data();
+        },
+        [&](size_t chunk_index, const char* data, size_t original_size, size_t compressed_size) {
+            // 청크 경계에서만 다음 볼륨으로 넘어감
+            if (!vol_chunks.empty() && ph.payload_offset + vol_payload + compressed_size > options.volume_size) {
+                if (!close_volume() || !open_volume(chunk_index)) return false;
+            }
+            if (ph.payload_offset + compressed_size > options.volume_size) {
+                std::cerr << "Error: Chunk " << chunk_index << " (" << compressed_size << " bytes compressed) does not fit "
+                          << "in a volume of " << options.volume_size << " bytes, use a larger --volume-size." << std::endl;
+                return false;
+            }
+            if (std::fwrite(data, 1, compressed_size, vol) != compressed_size) return false;
+            vol_chunks.emplace_back(original_size, compressed_size);
+            vol_payload += compressed_size;
+            compressed_total += compressed_size;
+            return true;
+        },
+        options.level);
+    std::fclose(in);
+    if (vol) ok = close_volume() && ok;
+
+    if (!ok) {
+        std::error_code ec;
+        for (size_t i = 0; i < num_volumes; ++i) fs::remove(volume_path_for(output_path, i), ec);
+        std::cerr << "Compression failed." << std::endl;
+        return;
+    }
+    if (options.write_index) {
+        // 청크 배치는 볼륨마다 다르므로 텐서 목록만 기록
+        write_tensor_index_file(json_header, data_size, tensor_index_path_for(output_path));
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Tensor data compressed (GPU): " << data_size << " -> " << compressed_total << " bytes in "
+              << num_volumes << " volumes" << std::endl;
+    std::cout << "Compression successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+namespace {
+
+// 볼륨 하나를 풀어 출력의 자기 구간에 기록 (작업 스레드마다 파일을 따로 엶)
+bool decode_volume(const PartInfo& part, const fs::path& output_path, uint64_t data_offset)
+{
+    std::FILE* in = file_open(part.path, "rb");
+    std::FILE* out = file_open(output_path, "r+b");
+    bool ok = in && out;
+    std::vector<uint64_t> comp_pos(part.chunk_info.size(), part.payload_offset);
+    std::vector<uint64_t> out_pos(part.chunk_info.size(), data_offset + part.header.range_begin);
+    for (size_t k = 1; k < part.chunk_info.size(); ++k) {
+        comp_pos[k] = comp_pos[k - 1] + part.chunk_info[k - 1].second;
+        out_pos[k] = out_pos[k - 1] + part.chunk_info[k - 1].first;
+    }
+    std::vector<char> comp_buf;
+    ok = ok && decompress_chunks_streaming(
+        part.chunk_info.size(),
+        [&](size_t k, size_t& compressed_size, size_t& original_size) -> const char* {
+            comp_buf.resize(static_cast<size_t>(part.chunk_info[k].second));
+            if (!file_read_at(in, comp_pos[k], comp_buf.data(), comp_buf.size())) return nullptr;
+            compressed_size = comp_buf.size();
+            original_size = static_cast<size_t>(part.chunk_info[k].first);
+            return comp_buf.data();
+        },
+        [&](size_t k, const char* data, size_t size) {
+            return size == part.chunk_info[k].first && file_seek(out, out_pos[k]) &&
+                   std::fwrite(data, 1, size, out) == size;
+        });
+    ok = ok && std::fflush(out) == 0;
+    if (in) std::fclose(in);
+    if (out) std::fclose(out);
+    return ok;
+}
+
+} // namespace
+
+void handle_decompress_volumes(const fs::path& base, const fs::path& output_path, const fs::path& dict_path,
+                               unsigned wait_seconds)
+{
+    std::cout << "----------------------------------------------------" << std::endl;
+    std::cout << "Decompressing " << volume_path_for(base, 0).string() << " ... (volumes)\n-> to ->      "
+              << output_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    const fs::path dir = base.parent_path().empty() ? fs::path(".") : base.parent_path();
+    std::vector<fs::path> done;
+    std::vector<std::pair<uint64_t, uint64_t>> covered;
+    PartHeader first{};
+    bool header_ready = false;
+    uint64_t data_offset = 0, bytes_done = 0;
+    unsigned waited = 0;
+
+    auto fail = [&](const char* message) {
+        if (message) std::cerr << message << std::endl;
+        if (header_ready) {
+            std::error_code ec;
+            fs::remove(output_path, ec);
+        }
+        std::cerr << "Decompression failed." << std::endl;
+    };
+
+    for (;;) {
+        // 1. 새로 도착한 완전한 볼륨 수집 (전송 중인 파일은 다음 검사로 미룸)
+        std::vector<PartInfo> ready;
+        std::vector<fs::path> incomplete;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            fs::path entry_base;
+            if (!entry.is_regular_file() || !volume_base_path(entry.path(), entry_base) ||
+                entry_base.filename() != base.filename() ||
+                std::find(done.begin(), done.end(), entry.path()) != done.end()) {
+                continue;
+            }
+            PartInfo part;
+            if (read_part(entry.path(), part, false)) ready.push_back(std::move(part));
+            else incomplete.push_back(entry.path());
+        }
+
+        if (!header_ready && !ready.empty()) first = ready.front().header;
+        for (const auto& part : ready) {
+            const PartHeader& h = part.header;
+            if (h.input_size != first.input_size || h.header_hash != first.header_hash || h.data_size != first.data_size) {
+                std::cerr << "Error: " << part.path.string() << " belongs to a different model." << std::endl;
+                return fail(nullptr);
+            }
+            for (const auto& c : covered) {
+                if (h.range_begin < c.second && c.first < h.range_end) {
+                    std::cerr << "Error: " << part.path.string() << " overlaps another volume." << std::endl;
+                    return fail(nullptr);
+                }
+            }
+            if (h.range_begin < h.range_end) covered.emplace_back(h.range_begin, h.range_end);
+        }
+
+        // 2. 첫 볼륨의 헤더로 출력을 만들고 전체 크기로 미리 할당
+        if (!header_ready && !ready.empty()) {
+            std::string json_header;
+            ZstdDictionary dict;
+            if (!decompress_header_blob(ready.front().compressed_header, base, dict_path, json_header, dict)) {
+                return fail(nullptr);
+            }
+            if (fnv1a64(json_header.data(), json_header.size()) != first.header_hash ||
+                8 + json_header.size() + first.data_size != first.input_size) {
+                return fail("Error: Volume header does not match its checksum.");
+            }
+            std::FILE* out = file_open(output_path, "wb");
+            const uint64_t header_len = json_header.size();
+            bool ok = out && file_write_u64(out, header_len) &&
+                      std::fwrite(json_header.data(), 1, json_header.size(), out) == json_header.size();
+            if (out) std::fclose(out);
+            header_ready = true;
+            fs::resize_file(output_path, first.input_size, ec);
+            if (!ok || ec) return fail("Error: Cannot create the output file.");
+            data_offset = 8 + header_len;
+        }
+
+        // 3. 도착한 볼륨들을 병렬로 해제
+        std::vector<char> results(ready.size(), 0);
+        parallel_for(ready.size(), default_thread_count(), [&](size_t i) {
+            results[i] = decode_volume(ready[i], output_path, data_offset) ? 1 : 0;
+        });
+        for (size_t i = 0; i < ready.size(); ++i) {
+            if (!results[i]) {
+                std::cerr << "Error: Cannot decode " << ready[i].path.string() << std::endl;
+                return fail(nullptr);
+            }
+            std::cout << "Volume " << ready[i].path.filename().string() << ": bytes " << ready[i].header.range_begin
+                      << ":" << ready[i].header.range_end << " decoded" << std::endl;
+            done.push_back(ready[i].path);
+            bytes_done += ready[i].header.range_end - ready[i].header.range_begin;
+        }
+        if (header_ready && bytes_done == first.data_size) break;
+
+        // 4. 남은 구간이 있으면 새 볼륨을 기다림 (wait_seconds 는 마지막 진행 이후 기준)
+        if (!ready.empty()) waited = 0;
+        else {
+            if (waited >= wait_seconds) {
+                for (const auto& p : incomplete) {
+                    PartInfo part;
+                    read_part(p, part, true); // 불완전/손상 사유 출력
+                }
+                std::sort(covered.begin(), covered.end());
+                uint64_t pos = 0;
+                for (const auto& c : covered) {
+                    if (c.first > pos) std::cerr << "Missing tensor data bytes " << pos << ":" << c.first << std::endl;
+                    pos = c.second;
+                }
+                if (!header_ready) std::cerr << "Error: No complete volume " << base.string() << ".NNN found." << std::endl;
+                else if (pos < first.data_size) std::cerr << "Missing tensor data bytes " << pos << ":" << first.data_size << std::endl;
+                return fail(wait_seconds ? "Error: Volumes still missing after waiting." : "Error: Volumes are missing (use --wait to wait for them).");
+            }
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            ++waited;
+        }
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Decompressed " << done.size() << " volumes." << std::endl;
+    std::cout << "Decompression successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+void handle_merge(const fs::path& output_path, const std::vector<fs::path>& part_paths, bool write_index)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Merging " << part_paths.size() << " parts\n-> to ->    " << output_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::vector<PartInfo> parts(part_paths.size());
+    for (size_t i = 0; i < part_paths.size(); ++i) {
+        if (!read_part(part_paths[i], parts[i])) return;
+    }
+    if (parts.empty()) {
+        std::cerr << "Error: No part files given." << std::endl;
+        return;
+    }
+    std::sort(parts.begin(), parts.end(), [](const PartInfo& a, const PartInfo& b) {
+        return a.header.range_begin < b.header.range_begin;
+    });
+
+    // 1. 같은 입력에서 나온 파트인지, 구간이 빈틈/겹침 없이 전체를 덮는지 확인
+    const PartHeader& first = parts.front().header;
+    uint64_t expected_begin = 0;
+    for (const auto& p : parts) {
+        const PartHeader& h = p.header;
+        if (h.input_size != first.input_size || h.header_hash != first.header_hash || h.data_size != first.data_size) {
+            std::cerr << "Error: " << p.path.string() << " was made from a different input file." << std::endl;
+            return;
+        }
+        if (h.range_begin != expected_begin) {
+            std::cerr << "Error: Parts do not cover the tensor data contiguously ("
+                      << (h.range_begin > expected_begin ? "gap" : "overlap") << " at byte " << expected_begin
+                      << ", " << p.path.string() << ")." << std::endl;
+            return;
+        }
+        expected_begin = h.range_end;
+    }
+    if (expected_begin != first.data_size) {
+        std::cerr << "Error: Parts end at byte " << expected_begin << " but the tensor data is "
+                  << first.data_size << " bytes (missing last part?)." << std::endl;
+        return;
+    }
+
+    // 2. v1 .kang 기록: 첫 파트의 압축 헤더 + 이어 붙인 청크 테이블 + 페이로드 복사
+    const std::vector<char>& compressed_header = parts.front().compressed_header;
+    uint64_t num_chunks = 0;
+    for (const auto& p : parts) num_chunks += p.chunk_info.size();
+    std::FILE* out = file_open(output_path, "wb");
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        return;
+    }
+    bool ok = std::fwrite(KANG_SIGNATURE.data(), 1, KANG_SIGNATURE.size(), out) == KANG_SIGNATURE.size() &&
+              file_write_u64(out, compressed_header.size()) &&
+              (compressed_header.empty() ||
+               std::fwrite(compressed_header.data(), 1, compressed_header.size(), out) == compressed_header.size()) &&
+              file_write_u64(out, num_chunks);
+    for (const auto& p : parts) {
+        for (const auto& c : p.chunk_info) {
+            ok = ok && file_write_u64(out, c.first) && file_write_u64(out, c.second);
+        }
+    }
+    const uint64_t payload_offset = kang_v1_payload_offset(compressed_header.size(), num_chunks);
+    uint64_t archive_size = payload_offset;
+    for (const auto& p : parts) {
+        ok = ok && copy_payload(p, out);
+        archive_size += p.payload_size;
+    }
+    ok = ok && std::fflush(out) == 0;
+    std::fclose(out);
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(output_path, ec);
+        std::cerr << "Error: Cannot write merged archive." << std::endl;
+        return;
+    }
+
+    // 3. 사이드카 인덱스 (헤더를 풀 수 있을 때만)
+    if (write_index) {
+        std::string json_header;
+        ZstdDictionary dict;
+        if (decompress_header_blob(compressed_header, output_path, fs::path(), json_header, dict)) {
+            KidxChunkLayout chunks;
+            chunks.archive_size = archive_size;
+            chunks.payload_offset = payload_offset;
+            for (const auto& p : parts) {
+                for (const auto& c : p.chunk_info) chunks.chunk_info.emplace_back(c.first, c.second);
+            }
+            write_tensor_index_file(json_header, first.data_size, tensor_index_path_for(output_path), &chunks);
+        } else {
+            std::cerr << "Warning: Cannot decode header, tensor index not written (run 'kang index')." << std::endl;
+        }
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Merged " << num_chunks << " chunks: " << first.data_size << " -> "
+              << (archive_size - payload_offset) << " bytes" << std::endl;
+    std::cout << "Merge successful! Took " << diff.count() << " seconds." << std::endl;
+}
@@ -0,0 +1,56 @@
+#ifndef PARTS_H
+#define PARTS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "options.h"
+
+// 분할 압축 파트 파일 (여러 머신/프로세스가 한 safetensors 의 텐서 데이터 구간을 나눠 압축)
+// [PartHeader][압축 헤더][청크 수 x (u64 원본, u64 압축)][(예약 공간)][압축 청크들 @ payload_offset]
+// 파트마다 독립된 청크 테이블을 가지며, merge 는 재압축 없이 테이블과 페이로드를 이어 붙여 v1 .kang 을 만듦.
+// 다중 볼륨 출력(model.kang.000, .001 ...)도 같은 형식이라 볼륨 하나만으로 자기 구간을 풀 수 있음.
+inline const std::string KANG_PART_SIGNATURE = "KANGPART";
+constexpr uint32_t KANG_PART_VERSION = 2;
+
+struct PartHeader {
+    char signature[8];
+    uint32_t version;
+    uint32_t part_index;
+    uint64_t input_size;              // 원본 safetensors 크기 (파트 간 일치 확인)
+    uint64_t header_hash;             // JSON 헤더 FNV-1a
+    uint64_t data_size;               // 텐서 데이터 영역 전체 크기
+    uint64_t range_begin;             // 이 파트가 담은 텐서 데이터 구간
+    uint64_t range_end;
+    uint64_t compressed_header_size;
+    uint64_t num_chunks;
+    uint64_t payload_offset;          // 볼륨은 청크 테이블 자리를 넉넉히 예약하므로 명시
+};
+
+// 텐서 데이터의 일부 구간만 압축해 파트 파일로 기록
+// options.part_count > 0 이면 전체 청크 계획을 part_count 등분한 part_index 번째 구간 (병합 결과가 단일 압축과 동일)
+// 아니면 [range_begin, range_end) 구간 (청크 경계와 맞지 않으면 구간 시작 기준으로 고정 분할)
+void handle_compression_part(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                             const CompressOptions& options);
+
+// 압축 결과를 청크 경계에서 volume_size 이하의 볼륨들(<output>.000, .001 ...)로 나눠 기록
+void handle_compression_volumes(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                                const CompressOptions& options);
+
+bool is_part_file(const std::filesystem::path& path);
+
+// <base>.NNN 볼륨 경로인지 (맞으면 base 를 돌려줌)
+bool volume_base_path(const std::filesystem::path& volume_path, std::filesystem::path& base);
+std::filesystem::path volume_path_for(const std::filesystem::path& base, size_t index);
+
+// 볼륨들을 도착 순서와 무관하게 병렬로 풀어 미리 할당한 출력에 기록
+// 모든 구간이 모이지 않았으면 wait_seconds 동안 새 볼륨을 기다림
+void handle_decompress_volumes(const std::filesystem::path& base, const std::filesystem::path& output_path,
+                               const std::filesystem::path& dict_path, unsigned wait_seconds);
+
+// 파트들을 검증(같은 입력, 빈틈/겹침 없음)하고 이어 붙여 v1 .kang 생성
+void handle_merge(const std::filesystem::path& output_path, const std::vector<std::filesystem::path>& part_paths,
+                  bool write_index);
+
+#endif //PARTS_H
@@ -0,0 +1,393 @@
+#include "random_access.h"
+#include "archive.h"
+#include "compressor.cuh"
+#include "dictionary.h"
+#include "file_util.h"
+#include "kang_format.h"
+#include "safetensors.h"
+#include "tensor_index.h"
+#include "gguf.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// v1 레이아웃 + JSON 헤더
+bool read_archive_header(std::FILE* f, const fs::path& archive_path, const fs::path& dict_path,
+                         KangV1Layout& layout, std::string& json_header)
+{
+    if (!read_kang_v1_layout(f, layout)) return false;
+    ZstdDictionary dict;
+    if (!decompress_header_blob(layout.compressed_header, archive_path, dict_path, json_header, dict)) {
+        std::cerr << "Error: Cannot decompress the archive header." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 청크 매핑이 포함된 인덱스를 메모리에 생성
+bool build_index_for_archive(const KangV1Layout& layout, const std::string& json_header, std::vector<char>& index_buf)
+{
+    KidxChunkLayout chunks;
+    chunks.archive_size = layout.file_size;
+    chunks.payload_offset = layout.payload_offset;
+    chunks.chunk_info = layout.chunk_info;
+    uint64_t data_size = 0;
+    for (const auto& info : layout.chunk_info) data_size += info.first;
+    return build_tensor_index(json_header, data_size, index_buf, &chunks);
+}
+
+bool build_index_for_archive(std::FILE* f, const fs::path& archive_path, const fs::path& dict_path,
+                             std::vector<char>& index_buf)
+{
+    KangV1Layout layout;
+    std::string json_header;
+    return read_archive_header(f, archive_path, dict_path, layout, json_header) &&
+           build_index_for_archive(layout, json_header, index_buf);
+}
+
+// 사이드카가 이 아카이브의 것인지: 크기뿐 아니라 헤더 해시와 청크 테이블(첫 청크 위치, 청크별 크기)까지 같아야 함
+// (같은 크기로 다시 쓴 아카이브의 오래된 인덱스가 엉뚱한 데이터를 가리키지 않도록)
+bool index_matches(const TensorIndexView& view, const KangV1Layout& layout, const std::string& json_header)
+{
+    if (!kidx_has_chunks(view) || view.header->header_hash != fnv1a64(json_header.data(), json_header.size()) ||
+        view.header->header_size != json_header.size()) {
+        return false;
+    }
+    const uint64_t* info = view.section<uint64_t>(KIDX_ARCHIVE_INFO);
+    if (info[0] != layout.file_size || info[1] != layout.payload_offset || info[2] != layout.chunk_info.size()) return false;
+    const uint64_t* comp = view.section<uint64_t>(KIDX_CHUNK_COMP_SIZE);
+    const uint64_t* start = view.section<uint64_t>(KIDX_CHUNK_DATA_START);
+    for (size_t c = 0; c < layout.chunk_info.size(); ++c) {
+        if (comp[c] != layout.chunk_info[c].second || start[c + 1] - start[c] != layout.chunk_info[c].first) return false;
+    }
+    return true;
+}
+
+// v2 아카이브 안 safetensors 에서 지정한 텐서만 추출: 파일 extent 로 텐서가 걸친 청크만 한 번씩 해제
+void extract_v2(const fs::path& archive_path, const fs::path& output_path, const std::vector<std::string>& names)
+{
+    std::cout << "----------------------------------------------------" << std::endl;
+    std::cout << "Extracting " << names.size() << " tensors from " << archive_path.string()
+              << "\n-> to ->    " << output_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::FILE* f = file_open(archive_path, "rb");
+    if (!f) {
+        std::cerr << "Error: Cannot open input file " << archive_path.string() << std::endl;
+        return;
+    }
+    ArchiveIndex index;
+    if (!read_archive_index(f, index) || index.files.empty()) {
+        std::cerr << "Error: Cannot read the archive index." << std::endl;
+        std::fclose(f);
+        return;
+    }
+    // 여러 파일을 담은 아카이브면 첫 safetensors
+    const ArchiveFile* file = &index.files[0];
+    for (const auto& af : index.files) {
+        if (fs::path(af.path).extension() == ".safetensors") {
+            file = &af;
+            break;
+        }
+    }
+
+    // 1. 헤더 (헤더 청크만 해제)
+    std::vector<char> buf;
+    std::string json_header;
+    std::vector<TensorInfo> tensors;
+    uint64_t header_len = 0;
+    bool ok = file->size >= sizeof(uint64_t) && read_archive_file_range(f, index, *file, 0, sizeof(uint64_t), buf);
+    if (ok) std::memcpy(&header_len, buf.data(), sizeof(header_len));
+    ok = ok && header_len <= file->size - sizeof(uint64_t) &&
+         read_archive_file_range(f, index, *file, sizeof(uint64_t), header_len, buf);
+    if (ok) json_header.assign(buf.begin(), buf.end());
+    if (!ok || !parse_safetensors_header(json_header, tensors)) {
+        std::cerr << "Error: " << file->path << " in the archive is not a safetensors file." << std::endl;
+        std::fclose(f);
+        return;
+    }
+    const uint64_t data_start = sizeof(uint64_t) + header_len;
+
+    // 2. 대상 텐서와 그 구간의 extent
+    std::vector<TensorInfo> selected;
+    std::vector<std::vector<ArchiveExtent>> slices;
+    std::vector<size_t> needed;
+    uint64_t out_size = 0;
+    for (const auto& name : names) {
+        auto it = std::find_if(tensors.begin(), tensors.end(), [&](const TensorInfo& t) { return t.name == name; });
+        if (it == tensors.end()) {
+            std::cerr << "Error: Tensor not found: " << name << std::endl;
+            ok = false;
+            break;
+        }
+        TensorInfo t = *it;
+        t.data_begin = out_size;
+        t.data_end = out_size + (it->data_end - it->data_begin);
+        out_size = t.data_end;
+        selected.push_back(t);
+        slices.emplace_back();
+        ok = append_extent_slice(file->extents, data_start + it->data_begin, it->data_end - it->data_begin, slices.back());
+        if (!ok) {
+            std::cerr << "Error: Tensor " << name << " is past the end of " << file->path << std::endl;
+            break;
+        }
+        for (const auto& e : slices.back()) needed.push_back(static_cast<size_t>(e.chunk));
+    }
+    std::sort(needed.begin(), needed.end());
+    needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+
+    // 3. 필요한 청크만 해제하고 겹치는 extent 복사
+    std::vector<char> out_data(static_cast<size_t>(ok ? out_size : 0));
+    ok = ok && decode_archive_chunks(f, index, needed, [&](size_t c, const char* data, size_t size) {
+        for (size_t k = 0; k < selected.size(); ++k) {
+            uint64_t pos = selected[k].data_begin;
+            for (const auto& e : slices[k]) {
+                if (e.chunk == c) {
+                    if (e.chunk_offset + e.length > size) return false;
+                    std::memcpy(out_data.data() + pos, data + e.chunk_offset, static_cast<size_t>(e.length));
+                }
+                pos += e.length;
+            }
+        }
+        return true;
+    });
+    std::fclose(f);
+    if (!ok) {
+        std::cerr << "Extraction failed." << std::endl;
+        return;
+    }
+
+    // 4. 선택한 텐서만 담은 safetensors 기록
+    const std::string out_header = make_safetensors_header(selected);
+    std::ofstream out(output_path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        return;
+    }
+    const uint64_t out_header_len = out_header.size();
+    out.write(reinterpret_cast<const char*>(&out_header_len), sizeof(out_header_len));
+    out.write(out_header.data(), out_header.size());
+    if (!out_data.empty()) out.write(out_data.data(), out_data.size());
+    out.close();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Extracted " << selected.size() << " tensors (" << out_size << " bytes, " << needed.size()
+              << " of " << index.chunks.size() << " chunks decoded)" << std::endl;
+    std::cout << "Extraction successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+} // namespace
+
+void handle_build_index(const fs::path& archive_path, const fs::path& dict_path)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Indexing " << archive_path.string() << std::endl;
+    if (is_v2_archive(archive_path)) {
+        // v2 아카이브는 FILE/CHNK 인덱스를 이미 포함
+        std::cout << "Archive already carries its own file/chunk index, nothing to do ('kang list')." << std::endl;
+        return;
+    }
+
+    std::FILE* f = file_open(archive_path, "rb");
+    if (!f) {
+        std::cerr << "Error: Cannot open input file " << archive_path.string() << std::endl;
+        return;
+    }
+    std::vector<char> index_buf;
+    const bool ok = build_index_for_archive(f, archive_path, dict_path, index_buf);
+    std::fclose(f);
+    if (!ok) {
+        std::cerr << "Indexing failed." << std::endl;
+        return;
+    }
+
+    const fs::path index_path = tensor_index_path_for(archive_path);
+    std::ofstream out(index_path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << index_path.string() << std::endl;
+        return;
+    }
+    out.write(index_buf.data(), index_buf.size());
+    out.close();
+
+    const KidxHeader* h = reinterpret_cast<const KidxHeader*>(index_buf.data());
+    uint64_t info[3];
+    std::memcpy(info, index_buf.data() + h->sections[KIDX_ARCHIVE_INFO].offset, sizeof(info));
+    std::cout << "Tensor index written: " << h->tensor_count << " tensors, " << info[2]
+              << " chunks -> " << index_path.string() << std::endl;
+}
+
+void handle_extract(const fs::path& archive_path, const fs::path& output_path,
+                    const std::vector<std::string>& names, const fs::path& dict_path)
+{
+    if (is_gguf_archive(archive_path)) {
+        // v2 GGUF 아카이브: 텐서 정보는 헤더 청크에, 위치는 파일 extent 로
+        handle_extract_gguf(archive_path, output_path, names);
+        return;
+    }
+    if (is_v2_archive(archive_path)) {
+        // v2 (fast-load/cold/entropy, transcode, update): 청크 위치는 아카이브 인덱스의 파일 extent 로
+        extract_v2(archive_path, output_path, names);
+        return;
+    }
+    std::cout << "----------------------------------------------------" << std::endl;
+    std::cout << "Extracting " << names.size() << " tensors from " << archive_path.string()
+              << "\n-> to ->    " << output_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::FILE* f = file_open(archive_path, "rb");
+    if (!f) {
+        std::cerr << "Error: Cannot open input file " << archive_path.string() << std::endl;
+        return;
+    }
+
+    // 1. 사이드카 인덱스 사용 (없거나 오래됐으면 메모리에서 생성). 헤더/청크 테이블은 비교용으로 항상 읽음
+    KangV1Layout layout;
+    std::string archive_header;
+    if (!read_archive_header(f, archive_path, dict_path, layout, archive_header)) {
+        std::fclose(f);
+        std::cerr << "Extraction failed." << std::endl;
+        return;
+    }
+    MappedFile mapped;
+    std::vector<char> built;
+    TensorIndexView view;
+    const fs::path index_path = tensor_index_path_for(archive_path);
+    bool have_index = fs::exists(index_path) && map_file(index_path, mapped) &&
+                      open_tensor_index(mapped.data, mapped.size, view) && index_matches(view, layout, archive_header);
+    if (!have_index) {
+        unmap_file(mapped);
+        std::cout << "No up-to-date " << index_path.filename().string()
+                  << " found, building the index in memory (run 'kang index' to keep it)." << std::endl;
+        if (!build_index_for_archive(layout, archive_header, built) ||
+            !open_tensor_index(built.data(), built.size(), view)) {
+            std::fclose(f);
+            std::cerr << "Extraction failed." << std::endl;
+            return;
+        }
+    }
+
+    // 2. 대상 텐서와 새 헤더 구성
+    std::vector<TensorInfo> selected;
+    std::vector<uint64_t> source_begin;
+    uint64_t out_size = 0;
+    size_t first_chunk = SIZE_MAX, last_chunk = 0;
+    bool ok = true;
+    for (const auto& name : names) {
+        const int64_t i = find_tensor(view, name);
+        if (i < 0) {
+            std::cerr << "Error: Tensor not found: " << name << std::endl;
+            ok = false;
+            break;
+        }
+        TensorInfo t;
+        t.name = name;
+        t.dtype = std::string(kidx_tensor_dtype(view, static_cast<uint64_t>(i)));
+        t.shape = kidx_tensor_shape(view, static_cast<uint64_t>(i));
+        const uint64_t b = view.section<uint64_t>(KIDX_DATA_BEGIN)[i];
+        const uint64_t e = view.section<uint64_t>(KIDX_DATA_END)[i];
+        t.data_begin = out_size;
+        t.data_end = out_size + (e - b);
+        out_size = t.data_end;
+        selected.push_back(t);
+        source_begin.push_back(b);
+        const uint32_t cb = view.section<uint32_t>(KIDX_TENSOR_CHUNK_BEGIN)[i];
+        const uint32_t ce = view.section<uint32_t>(KIDX_TENSOR_CHUNK_END)[i];
+        if (cb < ce) {
+            first_chunk = std::min<size_t>(first_chunk, cb);
+            last_chunk = std::max<size_t>(last_chunk, ce);
+        }
+    }
+
+    // 3. 필요한 청크만 읽어 해제하고 겹치는 구간 복사
+    std::vector<char> out_data(static_cast<size_t>(out_size));
+    const uint64_t* chunk_offset = view.section<uint64_t>(KIDX_CHUNK_OFFSET);
+    const uint64_t* chunk_comp = view.section<uint64_t>(KIDX_CHUNK_COMP_SIZE);
+    const uint64_t* chunk_start = view.section<uint64_t>(KIDX_CHUNK_DATA_START);
+    std::vector<size_t> needed;
+    for (size_t c = first_chunk; ok && first_chunk != SIZE_MAX && c < last_chunk; ++c) {
+        for (size_t k = 0; k < selected.size(); ++k) {
+            const uint64_t b = source_begin[k];
+            const uint64_t e = b + (selected[k].data_end - selected[k].data_begin);
+            if (b < chunk_start[c + 1] && e > chunk_start[c]) {
+                needed.push_back(c);
+                break;
+            }
+        }
+    }
+
+    auto scatter = [&](size_t c, const char* data, size_t size) {
+        const uint64_t cs = chunk_start[c];
+        if (cs + size != chunk_start[c + 1]) return false;
+        for (size_t k = 0; k < selected.size(); ++k) {
+            const uint64_t b = std::max(source_begin[k], cs);
+            const uint64_t e = std::min(source_begin[k] + (selected[k].data_end - selected[k].data_begin), cs + size);
+            if (b < e) {
+                std::memcpy(out_data.data() + selected[k].data_begin + (b - source_begin[k]),
+                            data + (b - cs), static_cast<size_t>(e - b));
+            }
+        }
+        return true;
+    };
+
+    std::vector<char> comp_buf;
+    if (ok && !needed.empty()) {
+        comp_buf.resize(static_cast<size_t>(chunk_comp[needed[0]]));
+        ok = file_read_at(f, chunk_offset[needed[0]], comp_buf.data(), comp_buf.size());
+    }
+    if (ok && !needed.empty() && is_cpu_zstd_blob(comp_buf.data(), comp_buf.size())) {
+        // 사전 압축된 작은 파일 (청크 1개)
+        ZstdDictionary dict;
+        std::vector<char> plain;
+        ok = resolve_dictionary(comp_buf.data(), comp_buf.size(), archive_path, dict_path, dict) &&
+             decompress_with_dictionary(comp_buf.data(), comp_buf.size(), dict, plain) &&
+             scatter(needed[0], plain.data(), plain.size());
+    }
+    else if (ok && !needed.empty()) {
+        ok = decompress_chunks_streaming(
+            needed.size(),
+            [&](size_t k, size_t& compressed_size, size_t& original_size) -> const char* {
+                const size_t c = needed[k];
+                comp_buf.resize(static_cast<size_t>(chunk_comp[c]));
+                if (!file_read_at(f, chunk_offset[c], comp_buf.data(), comp_buf.size())) return nullptr;
+                compressed_size = comp_buf.size();
+                original_size = static_cast<size_t>(chunk_start[c + 1] - chunk_start[c]);
+                return comp_buf.data();
+            },
+            [&](size_t k, const char* data, size_t size) { return scatter(needed[k], data, size); });
+    }
+    std::fclose(f);
+    const size_t total_chunks = static_cast<size_t>(view.section<uint64_t>(KIDX_ARCHIVE_INFO)[2]);
+    unmap_file(mapped);
+    if (!ok) {
+        std::cerr << "Extraction failed." << std::endl;
+        return;
+    }
+
+    // 4. 선택한 텐서만 담은 safetensors 기록
+    const std::string json_header = make_safetensors_header(selected);
+    std::ofstream out(output_path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        return;
+    }
+    uint64_t header_len = json_header.size();
+    out.write(reinterpret_cast<const char*>(&header_len), sizeof(header_len));
+    out.write(json_header.data(), json_header.size());
+    if (!out_data.empty()) out.write(out_data.data(), out_data.size());
+    out.close();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Extracted " << selected.size() << " tensors (" << out_size << " bytes, " << needed.size()
+              << " of " << total_chunks << " chunks decoded)" << std::endl;
+    std::cout << "Extraction successful! Took " << diff.count() << " seconds." << std::endl;
+}
@@ -0,0 +1,17 @@
+#ifndef RANDOM_ACCESS_H
+#define RANDOM_ACCESS_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// 기존 v1 .kang 에 대한 사이드카 .kidx 생성 (페이로드는 읽지 않음)
+// 청크 절대 오프셋과 텐서-청크 매핑을 헤더와 청크 크기로부터 계산
+void handle_build_index(const std::filesystem::path& archive_path, const std::filesystem::path& dict_path);
+
+// 지정한 텐서만 담은 safetensors 추출 (필요한 청크만 해제)
+// v1 은 .kidx 청크 매핑, v2 는 아카이브 인덱스의 파일 extent 사용 (GGUF 아카이브는 handle_extract_gguf)
+void handle_extract(const std::filesystem::path& archive_path, const std::filesystem::path& output_path,
+                    const std::vector<std::string>& names, const std::filesystem::path& dict_path);
+
+#endif //RANDOM_ACCESS_H
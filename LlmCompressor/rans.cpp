@@ -0,0 +1,532 @@
+#include "rans.h"
+#include "rans_simd.h"
+#include "chunk_codec.h"
+#include "file_util.h"
+#include "safetensors.h"
+#include "scratch_pool.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+template <typename T>
+void put(std::vector<char>& out, T v)
+{
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &v, sizeof(T));
+}
+
+template <typename T>
+bool get(const char*& p, const char* end, T& v)
+{
+    if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+// 스트림 하나의 인코더. 기호는 인덱스 역순으로 들어가야 하므로 encode 도 뒤쪽 구간부터 호출
+struct StreamEncoder {
+    uint16_t freq[256];
+    uint32_t start[257];
+    uint32_t states[RANS_LANES];
+    std::vector<uint16_t> words;
+
+    int table_id = -1;  // 공유 표 번호 (-1 = 스트림에 표 포함)
+
+    void init(const uint64_t counts[256])
+    {
+        uint16_t normalized[256];
+        rans_normalize_freqs(counts, normalized);
+        init_freq(normalized, -1);
+    }
+
+    void init_freq(const uint16_t table[256], int id)
+    {
+        std::memcpy(freq, table, sizeof(freq));
+        table_id = id;
+        start[0] = 0;
+        for (int s = 0; s < 256; ++s) start[s + 1] = start[s] + freq[s];
+        std::fill(states, states + RANS_LANES, RANS_STATE_LOW);
+        words.clear();
+    }
+
+    // 인덱스 [first, first + count) 의 기호 sym[0..count) 를 역순으로 인코딩
+    // (해제 순서 = 인덱스 0 부터, 라운드 안에서는 상태 0 부터의 정확한 역순)
+    void encode(const uint8_t* sym, size_t first, size_t count)
+    {
+        // 지역 복사본으로 진행 (words 기록과 별칭이 없어 상태가 레지스터/스택에 머묾)
+        uint32_t st[RANS_LANES];
+        std::memcpy(st, states, sizeof(st));
+        for (size_t j = count; j-- > 0;) {
+            uint32_t& x = st[(first + j) % RANS_LANES];
+            const uint32_t f = freq[sym[j]];
+            const uint64_t x_max = static_cast<uint64_t>(f) << (32 - RANS_PROB_BITS);
+            if (x >= x_max) {
+                words.push_back(static_cast<uint16_t>(x & 0xffff));
+                x >>= 16;
+            }
+            x = ((x / f) << RANS_PROB_BITS) + (x % f) + start[sym[j]];
+        }
+        std::memcpy(states, st, sizeof(st));
+    }
+
+    // with_ref: 공유 표 참조 형식 (청크 머리에 RANS_SHARED_FLAG)
+    void write(std::vector<char>& out, uint64_t length, bool with_ref)
+    {
+        put<uint64_t>(out, length);
+        if (length == 0) return;
+        std::reverse(words.begin(), words.end());
+        if (with_ref) put<uint16_t>(out, table_id < 0 ? RANS_INLINE_TABLE : static_cast<uint16_t>(table_id));
+        if (table_id < 0) {
+            for (int s = 0; s < 256; ++s) put<uint16_t>(out, freq[s]);
+        }
+        for (uint32_t lane = 0; lane < RANS_LANES; ++lane) put<uint32_t>(out, states[lane]);
+        put<uint64_t>(out, words.size());
+        const size_t at = out.size();
+        out.resize(at + words.size() * sizeof(uint16_t));
+        if (!words.empty()) std::memcpy(out.data() + at, words.data(), words.size() * sizeof(uint16_t));
+    }
+};
+
+// 스트림 하나의 해제기. decode 는 인덱스 순서대로 이어서 호출
+struct StreamDecoder {
+    uint64_t length = 0;
+    std::vector<uint32_t> own_table;    // 스트림에 포함된 표
+    const uint32_t* table = nullptr;    // own_table 또는 아카이브 공유 표
+    uint32_t states[RANS_LANES];
+    const uint8_t* words = nullptr;
+    const uint8_t* words_end = nullptr;
+
+    // 스트림 머리를 읽고 p 를 스트림 끝(단어 뒤)으로 옮김
+    bool parse(const char*& p, const char* end, bool with_ref, const RansSharedTables* shared)
+    {
+        if (!get(p, end, length)) return false;
+        if (length == 0) return true;
+        uint16_t ref = RANS_INLINE_TABLE;
+        if (with_ref && !get(p, end, ref)) return false;
+        if (ref != RANS_INLINE_TABLE) {
+            if (!shared || ref >= shared->decode.size()) {
+                std::cerr << "Error: rANS stream references shared table " << ref << " that the archive does not have."
+                          << std::endl;
+                return false;
+            }
+            table = shared->decode[ref].data();
+        }
+        else {
+            uint16_t freq[256];
+            uint32_t total = 0;
+            for (int s = 0; s < 256; ++s) {
+                if (!get(p, end, freq[s])) return false;
+                total += freq[s];
+            }
+            if (total != RANS_PROB_SCALE) return false;
+            own_table.resize(RANS_PROB_SCALE);
+            rans_build_decode_table(freq, own_table.data());
+            table = own_table.data();
+        }
+        uint64_t word_count = 0;
+        for (uint32_t lane = 0; lane < RANS_LANES; ++lane) {
+            if (!get(p, end, states[lane])) return false;
+        }
+        if (!get(p, end, word_count) || word_count > static_cast<uint64_t>(end - p) / 2) return false;
+        words = reinterpret_cast<const uint8_t*>(p);
+        words_end = words + word_count * 2;
+        p = reinterpret_cast<const char*>(words_end);
+        return true;
+    }
+
+    // 인덱스 [first, first + count) 해제. 라운드 경계에 맞춘 부분은 SIMD 커널, 앞뒤 조각은 스칼라
+    void decode(RansDecodeKernel kernel, uint8_t* dst, size_t first, size_t count)
+    {
+        size_t i = 0;
+        for (; i < count && (first + i) % RANS_LANES != 0; ++i) {
+            dst[i] = rans_decode_step(table, states[(first + i) % RANS_LANES], words, words_end);
+        }
+        const size_t rounds = (count - i) / RANS_LANES;
+        kernel(table, states, words, words_end, dst + i, rounds);
+        for (i += rounds * RANS_LANES; i < count; ++i) {
+            dst[i] = rans_decode_step(table, states[(first + i) % RANS_LANES], words, words_end);
+        }
+    }
+
+    // 모든 단어를 쓰고 상태가 인코더 초기값으로 돌아와야 정상
+    bool finished() const
+    {
+        if (length == 0) return true;
+        for (uint32_t lane = 0; lane < RANS_LANES; ++lane) {
+            if (states[lane] != RANS_STATE_LOW) return false;
+        }
+        return words == words_end;
+    }
+};
+
+RansDecodeKernel active_kernel()
+{
+    static const RansDecodeKernel kernel = rans_decode_kernel(active_simd_level());
+    return kernel;
+}
+
+// 스트림 머리를 모두 읽음 (스트림 수 검사 포함)
+bool parse_streams(const char* src, size_t compressed_size, const RansSharedTables* shared,
+                   std::vector<StreamDecoder>& streams)
+{
+    const char* p = src;
+    const char* end = src + compressed_size;
+    uint8_t head = 0;
+    if (!get(p, end, head)) return false;
+    const bool with_ref = (head & RANS_SHARED_FLAG) != 0;
+    const uint8_t count = head & ~RANS_SHARED_FLAG;
+    if (count < 1 || count > RANS_MAX_STREAMS) return false;
+    streams.resize(count);
+    for (auto& s : streams) {
+        if (!s.parse(p, end, with_ref, shared)) return false;
+    }
+    return p == end;
+}
+
+bool decompress_with(RansDecodeKernel kernel, const char* src, size_t compressed_size, char* dst, size_t original_size,
+                     const RansSharedTables* shared = nullptr)
+{
+    std::vector<StreamDecoder> streams;
+    if (!parse_streams(src, compressed_size, shared, streams)) return false;
+    uint64_t pos = 0;
+    for (auto& s : streams) {
+        if (s.length > original_size - pos) return false;
+        s.decode(kernel, reinterpret_cast<uint8_t*>(dst) + pos, 0, static_cast<size_t>(s.length));
+        if (!s.finished()) return false;
+        pos += s.length;
+    }
+    return pos == original_size;
+}
+
+} // namespace
+
+void rans_normalize_freqs(const uint64_t counts[256], uint16_t freq[256])
+{
+    uint64_t total = 0;
+    for (int s = 0; s < 256; ++s) total += counts[s];
+    uint32_t sum = 0;
+    for (int s = 0; s < 256; ++s) {
+        freq[s] = 0;
+        if (!counts[s]) continue;
+        const uint64_t f = (counts[s] * RANS_PROB_SCALE + total / 2) / total;
+        freq[s] = static_cast<uint16_t>(std::max<uint64_t>(1, f));
+        sum += freq[s];
+    }
+    if (sum == 0) return;
+    // 반올림/최소 1 로 생긴 차이는 가장 큰 빈도에서 조정 (상대 오차가 가장 작음)
+    while (sum != RANS_PROB_SCALE) {
+        int best = -1;
+        for (int s = 0; s < 256; ++s) {
+            if (freq[s] > (sum > RANS_PROB_SCALE ? 1 : 0) && (best < 0 || freq[s] > freq[best])) best = s;
+        }
+        if (sum > RANS_PROB_SCALE) { --freq[best]; --sum; }
+        else { ++freq[best]; ++sum; }
+    }
+}
+
+void rans_build_decode_table(const uint16_t freq[256], uint32_t table[RANS_PROB_SCALE])
+{
+    uint32_t slot = 0;
+    for (uint32_t s = 0; s < 256; ++s) {
+        for (uint32_t k = 0; k < freq[s] && slot < RANS_PROB_SCALE; ++k, ++slot) {
+            table[slot] = (freq[s] - 1u) | (k << 12) | (s << 24);
+        }
+    }
+}
+
+bool rans_compress_chunk(const char* src, size_t size, uint32_t streams, std::vector<char>& out)
+{
+    streams = std::min(std::max(streams, 1u), RANS_MAX_STREAMS);
+    const size_t segment = size / streams;
+    std::vector<size_t> lengths(streams, segment);
+    lengths.back() = size - segment * (streams - 1);
+    return rans_compress_streams(src, lengths, out);
+}
+
+bool rans_compress_streams(const char* src, const std::vector<size_t>& lengths, std::vector<char>& out)
+{
+    if (lengths.empty() || lengths.size() > RANS_MAX_STREAMS) return false;
+    out.clear();
+    put<uint8_t>(out, static_cast<uint8_t>(lengths.size()));
+    StreamEncoder enc;
+    const uint8_t* sym = reinterpret_cast<const uint8_t*>(src);
+    for (size_t n : lengths) {
+        uint64_t counts[256] = {};
+        for (size_t i = 0; i < n; ++i) ++counts[sym[i]];
+        enc.init(counts);
+        enc.encode(sym, 0, n);
+        enc.write(out, n, false);
+        sym += n;
+    }
+    return true;
+}
+
+bool rans_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size,
+                           const RansSharedTables* shared)
+{
+    if (!decompress_with(active_kernel(), src, compressed_size, dst, original_size, shared)) {
+        std::cerr << "Error: rANS chunk is corrupted." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::vector<char> serialize_rans_tables(const std::vector<RansTable>& tables)
+{
+    std::vector<char> out;
+    put<uint32_t>(out, static_cast<uint32_t>(tables.size()));
+    for (const auto& t : tables) {
+        put<uint8_t>(out, static_cast<uint8_t>(t.dtype));
+        put<uint8_t>(out, t.plane);
+        for (int s = 0; s < 256; ++s) put<uint16_t>(out, t.freq[s]);
+    }
+    return out;
+}
+
+bool parse_rans_tables(const std::vector<char>& data, RansSharedTables& shared)
+{
+    const char* p = data.data();
+    const char* end = p + data.size();
+    uint32_t count = 0;
+    if (!get(p, end, count) || count >= RANS_INLINE_TABLE || count > data.size() / 514) return false;
+    shared.tables.resize(count);
+    shared.decode.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        RansTable& t = shared.tables[i];
+        uint8_t dtype = 0;
+        uint32_t total = 0;
+        if (!get(p, end, dtype) || !get(p, end, t.plane)) return false;
+        t.dtype = static_cast<DType>(dtype);
+        for (int s = 0; s < 256; ++s) {
+            if (!get(p, end, t.freq[s])) return false;
+            total += t.freq[s];
+        }
+        if (total != RANS_PROB_SCALE) return false;
+        // 해제 표는 아카이브를 열 때 한 번만 만듦 (청크마다 만들지 않음)
+        shared.decode[i].resize(RANS_PROB_SCALE);
+        rans_build_decode_table(t.freq, shared.decode[i].data());
+    }
+    return p == end;
+}
+
+int RansSharedTables::find(DType dtype, uint8_t plane) const
+{
+    for (size_t i = 0; i < tables.size(); ++i) {
+        if (tables[i].dtype == dtype && tables[i].plane == plane) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void rans_plane_histograms(const DTypeKernels& k, bool fold, const char* src, size_t size, uint64_t* counts)
+{
+    const size_t w = k.width;
+    const size_t n = size / w;
+    const auto split = fold ? k.fold_split : k.split;
+    const size_t tile = std::max<size_t>(KANG_TILE_BYTES / w / RANS_LANES * RANS_LANES, RANS_LANES);
+    ScratchPool::Lease scratch = scratch_pool().acquire(tile * w);
+    const uint8_t* planes = reinterpret_cast<const uint8_t*>(scratch.data());
+    for (size_t t0 = 0; t0 < n; t0 += tile) {
+        const size_t tc = std::min(tile, n - t0);
+        split(src + t0 * w, tc, scratch.data());
+        for (size_t b = 0; b < w; ++b) {
+            for (size_t j = 0; j < tc; ++j) ++counts[b * 256 + planes[b * tc + j]];
+        }
+    }
+    const uint8_t* tail_bytes = reinterpret_cast<const uint8_t*>(src) + n * w;
+    for (size_t j = 0; j < size - n * w; ++j) ++counts[(w - 1) * 256 + tail_bytes[j]];
+}
+
+double rans_cost_bits(const uint64_t counts[256], const uint16_t freq[256])
+{
+    double bits = 0;
+    for (int s = 0; s < 256; ++s) {
+        if (!counts[s]) continue;
+        if (!freq[s]) return std::numeric_limits<double>::infinity();
+        bits += static_cast<double>(counts[s]) * (RANS_PROB_BITS - std::log2(static_cast<double>(freq[s])));
+    }
+    return bits;
+}
+
+bool rans_compress_planes(const DTypeKernels& k, bool fold, const char* src, size_t size, std::vector<char>& out,
+                          const RansSharedTables* shared)
+{
+    const size_t w = k.width;
+    const size_t n = w ? size / w : 0;
+    if (w < 2 || w > RANS_MAX_STREAMS || n == 0) return rans_compress_chunk(src, size, 1, out);
+    const size_t tail = size - n * w;
+    const auto split = fold ? k.fold_split : k.split;
+    const size_t tile = std::max<size_t>(KANG_TILE_BYTES / w / RANS_LANES * RANS_LANES, RANS_LANES); // 원소 수
+    ScratchPool::Lease scratch = scratch_pool().acquire(tile * w);
+    const uint8_t* planes = reinterpret_cast<const uint8_t*>(scratch.data());
+    const uint8_t* tail_bytes = reinterpret_cast<const uint8_t*>(src) + n * w;
+
+    // 1) 평면별 빈도: 타일을 스크래치로 변환해 세기만 함
+    std::vector<uint64_t> counts(256 * w, 0);
+    rans_plane_histograms(k, fold, src, size, counts.data());
+
+    // 공유 표가 있으면 (dtype, 평면) 표로 인코딩한 크기가 자체 표 + 표 크기보다 크지 않을 때 참조
+    std::vector<StreamEncoder> enc(w);
+    for (size_t b = 0; b < w; ++b) {
+        const uint64_t* c = &counts[b * 256];
+        const int id = shared ? shared->find(k.dtype, static_cast<uint8_t>(b)) : -1;
+        if (id >= 0) {
+            uint16_t own[256];
+            rans_normalize_freqs(c, own);
+            const double table_bits = 256.0 * 16.0;
+            if (rans_cost_bits(c, shared->tables[id].freq) <= rans_cost_bits(c, own) + table_bits) {
+                enc[b].init_freq(shared->tables[id].freq, id);
+                continue;
+            }
+        }
+        enc[b].init(c);
+    }
+
+    // 2) 뒤 타일부터 다시 변환하며 평면마다 역순 인코딩 (마지막 스트림은 꼬리 바이트가 맨 뒤)
+    enc[w - 1].encode(tail_bytes, n, tail);
+    for (size_t t_end = n; t_end > 0;) {
+        const size_t t0 = (t_end - 1) / tile * tile;
+        const size_t tc = t_end - t0;
+        split(src + t0 * w, tc, scratch.data());
+        for (size_t b = 0; b < w; ++b) enc[b].encode(planes + b * tc, t0, tc);
+        t_end = t0;
+    }
+
+    out.clear();
+    put<uint8_t>(out, static_cast<uint8_t>(w | (shared ? RANS_SHARED_FLAG : 0)));
+    for (size_t b = 0; b < w; ++b) enc[b].write(out, b + 1 < w ? n : n + tail, shared != nullptr);
+    return true;
+}
+
+bool rans_decompress_planes(const DTypeKernels& k, bool fold, const char* src, size_t compressed_size, char* dst,
+                            size_t original_size, const RansSharedTables* shared)
+{
+    const size_t w = k.width;
+    const size_t n = w ? original_size / w : 0;
+    const size_t tail = original_size - n * w;
+    const auto merge = fold ? k.merge_unfold : k.merge;
+    std::vector<StreamDecoder> streams;
+    bool ok = parse_streams(src, compressed_size, shared, streams);
+    if (ok && (streams.size() != w || n == 0)) {
+        // 평면 수와 스트림 수가 다르면 (다른 인코더) 청크 전체를 해제한 뒤 병합
+        ScratchPool::Lease planes = scratch_pool().acquire(original_size);
+        ok = decompress_with(active_kernel(), src, compressed_size, planes.data(), original_size, shared);
+        if (ok) {
+            merge(planes.data(), n, dst);
+            std::memcpy(dst + n * w, planes.data() + n * w, tail);
+        }
+    }
+    else if (ok) {
+        for (size_t b = 0; b < w && ok; ++b) ok = streams[b].length == (b + 1 < w ? n : n + tail);
+        const size_t tile = std::max<size_t>(KANG_TILE_BYTES / w / RANS_LANES * RANS_LANES, RANS_LANES);
+        ScratchPool::Lease scratch = scratch_pool().acquire(tile * w);
+        uint8_t* planes = reinterpret_cast<uint8_t*>(scratch.data());
+        // 평면 스트림들을 타일 단위로 나란히 해제해 L2 에 있는 동안 바로 병합
+        for (size_t t0 = 0; t0 < n && ok; t0 += tile) {
+            const size_t tc = std::min(tile, n - t0);
+            for (size_t b = 0; b < w; ++b) streams[b].decode(active_kernel(), planes + b * tc, t0, tc);
+            merge(scratch.data(), tc, dst + t0 * w);
+        }
+        if (ok) streams[w - 1].decode(active_kernel(), reinterpret_cast<uint8_t*>(dst) + n * w, n, tail);
+        for (const auto& s : streams) ok = ok && s.finished();
+    }
+    if (!ok) {
+        std::cerr << "Error: rANS chunk is corrupted." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void handle_bench_rans(const fs::path& input_path, size_t megabytes)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "rANS decode benchmark (" << RANS_LANES << " interleaved states, single thread)" << std::endl;
+    const size_t limit = std::max<size_t>(megabytes, 1) * 1024 * 1024;
+
+    // 표본: safetensors 텐서 데이터 앞부분, 아니면 합성 bf16 (정규분포 가중치)
+    std::vector<char> sample;
+    uint8_t width = 2;
+    if (!input_path.empty()) {
+        std::FILE* in = file_open(input_path, "rb");
+        if (!in) {
+            std::cerr << "Error: Cannot open file " << input_path.string() << std::endl;
+            return;
+        }
+        const uint64_t file_size = fs::file_size(input_path);
+        std::string json_header;
+        uint64_t data_offset = 0;
+        std::vector<TensorInfo> tensors;
+        if (!read_safetensors_header(in, file_size, json_header, data_offset) ||
+            !parse_safetensors_header(json_header, tensors)) {
+            std::fclose(in);
+            return;
+        }
+        sample.resize(static_cast<size_t>(std::min<uint64_t>(limit, file_size - data_offset)));
+        const bool ok = sample.empty() || file_read_at(in, data_offset, sample.data(), sample.size());
+        std::fclose(in);
+        if (!ok || sample.empty()) {
+            std::cerr << "Error: Cannot read tensor data from " << input_path.string() << std::endl;
+            return;
+        }
+        const DTypeKernels* k = dtype_kernels(dominant_dtype(tensors, 0, sample.size()));
+        width = k ? k->width : 0;
+    }
+    else {
+        std::mt19937 rng(1234);
+        std::normal_distribution<float> dist(0.0f, 0.02f);
+        sample.resize(limit & ~size_t(1));
+        for (size_t i = 0; i + 1 < sample.size(); i += 2) {
+            const float v = dist(rng);
+            uint32_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            const uint16_t bf16 = static_cast<uint16_t>(bits >> 16);
+            std::memcpy(&sample[i], &bf16, sizeof(bf16));
+        }
+    }
+
+    std::vector<char> planes(sample.size());
+    if (width > 1) byte_split(sample.data(), sample.size(), width, planes.data());
+    else planes = sample;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::vector<char> comp;
+    rans_compress_chunk(planes.data(), planes.size(), std::max<uint32_t>(width, 1), comp);
+    const double encode_sec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+    std::cout << "Sample: " << sample.size() << " bytes, " << (width > 1 ? std::to_string(width) + " byte planes" : "1 stream")
+              << " -> " << comp.size() << " bytes (" << std::fixed << std::setprecision(2)
+              << 100.0 * static_cast<double>(comp.size()) / static_cast<double>(sample.size()) << "%), encode "
+              << static_cast<double>(sample.size()) / encode_sec / 1e9 << " GB/s" << std::endl;
+
+    std::vector<char> reference(planes.size()), decoded(planes.size());
+    const SimdLevel detected = detect_simd_level();
+    for (int l = 0; l <= static_cast<int>(detected); ++l) {
+        const SimdLevel level = static_cast<SimdLevel>(l);
+        const RansDecodeKernel kernel = rans_decode_kernel(level);
+        std::vector<char>& dst = l == 0 ? reference : decoded;
+        double best = 1e30, total = 0;
+        bool ok = true;
+        for (int iter = 0; ok && (iter < 3 || total < 1.0); ++iter) {
+            auto t = std::chrono::high_resolution_clock::now();
+            ok = decompress_with(kernel, comp.data(), comp.size(), dst.data(), dst.size());
+            const double sec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t).count();
+            best = std::min(best, sec);
+            total += sec;
+        }
+        const bool identical = ok && (l == 0 ? dst == planes : dst == reference);
+        std::cout << "  " << std::left << std::setw(8) << simd_level_name(level) << std::right
+                  << std::setw(8) << static_cast<double>(sample.size()) / best / 1e9 << " GB/s"
+                  << (identical ? (l == 0 ? "  (round trip OK)" : "  (identical to scalar)") : "  MISMATCH") << std::endl;
+    }
+    std::cout << "Active kernel: " << simd_level_name(active_simd_level()) << " (set KANG_SIMD=scalar|sse4|avx2|avx512 to cap)"
+              << std::endl;
+}
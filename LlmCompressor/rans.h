@@ -0,0 +1,79 @@
+#ifndef RANS_H
+#define RANS_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include "dtype_kernels.h"
+
+// 인터리브 rANS 엔트로피 코더 (ChunkCodec::Rans)
+// 바이트 알파벳 order-0, 12비트 확률, 32비트 상태 32 개를 라운드 로빈으로 사용 (바이트 i 는 상태 i % 32)
+// 재정규화는 16비트 단위라 기호당 최대 한 단어. 해제는 CPUID 로 고른 SSE4.1/AVX2/AVX-512 커널이 상태 여러 개를
+// 한 번에 진행하며, 어느 커널이든 스칼라 경로와 같은 순서로 단어를 읽으므로 출력이 비트 단위로 같음.
+// 매치 탐색이 없어 압축률은 엔트로피 한계까지지만 바이트 분할한 지수/상위 바이트 평면에는 충분하고 해제가 빠름.
+//
+// 청크 = [u8 스트림 수 | RANS_SHARED_FLAG][스트림...]
+// 스트림 = [u64 길이][u16 표 번호 (플래그가 있을 때만)][u16 x 256 빈도 (표 번호가 RANS_INLINE_TABLE 이거나 플래그가 없을 때)]
+//          [u32 x 32 초기 상태][u64 단어 수][u16 x 단어 수] (길이 0 이면 길이만)
+constexpr uint32_t RANS_PROB_BITS = 12;
+constexpr uint32_t RANS_PROB_SCALE = 1u << RANS_PROB_BITS;
+constexpr uint32_t RANS_LANES = 32;
+constexpr uint32_t RANS_STATE_LOW = 1u << 16;   // 상태 범위 [2^16, 2^32)
+constexpr uint32_t RANS_MAX_STREAMS = 8;
+constexpr uint8_t RANS_SHARED_FLAG = 0x80;      // 스트림마다 공유 표 번호가 있음
+constexpr uint16_t RANS_INLINE_TABLE = 0xFFFF;  // 공유 표 대신 스트림에 표 포함 (분포가 다른 청크)
+
+// 아카이브 공유 엔트로피 표 (SECTION_RANS_TABLES). (dtype, 평면) 마다 빈도표 하나를 두고 청크 스트림이 번호로 참조.
+// 모델의 텐서들은 지수/상위 바이트 분포가 거의 같아 청크마다 표를 싣는 대신 한 번만 기록하고 해제 표도 한 번만 만듦.
+// 섹션 = [u32 표 수][표 수 x (u8 DType, u8 평면, u16 x 256 빈도)]
+struct RansTable {
+    DType dtype = DType::Unknown;
+    uint8_t plane = 0;
+    uint16_t freq[256] = {};
+};
+
+struct RansSharedTables {
+    std::vector<RansTable> tables;
+    std::vector<std::vector<uint32_t>> decode;  // tables 와 같은 순서의 해제 표 (parse_rans_tables 가 만듦)
+
+    int find(DType dtype, uint8_t plane) const; // 없으면 -1
+};
+
+std::vector<char> serialize_rans_tables(const std::vector<RansTable>& tables);
+bool parse_rans_tables(const std::vector<char>& data, RansSharedTables& shared);
+
+// 바이트 분할(fold 면 부호 접기) 평면별 바이트 빈도를 counts[평면 * 256 + 바이트] 에 더함 (꼬리 바이트는 마지막 평면)
+void rans_plane_histograms(const DTypeKernels& k, bool fold, const char* src, size_t size, uint64_t* counts);
+
+// counts 를 freq 표로 인코딩할 때의 비트 수 (표에 없는 기호가 있으면 무한대)
+double rans_cost_bits(const uint64_t counts[256], const uint16_t freq[256]);
+
+// 바이트 빈도를 합이 RANS_PROB_SCALE 인 빈도표로 정규화 (나타난 기호는 최소 1)
+void rans_normalize_freqs(const uint64_t counts[256], uint16_t freq[256]);
+
+// 해제 표: 슬롯마다 (빈도-1) | (슬롯-시작) << 12 | 기호 << 24
+void rans_build_decode_table(const uint16_t freq[256], uint32_t table[RANS_PROB_SCALE]);
+
+// size 바이트를 streams 개의 같은 크기 구간(마지막이 나머지 포함)으로 나눠 각각 독립 빈도표로 인코딩
+// 바이트 분할된 청크는 streams = 원소 크기로 주면 평면마다 표를 따로 가짐
+bool rans_compress_chunk(const char* src, size_t size, uint32_t streams, std::vector<char>& out);
+// 길이가 다른 구간들(최대 RANS_MAX_STREAMS 개)을 각각 독립 빈도표 스트림으로 (해제는 rans_decompress_chunk 그대로)
+bool rans_compress_streams(const char* src, const std::vector<size_t>& lengths, std::vector<char>& out);
+bool rans_decompress_chunk(const char* src, size_t compressed_size, char* dst, size_t original_size,
+                           const RansSharedTables* shared = nullptr);
+
+// 바이트 분할 + rANS 융합 경로 (fold 면 부호 접기 포함). 청크 크기의 평면 버퍼 없이 KANG_TILE_BYTES 타일을
+// 풀에서 빌린 스크래치로 변환해 평면 스트림마다 바로 인코딩하고, 해제도 타일마다 평면들을 해제해 바로 병합.
+// shared 가 없으면 결과 바이트는 청크 전체를 분할한 뒤 rans_compress_chunk(streams = 원소 크기) 한 것과 같음.
+// shared 가 있으면 평면마다 (dtype, 평면) 공유 표를 참조하고, 자체 표가 표 크기 이상으로 작을 때만 표를 포함
+bool rans_compress_planes(const DTypeKernels& k, bool fold, const char* src, size_t size, std::vector<char>& out,
+                          const RansSharedTables* shared = nullptr);
+bool rans_decompress_planes(const DTypeKernels& k, bool fold, const char* src, size_t compressed_size, char* dst,
+                            size_t original_size, const RansSharedTables* shared = nullptr);
+
+// 해제 마이크로벤치마크: 지원하는 ISA 마다 단일 스레드 해제 속도(GB/s)와 스칼라와의 일치 여부 출력
+// input_path 가 비어 있으면 bf16 가중치 모양의 합성 데이터를 씀
+void handle_bench_rans(const std::filesystem::path& input_path, size_t megabytes);
+
+#endif //RANS_H
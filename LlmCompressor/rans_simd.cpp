@@ -0,0 +1,198 @@
+#include "rans_simd.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define KANG_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC/Clang 은 함수 단위로 ISA 를 켜야 인트린식을 쓸 수 있음 (MSVC 는 항상 사용 가능)
+#if defined(KANG_X86) && !defined(_MSC_VER)
+#define KANG_TARGET(isa) __attribute__((target(isa)))
+#else
+#define KANG_TARGET(isa)
+#endif
+
+namespace {
+
+void decode_rounds_scalar(const uint32_t* table, uint32_t* states, const uint8_t*& words, const uint8_t* words_end,
+                          uint8_t* out, size_t rounds)
+{
+    for (size_t r = 0; r < rounds; ++r, out += RANS_LANES) {
+        for (uint32_t lane = 0; lane < RANS_LANES; ++lane) {
+            out[lane] = rans_decode_step(table, states[lane], words, words_end);
+        }
+    }
+}
+
+// 상태 lanes 개 묶음을 스칼라로 진행 (남은 단어가 벡터 로드 폭보다 적을 때)
+void decode_group_scalar(const uint32_t* table, uint32_t* states, const uint8_t*& words, const uint8_t* words_end,
+                         uint8_t* out, uint32_t lanes)
+{
+    for (uint32_t k = 0; k < lanes; ++k) out[k] = rans_decode_step(table, states[k], words, words_end);
+}
+
+#ifdef KANG_X86
+
+// 재정규화 마스크별 단어 배치 표: 마스크에서 j 번째로 켜진 상태가 j 번째 단어를 받음
+struct RenormTables {
+    uint8_t popcount[256] = {};
+    uint32_t avx2_perm[256][8] = {};   // _mm256_permutevar8x32_epi32 인덱스
+    uint8_t sse_shuffle[16][16] = {};  // _mm_shuffle_epi8 바이트 인덱스 (0x80 = 0)
+
+    constexpr RenormTables()
+    {
+        for (uint32_t m = 0; m < 256; ++m) {
+            uint32_t k = 0;
+            for (uint32_t j = 0; j < 8; ++j) {
+                if (!((m >> j) & 1)) continue;
+                avx2_perm[m][j] = k;
+                if (m < 16) {
+                    for (uint32_t b = 0; b < 4; ++b) sse_shuffle[m][j * 4 + b] = static_cast<uint8_t>(k * 4 + b);
+                }
+                ++k;
+            }
+            popcount[m] = static_cast<uint8_t>(k);
+            if (m < 16) {
+                for (uint32_t j = 0; j < 4; ++j) {
+                    if (!((m >> j) & 1)) {
+                        for (uint32_t b = 0; b < 4; ++b) sse_shuffle[m][j * 4 + b] = 0x80;
+                    }
+                }
+            }
+        }
+    }
+};
+constexpr RenormTables kRenorm;
+
+// SSE4.1: 상태 4 개씩. 표 조회는 스칼라 (gather 없음), 곱셈/재정규화는 벡터
+KANG_TARGET("sse4.1")
+void decode_rounds_sse41(const uint32_t* table, uint32_t* states, const uint8_t*& words, const uint8_t* words_end,
+                         uint8_t* out, size_t rounds)
+{
+    const __m128i low12 = _mm_set1_epi32(0xfff);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+    for (size_t r = 0; r < rounds; ++r, out += RANS_LANES) {
+        for (uint32_t g = 0; g < RANS_LANES; g += 4) {
+            if (words_end - words < 8) {
+                decode_group_scalar(table, states + g, words, words_end, out + g, 4);
+                continue;
+            }
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(states + g));
+            const __m128i e = _mm_setr_epi32(
+                static_cast<int>(table[states[g] & (RANS_PROB_SCALE - 1)]),
+                static_cast<int>(table[states[g + 1] & (RANS_PROB_SCALE - 1)]),
+                static_cast<int>(table[states[g + 2] & (RANS_PROB_SCALE - 1)]),
+                static_cast<int>(table[states[g + 3] & (RANS_PROB_SCALE - 1)]));
+            const __m128i freq = _mm_add_epi32(_mm_and_si128(e, low12), one);
+            const __m128i bias = _mm_and_si128(_mm_srli_epi32(e, 12), low12);
+            x = _mm_add_epi32(_mm_mullo_epi32(freq, _mm_srli_epi32(x, RANS_PROB_BITS)), bias);
+
+            const __m128i sym16 = _mm_packus_epi32(_mm_srli_epi32(e, 24), zero);
+            const int sym = _mm_cvtsi128_si32(_mm_packus_epi16(sym16, zero));
+            std::memcpy(out + g, &sym, 4);
+
+            const __m128i need = _mm_cmpeq_epi32(_mm_srli_epi32(x, 16), zero);
+            const int m = _mm_movemask_ps(_mm_castsi128_ps(need));
+            if (m) {
+                __m128i w = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(words)));
+                w = _mm_shuffle_epi8(w, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kRenorm.sse_shuffle[m])));
+                x = _mm_blendv_epi8(x, _mm_or_si128(_mm_slli_epi32(x, 16), w), need);
+                words += 2 * kRenorm.popcount[m];
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(states + g), x);
+        }
+    }
+}
+
+// AVX2: 상태 8 개씩. gather 로 표 조회, 재정규화 단어는 permute 로 배치
+KANG_TARGET("avx2")
+void decode_rounds_avx2(const uint32_t* table, uint32_t* states, const uint8_t*& words, const uint8_t* words_end,
+                        uint8_t* out, size_t rounds)
+{
+    const __m256i mask = _mm256_set1_epi32(RANS_PROB_SCALE - 1);
+    const __m256i low12 = _mm256_set1_epi32(0xfff);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    for (size_t r = 0; r < rounds; ++r, out += RANS_LANES) {
+        for (uint32_t g = 0; g < RANS_LANES; g += 8) {
+            if (words_end - words < 16) {
+                decode_group_scalar(table, states + g, words, words_end, out + g, 8);
+                continue;
+            }
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + g));
+            const __m256i e = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), _mm256_and_si256(x, mask), 4);
+            const __m256i freq = _mm256_add_epi32(_mm256_and_si256(e, low12), one);
+            const __m256i bias = _mm256_and_si256(_mm256_srli_epi32(e, 12), low12);
+            x = _mm256_add_epi32(_mm256_mullo_epi32(freq, _mm256_srli_epi32(x, RANS_PROB_BITS)), bias);
+
+            const __m256i sym = _mm256_srli_epi32(e, 24);
+            const __m128i sym16 = _mm_packus_epi32(_mm256_castsi256_si128(sym), _mm256_extracti128_si256(sym, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + g), _mm_packus_epi16(sym16, sym16));
+
+            const __m256i need = _mm256_cmpeq_epi32(_mm256_srli_epi32(x, 16), zero);
+            const int m = _mm256_movemask_ps(_mm256_castsi256_ps(need));
+            if (m) {
+                __m256i w = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words)));
+                w = _mm256_permutevar8x32_epi32(w, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kRenorm.avx2_perm[m])));
+                x = _mm256_blendv_epi8(x, _mm256_or_si256(_mm256_slli_epi32(x, 16), w), need);
+                words += 2 * kRenorm.popcount[m];
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(states + g), x);
+        }
+    }
+}
+
+// AVX-512F: 상태 16 개씩. 재정규화 단어는 마스크 expand 로 배치
+KANG_TARGET("avx512f")
+void decode_rounds_avx512(const uint32_t* table, uint32_t* states, const uint8_t*& words, const uint8_t* words_end,
+                          uint8_t* out, size_t rounds)
+{
+    const __m512i mask = _mm512_set1_epi32(RANS_PROB_SCALE - 1);
+    const __m512i low12 = _mm512_set1_epi32(0xfff);
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i state_low = _mm512_set1_epi32(RANS_STATE_LOW);
+    for (size_t r = 0; r < rounds; ++r, out += RANS_LANES) {
+        for (uint32_t g = 0; g < RANS_LANES; g += 16) {
+            if (words_end - words < 32) {
+                decode_group_scalar(table, states + g, words, words_end, out + g, 16);
+                continue;
+            }
+            __m512i x = _mm512_loadu_si512(states + g);
+            const __m512i e = _mm512_i32gather_epi32(_mm512_and_si512(x, mask), table, 4);
+            const __m512i freq = _mm512_add_epi32(_mm512_and_si512(e, low12), one);
+            const __m512i bias = _mm512_and_si512(_mm512_srli_epi32(e, 12), low12);
+            x = _mm512_add_epi32(_mm512_mullo_epi32(freq, _mm512_srli_epi32(x, RANS_PROB_BITS)), bias);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + g), _mm512_cvtepi32_epi8(_mm512_srli_epi32(e, 24)));
+
+            const __mmask16 need = _mm512_cmplt_epu32_mask(x, state_low);
+            if (need) {
+                __m512i w = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)));
+                w = _mm512_maskz_expand_epi32(need, w);
+                x = _mm512_mask_or_epi32(x, need, _mm512_slli_epi32(x, 16), w);
+                words += 2 * (kRenorm.popcount[need & 0xff] + kRenorm.popcount[need >> 8]);
+            }
+            _mm512_storeu_si512(states + g, x);
+        }
+    }
+}
+
+#endif // KANG_X86
+
+} // namespace
+
+RansDecodeKernel rans_decode_kernel(SimdLevel level)
+{
+#ifdef KANG_X86
+    switch (level) {
+    case SimdLevel::Avx512: return decode_rounds_avx512;
+    case SimdLevel::Avx2: return decode_rounds_avx2;
+    case SimdLevel::Sse41: return decode_rounds_sse41;
+    default: break;
+    }
+#else
+    (void)level;
+#endif
+    return decode_rounds_scalar;
+}
@@ -0,0 +1,33 @@
+#ifndef RANS_SIMD_H
+#define RANS_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "rans.h"
+#include "cpu_features.h"
+
+// rANS 해제 커널 (rans.cpp 내부용)
+// rounds 라운드 x RANS_LANES 바이트를 out 에 해제. 라운드 안에서는 상태 0 부터 순서대로 진행하고
+// 재정규화 단어도 그 순서로 words 에서 읽음 (인코더가 정확히 역순으로 기록)
+using RansDecodeKernel = void (*)(const uint32_t* table, uint32_t* states, const uint8_t*& words,
+                                  const uint8_t* words_end, uint8_t* out, size_t rounds);
+
+// level 용 커널 (이 빌드에 없는 ISA 면 그 아래 수준)
+RansDecodeKernel rans_decode_kernel(SimdLevel level);
+
+// 상태 하나로 기호 하나 해제 (스칼라 경로, 꼬리 처리)
+inline uint8_t rans_decode_step(const uint32_t* table, uint32_t& x, const uint8_t*& w, const uint8_t* end)
+{
+    const uint32_t e = table[x & (RANS_PROB_SCALE - 1)];
+    x = ((e & 0xfff) + 1) * (x >> RANS_PROB_BITS) + ((e >> 12) & 0xfff);
+    if (x < RANS_STATE_LOW && end - w >= 2) {
+        uint16_t v;
+        std::memcpy(&v, w, sizeof(v));
+        w += 2;
+        x = (x << 16) | v;
+    }
+    return static_cast<uint8_t>(e >> 24);
+}
+
+#endif //RANS_SIMD_H
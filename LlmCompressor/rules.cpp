@@ -0,0 +1,176 @@
+#include "rules.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string trim(const std::string& s)
+{
+    const size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return std::string();
+    const size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+} // namespace
+
+bool parse_tensor_rule(const std::string& spec, TensorRule& rule)
+{
+    rule = TensorRule();
+    rule.spec = trim(spec);
+    const size_t eq = rule.spec.rfind('=');
+    if (eq == std::string::npos || eq == 0) {
+        std::cerr << "Error: Bad rule '" << spec << "' (expected pattern=codec[:level[:transform]])." << std::endl;
+        return false;
+    }
+    rule.pattern = trim(rule.spec.substr(0, eq));
+
+    // codec[:level[:transform]]
+    std::vector<std::string> parts;
+    const std::string value = rule.spec.substr(eq + 1);
+    size_t begin = 0;
+    while (begin <= value.size()) {
+        size_t end = value.find(':', begin);
+        if (end == std::string::npos) end = value.size();
+        parts.push_back(trim(value.substr(begin, end - begin)));
+        begin = end + 1;
+    }
+    const std::string& codec = parts[0];
+    if (codec == "zstd") rule.codec = ChunkCodec::Zstd;
+    else if (codec == "lz4") rule.codec = ChunkCodec::Lz4;
+    else if (codec == "lzma") rule.codec = ChunkCodec::Lzma;
+    else if (codec == "rans") rule.codec = ChunkCodec::Rans;
+    else if (codec == "fpc") rule.codec = ChunkCodec::Fpc;
+    else if (codec == "store") rule.codec = ChunkCodec::Stored;
+    else {
+        std::cerr << "Error: Unknown codec '" << codec << "' in rule '" << spec
+                  << "' (available: zstd, lz4, lzma, rans, fpc, store)." << std::endl;
+        return false;
+    }
+    if (parts.size() > 3) {
+        std::cerr << "Error: Bad rule '" << spec << "' (expected pattern=codec[:level[:transform]])." << std::endl;
+        return false;
+    }
+    if (parts.size() >= 2 && !parts[1].empty()) {
+        try {
+            size_t used = 0;
+            rule.level = std::stoi(parts[1], &used);
+            if (used != parts[1].size() || rule.level < 0 || rule.level > 22) throw std::invalid_argument(parts[1]);
+        } catch (const std::exception&) {
+            std::cerr << "Error: Bad level '" << parts[1] << "' in rule '" << spec << "'." << std::endl;
+            return false;
+        }
+    }
+    if (parts.size() == 3) {
+        if (parts[2] == "split") rule.transform = RuleTransform::Split;
+        else if (parts[2] == "plain") rule.transform = RuleTransform::Plain;
+        else if (parts[2] == "transpose") rule.transform = RuleTransform::Transpose;
+        else {
+            std::cerr << "Error: Unknown transform '" << parts[2] << "' in rule '" << spec
+                      << "' (available: split, plain, transpose)." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool load_tensor_rules(const std::vector<std::string>& specs, const fs::path& rules_file, std::vector<TensorRule>& rules)
+{
+    rules.clear();
+    std::vector<std::string> all;
+    if (!rules_file.empty()) {
+        std::ifstream in(rules_file);
+        if (!in) {
+            std::cerr << "Error: Cannot open rules file " << rules_file.string() << std::endl;
+            return false;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            const size_t comment = line.find('#');
+            if (comment != std::string::npos) line.resize(comment);
+            if (!trim(line).empty()) all.push_back(line);
+        }
+    }
+    all.insert(all.end(), specs.begin(), specs.end());
+    for (const auto& spec : all) {
+        TensorRule rule;
+        if (!parse_tensor_rule(spec, rule)) return false;
+        rules.push_back(std::move(rule));
+    }
+    return true;
+}
+
+bool glob_match(const std::string& pattern, const std::string& name)
+{
+    // 마지막 * 위치로 되돌아가는 반복 매칭 (백트래킹 한 단계)
+    size_t p = 0, n = 0;
+    size_t star = std::string::npos, resume = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p;
+            ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = n;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            n = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+std::vector<uint32_t> match_tensor_rules(const std::vector<TensorRule>& rules, const std::vector<TensorInfo>& tensors)
+{
+    std::vector<uint32_t> matched(tensors.size(), NO_RULE);
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        for (size_t r = 0; r < rules.size(); ++r) {
+            if (glob_match(rules[r].pattern, tensors[i].name)) {
+                matched[i] = static_cast<uint32_t>(r);
+                break;
+            }
+        }
+    }
+    return matched;
+}
+
+void assign_span_rules(const std::vector<TensorInfo>& tensors, const std::vector<uint32_t>& tensor_rules,
+                       std::vector<TensorSpan>& spans)
+{
+    std::map<std::pair<uint64_t, uint64_t>, uint32_t> by_range; // (시작, 길이) -> 규칙
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        if (tensor_rules[i] == NO_RULE || tensors[i].data_end <= tensors[i].data_begin) continue;
+        by_range.emplace(std::make_pair(tensors[i].data_begin, tensors[i].data_end - tensors[i].data_begin), tensor_rules[i]);
+    }
+    for (auto& s : spans) {
+        auto it = by_range.find({ s.offset, s.length });
+        if (it != by_range.end()) s.rule = it->second;
+    }
+}
+
+void print_rule_report(const std::vector<TensorRule>& rules, const std::vector<TensorInfo>& tensors,
+                       const std::vector<uint32_t>& tensor_rules,
+                       const std::vector<std::pair<uint64_t, uint64_t>>& rule_bytes)
+{
+    std::vector<size_t> counts(rules.size() + 1, 0);
+    for (uint32_t r : tensor_rules) ++counts[r == NO_RULE ? rules.size() : r];
+    std::cout << "Rules:" << std::endl;
+    for (size_t r = 0; r <= rules.size(); ++r) {
+        std::cout << "  " << (r < rules.size() ? "[" + std::to_string(r + 1) + "] " + rules[r].spec : std::string("(profile default)"))
+                  << ": " << counts[r] << " tensors, " << rule_bytes[r].first << " -> " << rule_bytes[r].second << " bytes"
+                  << std::endl;
+    }
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        if (tensor_rules[i] == NO_RULE) continue;
+        std::cout << "  " << tensors[i].name << " -> [" << (tensor_rules[i] + 1) << "] " << rules[tensor_rules[i]].spec
+                  << std::endl;
+    }
+}
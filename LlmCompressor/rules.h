@@ -0,0 +1,61 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "archive.h"
+#include "chunking.h"
+#include "safetensors.h"
+
+// --rule / --rules: 텐서별 코덱/레벨/변환 규칙 (저장 등급 기본값을 텐서 이름으로 덮어씀)
+// 규칙 = 'pattern=codec[:level[:transform]]'
+//   pattern   텐서 이름 전체에 대한 glob (* = 아무 문자열, ? = 한 글자)
+//   codec     zstd (CPU libzstd 프레임, ChunkCodec::Zstd) | lz4 | lzma | rans | fpc | store
+//   level     생략하면 -l 값 (store/rans/fpc 는 무시)
+//   transform split (바이트 분할) | plain (변환 없음) | transpose (열 우선 후보까지). 생략하면 등급 기본
+// 규칙 파일은 한 줄에 규칙 하나 (# 뒤는 주석). 파일 규칙 다음에 --rule 순서로 보며 처음 맞는 규칙을 씀.
+// 청크는 규칙이 같은 텐서끼리만 묶이므로 (plan_solid_chunks 가 dtype 과 규칙으로 블록을 나눔) 청크마다 규칙 하나
+enum class RuleTransform : uint8_t {
+    Default,
+    Plain,
+    Split,
+    Transpose,
+};
+
+struct TensorRule {
+    std::string spec;                 // 원문 (리포트용)
+    std::string pattern;
+    ChunkCodec codec = ChunkCodec::Lz4;
+    int level = -1;                   // -1 = -l 값
+    RuleTransform transform = RuleTransform::Default;
+};
+
+constexpr uint32_t NO_RULE = UINT32_MAX;
+
+// 규칙 하나 파싱 (잘못되면 오류 출력 후 false)
+bool parse_tensor_rule(const std::string& spec, TensorRule& rule);
+
+// rules_file (비어 있으면 없음) 의 규칙 다음에 specs 규칙
+bool load_tensor_rules(const std::vector<std::string>& specs, const std::filesystem::path& rules_file,
+                       std::vector<TensorRule>& rules);
+
+// glob 매칭 (* / ?)
+bool glob_match(const std::string& pattern, const std::string& name);
+
+// 텐서마다 처음 맞는 규칙 번호 (없으면 NO_RULE)
+std::vector<uint32_t> match_tensor_rules(const std::vector<TensorRule>& rules, const std::vector<TensorInfo>& tensors);
+
+// 텐서 전체를 덮는 구간에 그 텐서의 규칙을 기록 (빈틈/겹쳐 잘린 텐서는 규칙 없음)
+void assign_span_rules(const std::vector<TensorInfo>& tensors, const std::vector<uint32_t>& tensor_rules,
+                       std::vector<TensorSpan>& spans);
+
+// 리포트: 규칙마다 맞은 텐서 수와 원본 -> 압축 바이트 (rule_bytes 는 규칙 번호별, 마지막 = 규칙 없음),
+// 이어서 규칙이 맞은 텐서마다 맞은 규칙
+void print_rule_report(const std::vector<TensorRule>& rules, const std::vector<TensorInfo>& tensors,
+                       const std::vector<uint32_t>& tensor_rules,
+                       const std::vector<std::pair<uint64_t, uint64_t>>& rule_bytes);
+
+#endif //RULES_H
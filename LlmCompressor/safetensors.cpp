@@ -0,0 +1,248 @@
+#include "safetensors.h"
+#include "file_util.h"
+#include <iostream>
+#include <cstdlib>
+
+namespace {
+
+// safetensors 헤더 전용 최소 JSON 파서 (객체/배열/문자열/정수, 나머지 값은 건너뜀)
+struct JsonParser {
+    const std::string& s;
+    size_t i = 0;
+    bool ok = true;
+
+    explicit JsonParser(const std::string& text) : s(text) {}
+
+    void skip_ws() {
+        while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) ++i;
+    }
+    bool expect(char c) {
+        skip_ws();
+        if (i < s.size() && s[i] == c) { ++i; return true; }
+        ok = false;
+        return false;
+    }
+    bool peek(char c) {
+        skip_ws();
+        return i < s.size() && s[i] == c;
+    }
+
+    std::string parse_string() {
+        std::string out;
+        if (!expect('"')) return out;
+        while (i < s.size() && s[i] != '"') {
+            char c = s[i++];
+            if (c != '\\') { out += c; continue; }
+            if (i >= s.size()) break;
+            char e = s[i++];
+            switch (e) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                if (i + 4 > s.size()) { ok = false; return out; }
+                unsigned cp = static_cast<unsigned>(std::strtoul(s.substr(i, 4).c_str(), nullptr, 16));
+                i += 4;
+                // 서로게이트 쌍 결합
+                if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 <= s.size() && s[i] == '\\' && s[i + 1] == 'u') {
+                    unsigned lo = static_cast<unsigned>(std::strtoul(s.substr(i + 2, 4).c_str(), nullptr, 16));
+                    if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        i += 6;
+                    }
+                }
+                if (cp < 0x80) out += static_cast<char>(cp);
+                else if (cp < 0x800) { out += static_cast<char>(0xC0 | (cp >> 6)); out += static_cast<char>(0x80 | (cp & 0x3F)); }
+                else if (cp < 0x10000) { out += static_cast<char>(0xE0 | (cp >> 12)); out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F)); out += static_cast<char>(0x80 | (cp & 0x3F)); }
+                else { out += static_cast<char>(0xF0 | (cp >> 18)); out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F)); out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F)); out += static_cast<char>(0x80 | (cp & 0x3F)); }
+                break;
+            }
+            default: out += e; break; // \" \\ \/
+            }
+        }
+        if (i >= s.size()) { ok = false; return out; }
+        ++i; // 닫는 따옴표
+        return out;
+    }
+
+    uint64_t parse_uint() {
+        skip_ws();
+        size_t start = i;
+        uint64_t v = 0;
+        while (i < s.size() && s[i] >= '0' && s[i] <= '9') {
+            v = v * 10 + static_cast<uint64_t>(s[i] - '0');
+            ++i;
+        }
+        if (i == start) ok = false;
+        return v;
+    }
+
+    // 관심 없는 값 건너뛰기
+    void skip_value() {
+        skip_ws();
+        if (i >= s.size()) { ok = false; return; }
+        char c = s[i];
+        if (c == '"') { parse_string(); return; }
+        if (c == '{' || c == '[') {
+            const char close = (c == '{') ? '}' : ']';
+            ++i;
+            if (peek(close)) { ++i; return; }
+            while (ok) {
+                if (c == '{') { parse_string(); expect(':'); }
+                skip_value();
+                if (peek(',')) { ++i; continue; }
+                expect(close);
+                return;
+            }
+            return;
+        }
+        // 숫자/true/false/null
+        while (i < s.size() && s[i] != ',' && s[i] != '}' && s[i] != ']' &&
+               s[i] != ' ' && s[i] != '\n' && s[i] != '\r' && s[i] != '\t') ++i;
+    }
+
+    bool parse_tensor(TensorInfo& t) {
+        if (!expect('{')) return false;
+        bool has_offsets = false;
+        if (peek('}')) { ++i; return false; }
+        while (ok) {
+            std::string key = parse_string();
+            expect(':');
+            if (key == "dtype") {
+                t.dtype = parse_string();
+            } else if (key == "shape") {
+                expect('[');
+                if (peek(']')) ++i;
+                else while (ok) {
+                    t.shape.push_back(parse_uint());
+                    if (peek(',')) { ++i; continue; }
+                    expect(']');
+                    break;
+                }
+            } else if (key == "data_offsets") {
+                expect('[');
+                t.data_begin = parse_uint();
+                expect(',');
+                t.data_end = parse_uint();
+                expect(']');
+                has_offsets = true;
+            } else {
+                skip_value();
+            }
+            if (peek(',')) { ++i; continue; }
+            expect('}');
+            break;
+        }
+        return ok && has_offsets && !t.dtype.empty() && t.data_end >= t.data_begin;
+    }
+};
+
+} // namespace
+
+bool parse_safetensors_header(const std::string& json_header, std::vector<TensorInfo>& tensors,
+                              std::string* metadata_json)
+{
+    tensors.clear();
+    JsonParser p(json_header);
+    if (!p.expect('{')) {
+        std::cerr << "Error: safetensors header is not a JSON object." << std::endl;
+        return false;
+    }
+    if (p.peek('}')) return true;
+    while (p.ok) {
+        std::string name = p.parse_string();
+        p.expect(':');
+        if (name == "__metadata__") {
+            p.skip_ws();
+            const size_t start = p.i;
+            p.skip_value();
+            if (metadata_json) *metadata_json = json_header.substr(start, p.i - start);
+        } else {
+            TensorInfo t;
+            t.name = name;
+            if (!p.parse_tensor(t)) {
+                std::cerr << "Error: Invalid tensor entry in safetensors header: " << name << std::endl;
+                return false;
+            }
+            tensors.push_back(std::move(t));
+        }
+        if (p.peek(',')) { ++p.i; continue; }
+        p.expect('}');
+        break;
+    }
+    if (!p.ok) {
+        std::cerr << "Error: Malformed safetensors JSON header." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+void append_json_string(std::string& out, const std::string& s)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += static_cast<char>(c); }
+        else if (c < 0x20) { out += "\\u00"; out += hex[c >> 4]; out += hex[c & 15]; }
+        else out += static_cast<char>(c);
+    }
+    out += '"';
+}
+
+} // namespace
+
+std::string make_safetensors_header(const std::vector<TensorInfo>& tensors, const std::string& metadata_json)
+{
+    std::string out = "{";
+    if (!metadata_json.empty()) out += "\"__metadata__\":" + metadata_json;
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        const TensorInfo& t = tensors[i];
+        if (i || !metadata_json.empty()) out += ',';
+        append_json_string(out, t.name);
+        out += ":{\"dtype\":";
+        append_json_string(out, t.dtype);
+        out += ",\"shape\":[";
+        for (size_t k = 0; k < t.shape.size(); ++k) {
+            if (k) out += ',';
+            out += std::to_string(t.shape[k]);
+        }
+        out += "],\"data_offsets\":[" + std::to_string(t.data_begin) + "," + std::to_string(t.data_end) + "]}";
+    }
+    out += '}';
+    while (out.size() % 8 != 0) out += ' ';
+    return out;
+}
+
+size_t dtype_size(const std::string& dtype)
+{
+    if (dtype == "F64" || dtype == "I64" || dtype == "U64") return 8;
+    if (dtype == "F32" || dtype == "I32" || dtype == "U32") return 4;
+    if (dtype == "F16" || dtype == "BF16" || dtype == "I16" || dtype == "U16") return 2;
+    if (dtype == "F8_E4M3" || dtype == "F8_E5M2" || dtype == "I8" || dtype == "U8" || dtype == "BOOL") return 1;
+    return 0;
+}
+
+// 입력 safetensors 의 헤더만 읽음 (텐서 데이터는 청크 단위로 나중에 읽음)
+bool read_safetensors_header(std::FILE* in, uint64_t file_size, std::string& json_header, uint64_t& data_offset)
+{
+    uint64_t header_len = 0;
+    if (file_size < 8 || !file_read_at(in, 0, &header_len, sizeof(header_len))) {
+        std::cerr << "Error: Invalid safetensors file (too small)." << std::endl;
+        return false;
+    }
+    if (file_size < 8 + header_len) {
+        std::cerr << "Error: Invalid safetensors file (header size mismatch)." << std::endl;
+        return false;
+    }
+    json_header.resize(static_cast<size_t>(header_len));
+    if (header_len > 0 && !file_read_at(in, 8, &json_header[0], json_header.size())) {
+        std::cerr << "Error: Cannot read safetensors header." << std::endl;
+        return false;
+    }
+    data_offset = 8 + header_len;
+    return true;
+}
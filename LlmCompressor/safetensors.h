@@ -0,0 +1,32 @@
+#ifndef SAFETENSORS_H
+#define SAFETENSORS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+// safetensors JSON 헤더의 텐서 항목
+struct TensorInfo {
+    std::string name;
+    std::string dtype;             // "BF16", "F16", "F32", "I64", ...
+    std::vector<uint64_t> shape;
+    uint64_t data_begin = 0;       // 텐서 데이터 영역 기준 오프셋
+    uint64_t data_end = 0;
+};
+
+// JSON 헤더 파싱. 텐서는 헤더에 나온 순서대로, __metadata__ 는 metadata_json 에 원문 그대로 (주면)
+bool parse_safetensors_header(const std::string& json_header, std::vector<TensorInfo>& tensors,
+                              std::string* metadata_json = nullptr);
+
+// 텐서 목록으로 safetensors JSON 헤더 생성 (8바이트 정렬되도록 공백으로 채움)
+std::string make_safetensors_header(const std::vector<TensorInfo>& tensors, const std::string& metadata_json = std::string());
+
+// 입력 safetensors 의 헤더만 읽음 (텐서 데이터는 data_offset 부터 청크 단위로 나중에 읽음)
+bool read_safetensors_header(std::FILE* in, uint64_t file_size, std::string& json_header, uint64_t& data_offset);
+
+// dtype 한 원소의 바이트 수 (알 수 없으면 0)
+size_t dtype_size(const std::string& dtype);
+
+#endif //SAFETENSORS_H
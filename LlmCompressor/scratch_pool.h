@@ -0,0 +1,67 @@
+#ifndef SCRATCH_POOL_H
+#define SCRATCH_POOL_H
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+// 타일 크기: 원본 타일 + 평면 스크래치가 코어별 L2 에 함께 들어가는 크기
+// 변환 -> 코덱 융합 경로는 청크 전체 크기의 중간 버퍼 대신 이 단위로 변환해 바로 인코딩/해제
+constexpr size_t KANG_TILE_BYTES = 256 * 1024;
+
+// 작업 버퍼 풀. 워커가 청크마다 큰 버퍼를 새로 할당/해제하지 않고 빌려 쓰고 돌려줌 (스레드 안전)
+class ScratchPool {
+public:
+    class Lease {
+    public:
+        Lease(ScratchPool& pool, std::vector<char>&& buffer) : pool_(&pool), buffer_(std::move(buffer)) {}
+        Lease(Lease&& other) noexcept : pool_(other.pool_), buffer_(std::move(other.buffer_)) { other.pool_ = nullptr; }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease() { if (pool_) pool_->release(std::move(buffer_)); }
+
+        char* data() { return buffer_.data(); }
+        size_t size() const { return buffer_.size(); }
+
+    private:
+        ScratchPool* pool_;
+        std::vector<char> buffer_;
+    };
+
+    // size 바이트 이상인 버퍼 (내용은 정해지지 않음)
+    Lease acquire(size_t size)
+    {
+        std::vector<char> buffer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                buffer = std::move(free_.back());
+                free_.pop_back();
+            }
+        }
+        if (buffer.size() < size) buffer.resize(size);
+        return Lease(*this, std::move(buffer));
+    }
+
+private:
+    static constexpr size_t MAX_FREE = 64; // 스레드 수보다 넉넉하게, 그 이상은 해제
+
+    void release(std::vector<char>&& buffer)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.size() < MAX_FREE) free_.push_back(std::move(buffer));
+    }
+
+    std::mutex mutex_;
+    std::vector<std::vector<char>> free_;
+};
+
+// 프로세스 전체 풀
+inline ScratchPool& scratch_pool()
+{
+    static ScratchPool pool;
+    return pool;
+}
+
+#endif //SCRATCH_POOL_H
@@ -0,0 +1,282 @@
+#include "seekable.h"
+#include "file_util.h"
+#include "safetensors.h"
+#include "chunking.h"
+#include "tensor_index.h"
+#include "parallel.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <zstd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t ZSTD_FRAME_MAGIC = 0xFD2FB528U;
+const uint8_t SEEKABLE_CHECKSUM_FLAG = 0x80;
+const uint8_t SEEKABLE_RESERVED_BITS = 0x7C;
+
+// 시크 테이블 항목 (체크섬 필드는 쓰지 않음, 프레임 자체에 zstd 내용 체크섬이 있음)
+struct SeekEntry {
+    uint32_t compressed_size;
+    uint32_t decompressed_size;
+};
+
+bool write_u32(std::FILE* f, uint32_t v)
+{
+    return std::fwrite(&v, sizeof(v), 1, f) == 1;
+}
+
+bool read_seek_table(std::FILE* f, uint64_t file_size, std::vector<SeekEntry>& entries)
+{
+    entries.clear();
+    uint32_t num_frames = 0, magic = 0;
+    uint8_t descriptor = 0;
+    if (file_size < 8 + ZSTD_SEEKABLE_FOOTER_SIZE ||
+        !file_read_at(f, file_size - ZSTD_SEEKABLE_FOOTER_SIZE, &num_frames, sizeof(num_frames)) ||
+        std::fread(&descriptor, 1, 1, f) != 1 || std::fread(&magic, sizeof(magic), 1, f) != 1 ||
+        magic != ZSTD_SEEKABLE_FOOTER_MAGIC || (descriptor & SEEKABLE_RESERVED_BITS) != 0) {
+        return false;
+    }
+    const uint64_t entry_size = (descriptor & SEEKABLE_CHECKSUM_FLAG) ? 12 : 8;
+    const uint64_t table_payload = num_frames * entry_size + ZSTD_SEEKABLE_FOOTER_SIZE;
+    if (8 + table_payload > file_size) return false;
+    const uint64_t table_offset = file_size - 8 - table_payload;
+
+    uint32_t table_magic = 0, table_size = 0;
+    if (!file_read_at(f, table_offset, &table_magic, sizeof(table_magic)) ||
+        std::fread(&table_size, sizeof(table_size), 1, f) != 1 ||
+        table_magic != ZSTD_SEEKABLE_TABLE_MAGIC || table_size != table_payload) {
+        return false;
+    }
+    std::vector<char> buf(static_cast<size_t>(num_frames * entry_size));
+    if (!buf.empty() && std::fread(buf.data(), 1, buf.size(), f) != buf.size()) return false;
+    entries.resize(num_frames);
+    uint64_t compressed_total = 0;
+    for (uint32_t i = 0; i < num_frames; ++i) {
+        std::memcpy(&entries[i].compressed_size, buf.data() + i * entry_size, 4);
+        std::memcpy(&entries[i].decompressed_size, buf.data() + i * entry_size + 4, 4);
+        compressed_total += entries[i].compressed_size;
+    }
+    return compressed_total == table_offset;
+}
+
+// 표준 zstd 프레임 하나로 압축 (내용 크기 + 체크섬 포함)
+bool compress_frame(const char* src, size_t size, int level, std::vector<char>& out)
+{
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    if (!cctx) return false;
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, std::max(1, std::min(level, ZSTD_maxCLevel())));
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+    out.resize(ZSTD_compressBound(size));
+    const size_t r = ZSTD_compress2(cctx, out.data(), out.size(), src, size);
+    ZSTD_freeCCtx(cctx);
+    if (ZSTD_isError(r)) {
+        std::cerr << "Error: zstd compression failed: " << ZSTD_getErrorName(r) << std::endl;
+        return false;
+    }
+    out.resize(r);
+    return true;
+}
+
+} // namespace
+
+bool is_seekable_zstd(const fs::path& path)
+{
+    std::FILE* f = file_open(path, "rb");
+    if (!f) return false;
+    uint32_t magic = 0;
+    std::error_code ec;
+    const uint64_t file_size = fs::file_size(path, ec);
+    std::vector<SeekEntry> entries;
+    const bool ok = !ec && file_read_at(f, 0, &magic, sizeof(magic)) && magic == ZSTD_FRAME_MAGIC &&
+                    read_seek_table(f, file_size, entries);
+    std::fclose(f);
+    return ok;
+}
+
+void handle_compression_seekable(const fs::path& input_path, const fs::path& output_path, const CompressOptions& options)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Compressing " << input_path.string() << "\n-> to ->    " << output_path.string()
+              << " (seekable zstd)" << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::FILE* in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open file " << input_path.string() << std::endl;
+        return;
+    }
+    const uint64_t input_size = fs::file_size(input_path);
+    std::string json_header;
+    uint64_t data_offset = 0;
+    if (!read_safetensors_header(in, input_size, json_header, data_offset)) {
+        std::fclose(in);
+        return;
+    }
+    const uint64_t data_size = input_size - data_offset;
+
+    // 프레임 0 은 safetensors 앞부분 전체, 이후 텐서 데이터 프레임 (--rsyncable 이면 텐서 경계 분할)
+    std::vector<size_t> plan(static_cast<size_t>(data_size / KANG_SEEKABLE_FRAME_SIZE), KANG_SEEKABLE_FRAME_SIZE);
+    if (data_size % KANG_SEEKABLE_FRAME_SIZE != 0) plan.push_back(static_cast<size_t>(data_size % KANG_SEEKABLE_FRAME_SIZE));
+    if (options.rsyncable) {
+        std::vector<TensorInfo> tensors;
+        if (!parse_safetensors_header(json_header, tensors)) {
+            std::fclose(in);
+            return;
+        }
+        plan = plan_tensor_aligned_chunks(tensors, data_size);
+    }
+    plan.insert(plan.begin(), static_cast<size_t>(data_offset));
+    if (!options.dict_path.empty()) {
+        std::cout << "Note: --dict is ignored for seekable output (frames must decode with stock zstd)." << std::endl;
+    }
+
+    std::FILE* out = file_open(output_path, "wb");
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        std::fclose(in);
+        return;
+    }
+
+    // 스레드 수만큼 프레임을 묶어 읽고 병렬 압축, 순서대로 기록
+    const size_t threads = default_thread_count();
+    std::vector<SeekEntry> entries;
+    std::vector<std::vector<char>> src(threads), dst(threads);
+    uint64_t pos = 0, compressed_total = 0;
+    bool ok = true;
+    for (size_t first = 0; first < plan.size() && ok; first += threads) {
+        const size_t count = std::min(threads, plan.size() - first);
+        for (size_t k = 0; k < count && ok; ++k) {
+            src[k].resize(plan[first + k]);
+            ok = file_read_at(in, pos, src[k].data(), src[k].size());
+            pos += plan[first + k];
+        }
+        std::atomic<bool> batch_ok{ ok };
+        if (ok) {
+            parallel_for(count, threads, [&](size_t k) {
+                if (!compress_frame(src[k].data(), src[k].size(), options.level, dst[k])) batch_ok = false;
+            });
+        }
+        ok = batch_ok;
+        for (size_t k = 0; k < count && ok; ++k) {
+            ok = std::fwrite(dst[k].data(), 1, dst[k].size(), out) == dst[k].size();
+            entries.push_back({ static_cast<uint32_t>(dst[k].size()), static_cast<uint32_t>(src[k].size()) });
+            if (first + k > 0) compressed_total += dst[k].size();
+        }
+    }
+    std::fclose(in);
+
+    // 시크 테이블 (skippable 프레임이라 zstd -d 는 건너뜀)
+    const uint32_t num_frames = static_cast<uint32_t>(entries.size());
+    ok = ok && write_u32(out, ZSTD_SEEKABLE_TABLE_MAGIC) &&
+         write_u32(out, static_cast<uint32_t>(num_frames * sizeof(SeekEntry) + ZSTD_SEEKABLE_FOOTER_SIZE));
+    for (const auto& e : entries) {
+        ok = ok && write_u32(out, e.compressed_size) && write_u32(out, e.decompressed_size);
+    }
+    const uint8_t descriptor = 0;
+    ok = ok && write_u32(out, num_frames) && std::fwrite(&descriptor, 1, 1, out) == 1 &&
+         write_u32(out, ZSTD_SEEKABLE_FOOTER_MAGIC) && std::fflush(out) == 0;
+    std::fclose(out);
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(output_path, ec);
+        std::cerr << "Compression failed." << std::endl;
+        return;
+    }
+    if (options.write_index) {
+        // 청크 배치가 v1 과 다르므로 텐서 목록만 기록
+        write_tensor_index_file(json_header, data_size, tensor_index_path_for(output_path));
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "JSON header compressed (CPU): " << data_offset << " -> " << entries.front().compressed_size
+              << " bytes" << std::endl;
+    std::cout << "Tensor data compressed (CPU, seekable zstd): " << data_size << " -> " << compressed_total
+              << " bytes in " << (num_frames - 1) << " frames" << std::endl;
+    std::cout << "Compression successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+void handle_decompress_seekable(const fs::path& input_path, const fs::path& output_path)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::FILE* in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open input file " << input_path.string() << std::endl;
+        return;
+    }
+    const uint64_t file_size = fs::file_size(input_path);
+    std::vector<SeekEntry> entries;
+    const bool table_ok = read_seek_table(in, file_size, entries);
+    std::fclose(in);
+    if (!table_ok) {
+        std::cerr << "Error: Seek table is missing or damaged." << std::endl;
+        return;
+    }
+
+    std::vector<uint64_t> comp_pos(entries.size() + 1, 0), out_pos(entries.size() + 1, 0);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        comp_pos[i + 1] = comp_pos[i] + entries[i].compressed_size;
+        out_pos[i + 1] = out_pos[i] + entries[i].decompressed_size;
+    }
+
+    // 출력 미리 할당 후 스레드마다 프레임을 나눠 자기 위치에 기록
+    std::FILE* out = file_open(output_path, "wb");
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        return;
+    }
+    std::fclose(out);
+    std::error_code ec;
+    fs::resize_file(output_path, out_pos.back(), ec);
+    if (ec) {
+        std::cerr << "Error: Cannot allocate output file: " << ec.message() << std::endl;
+        return;
+    }
+
+    const size_t threads = std::min(default_thread_count(), std::max<size_t>(1, entries.size()));
+    std::atomic<bool> ok{ true };
+    parallel_for(threads, threads, [&](size_t worker) {
+        std::FILE* src = file_open(input_path, "rb");
+        std::FILE* dst = file_open(output_path, "r+b");
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        std::vector<char> comp, plain;
+        bool worker_ok = src && dst && dctx;
+        for (size_t i = worker; i < entries.size() && worker_ok && ok; i += threads) {
+            comp.resize(entries[i].compressed_size);
+            plain.resize(entries[i].decompressed_size);
+            worker_ok = file_read_at(src, comp_pos[i], comp.data(), comp.size());
+            if (worker_ok) {
+                const size_t r = ZSTD_decompressDCtx(dctx, plain.data(), plain.size(), comp.data(), comp.size());
+                if (ZSTD_isError(r) || r != plain.size()) {
+                    std::cerr << "Error: Frame " << i << " is corrupted"
+                              << (ZSTD_isError(r) ? std::string(": ") + ZSTD_getErrorName(r) : std::string()) << std::endl;
+                    worker_ok = false;
+                }
+            }
+            worker_ok = worker_ok && file_seek(dst, out_pos[i]) &&
+                        std::fwrite(plain.data(), 1, plain.size(), dst) == plain.size();
+        }
+        worker_ok = worker_ok && std::fflush(dst) == 0;
+        if (!worker_ok) ok = false;
+        ZSTD_freeDCtx(dctx);
+        if (src) std::fclose(src);
+        if (dst) std::fclose(dst);
+    });
+    if (!ok) {
+        fs::remove(output_path, ec);
+        std::cerr << "Decompression failed." << std::endl;
+        return;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Decompressed " << entries.size() << " seekable zstd frames." << std::endl;
+    std::cout << "Decompression successful! Took " << diff.count() << " seconds." << std::endl;
+}
@@ -0,0 +1,28 @@
+#ifndef SEEKABLE_H
+#define SEEKABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include "options.h"
+
+// zstd seekable 형식 호환 출력 (--seekable)
+// [zstd 프레임: safetensors 앞부분 (u64 헤더 길이 + JSON)][zstd 프레임: 텐서 데이터 청크]...[시크 테이블 skippable 프레임]
+// 파일 전체가 표준 zstd 스트림이라 'zstd -d model.kang' 이 원본 .safetensors 를 그대로 복원하고,
+// zstd seekable 리더는 시크 테이블로 임의 위치를 풀 수 있음. 별도 kang 프레이밍은 없음.
+constexpr uint32_t ZSTD_SEEKABLE_TABLE_MAGIC = 0x184D2A5EU;  // skippable 프레임 매직 (0x184D2A5?)
+constexpr uint32_t ZSTD_SEEKABLE_FOOTER_MAGIC = 0x8F92EAB1U;
+constexpr size_t ZSTD_SEEKABLE_FOOTER_SIZE = 9;              // u32 프레임 수 + u8 설명자 + u32 매직
+constexpr size_t KANG_SEEKABLE_FRAME_SIZE = 1024ULL * 1024ULL * 8ULL; // 텐서 데이터 프레임 크기 (임의 접근 단위)
+
+// 시크 테이블로 끝나는 zstd 파일인지 (시작 매직 + 끝 푸터 확인)
+bool is_seekable_zstd(const std::filesystem::path& path);
+
+// 표준 zstd 프레임 + 시크 테이블로 압축 (CPU libzstd, 프레임 단위 병렬)
+void handle_compression_seekable(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                                 const CompressOptions& options);
+
+// 시크 테이블을 읽어 프레임들을 병렬로 풀어 미리 할당한 출력에 기록
+void handle_decompress_seekable(const std::filesystem::path& input_path, const std::filesystem::path& output_path);
+
+#endif //SEEKABLE_H
@@ -0,0 +1,533 @@
+#include "store.h"
+#include "archive.h"
+#include "blake3.h"
+#include "chunking.h"
+#include "compressor.cuh"
+#include "file_util.h"
+#include "parallel.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char CATALOG_SIGNATURE[8] = { 'K', 'A', 'N', 'G', 'S', 'T', 'O', 'R' };
+constexpr uint32_t CATALOG_VERSION = 1;
+constexpr uint32_t MANIFEST_VERSION = 1;
+
+struct StoreEntry {
+    uint32_t pack = 0;
+    uint64_t offset = 0;
+    uint64_t compressed_size = 0;
+    uint64_t original_size = 0;
+    uint8_t codec = 0;              // ChunkCodec
+    int8_t level = 0;
+    uint32_t refcount = 0;
+};
+
+struct ChunkStore {
+    fs::path dir;
+    std::unordered_map<std::string, StoreEntry> entries; // 키: BLAKE3 32바이트
+    uint32_t next_pack = 1;
+};
+
+struct ManifestChunk {
+    std::string id;
+    uint64_t size = 0;
+};
+
+fs::path catalog_path(const fs::path& dir) { return dir / "catalog.kst"; }
+
+fs::path pack_path(const fs::path& dir, uint32_t pack)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%06u.kpk", pack);
+    return dir / "packs" / name;
+}
+
+// 디렉터리 생성으로 잠금 (이미 있으면 다른 프로세스가 사용 중)
+class StoreLock {
+public:
+    explicit StoreLock(const fs::path& dir) : path_(dir / "lock")
+    {
+        std::error_code ec;
+        fs::create_directories(dir / "packs", ec);
+        locked_ = fs::create_directory(path_, ec);
+        if (!locked_) {
+            std::cerr << "Error: Store is locked by another process (remove " << path_.string()
+                      << " if it is stale)." << std::endl;
+        }
+    }
+    ~StoreLock()
+    {
+        std::error_code ec;
+        if (locked_) fs::remove(path_, ec);
+    }
+    bool locked() const { return locked_; }
+
+private:
+    fs::path path_;
+    bool locked_ = false;
+};
+
+bool load_catalog(const fs::path& dir, ChunkStore& store)
+{
+    store.dir = dir;
+    store.entries.clear();
+    store.next_pack = 1;
+    const fs::path path = catalog_path(dir);
+    if (!fs::exists(path)) return true; // 새 저장소
+
+    std::FILE* f = file_open(path, "rb");
+    char sig[8];
+    uint32_t version = 0;
+    uint64_t count = 0;
+    bool ok = f && std::fread(sig, 1, sizeof(sig), f) == sizeof(sig) &&
+              std::memcmp(sig, CATALOG_SIGNATURE, sizeof(sig)) == 0 &&
+              std::fread(&version, sizeof(version), 1, f) == 1 && version == CATALOG_VERSION &&
+              std::fread(&store.next_pack, sizeof(store.next_pack), 1, f) == 1 && file_read_u64(f, count);
+    for (uint64_t i = 0; i < count && ok; ++i) {
+        char id[BLAKE3_OUT_LEN];
+        StoreEntry e;
+        ok = std::fread(id, 1, sizeof(id), f) == sizeof(id) &&
+             std::fread(&e.pack, sizeof(e.pack), 1, f) == 1 && file_read_u64(f, e.offset) &&
+             file_read_u64(f, e.compressed_size) && file_read_u64(f, e.original_size) &&
+             std::fread(&e.codec, 1, 1, f) == 1 && std::fread(&e.level, 1, 1, f) == 1 &&
+             std::fread(&e.refcount, sizeof(e.refcount), 1, f) == 1;
+        if (ok) store.entries.emplace(std::string(id, sizeof(id)), e);
+    }
+    if (f) std::fclose(f);
+    if (!ok) std::cerr << "Error: Store catalog is corrupted: " << path.string() << std::endl;
+    return ok;
+}
+
+// 임시 파일에 쓰고 동기화한 뒤 교체 (중간에 죽어도 이전 카탈로그 유지)
+bool save_catalog(const ChunkStore& store)
+{
+    const fs::path path = catalog_path(store.dir);
+    const fs::path tmp = path.string() + ".tmp";
+    std::FILE* f = file_open(tmp, "wb");
+    const uint64_t count = store.entries.size();
+    bool ok = f && std::fwrite(CATALOG_SIGNATURE, 1, sizeof(CATALOG_SIGNATURE), f) == sizeof(CATALOG_SIGNATURE) &&
+              std::fwrite(&CATALOG_VERSION, sizeof(CATALOG_VERSION), 1, f) == 1 &&
+              std::fwrite(&store.next_pack, sizeof(store.next_pack), 1, f) == 1 && file_write_u64(f, count);
+    for (const auto& kv : store.entries) {
+        if (!ok) break;
+        const StoreEntry& e = kv.second;
+        ok = std::fwrite(kv.first.data(), 1, BLAKE3_OUT_LEN, f) == BLAKE3_OUT_LEN &&
+             std::fwrite(&e.pack, sizeof(e.pack), 1, f) == 1 && file_write_u64(f, e.offset) &&
+             file_write_u64(f, e.compressed_size) && file_write_u64(f, e.original_size) &&
+             std::fwrite(&e.codec, 1, 1, f) == 1 && std::fwrite(&e.level, 1, 1, f) == 1 &&
+             std::fwrite(&e.refcount, sizeof(e.refcount), 1, f) == 1;
+    }
+    ok = ok && file_sync(f);
+    if (f) ok = (std::fclose(f) == 0) && ok;
+    std::error_code ec;
+    if (ok) {
+        fs::rename(tmp, path, ec);
+        ok = !ec;
+    }
+    if (!ok) std::cerr << "Error: Cannot write store catalog " << path.string() << std::endl;
+    return ok;
+}
+
+bool write_manifest(const fs::path& path, uint64_t file_size, const std::vector<ManifestChunk>& chunks)
+{
+    std::FILE* f = file_open(path, "wb");
+    const uint32_t reserved = 0;
+    bool ok = f && std::fwrite(KANG_MANIFEST_SIGNATURE.data(), 1, KANG_MANIFEST_SIGNATURE.size(), f) == KANG_MANIFEST_SIGNATURE.size() &&
+              std::fwrite(&MANIFEST_VERSION, sizeof(MANIFEST_VERSION), 1, f) == 1 &&
+              std::fwrite(&reserved, sizeof(reserved), 1, f) == 1 &&
+              file_write_u64(f, file_size) && file_write_u64(f, chunks.size());
+    for (const auto& c : chunks) {
+        ok = ok && std::fwrite(c.id.data(), 1, BLAKE3_OUT_LEN, f) == BLAKE3_OUT_LEN && file_write_u64(f, c.size);
+    }
+    if (f) ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::cerr << "Error: Cannot write manifest " << path.string() << std::endl;
+    return ok;
+}
+
+bool read_manifest(const fs::path& path, uint64_t& file_size, std::vector<ManifestChunk>& chunks)
+{
+    std::FILE* f = file_open(path, "rb");
+    char sig[8];
+    uint32_t version = 0, reserved = 0;
+    uint64_t count = 0;
+    bool ok = f && std::fread(sig, 1, sizeof(sig), f) == sizeof(sig) &&
+              std::string(sig, sig + 8) == KANG_MANIFEST_SIGNATURE &&
+              std::fread(&version, sizeof(version), 1, f) == 1 && version == MANIFEST_VERSION &&
+              std::fread(&reserved, sizeof(reserved), 1, f) == 1 &&
+              file_read_u64(f, file_size) && file_read_u64(f, count);
+    chunks.clear();
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < count && ok; ++i) {
+        char id[BLAKE3_OUT_LEN];
+        ManifestChunk c;
+        ok = std::fread(id, 1, sizeof(id), f) == sizeof(id) && file_read_u64(f, c.size);
+        c.id.assign(id, sizeof(id));
+        total += c.size;
+        chunks.push_back(std::move(c));
+    }
+    if (f) std::fclose(f);
+    if (!ok || total != file_size) {
+        std::cerr << "Error: Not a valid store manifest: " << path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 파일 하나 저장: 분할 -> 병렬 해시 -> 새 청크만 병렬 압축 -> 카탈로그 -> 매니페스트
+bool store_file(ChunkStore& store, const fs::path& input_path, const fs::path& manifest_path,
+                int compression_level, size_t threads, uint64_t& new_bytes)
+{
+    MappedFile mapped;
+    const uint64_t file_size = fs::file_size(input_path);
+    if (file_size > 0 && !map_file(input_path, mapped)) {
+        std::cerr << "Error: Cannot open file " << input_path.string() << std::endl;
+        return false;
+    }
+
+    // 1. safetensors 면 헤더를 따로 한 청크로 두고 텐서 데이터만 내용 기반 분할
+    std::vector<size_t> plan;
+    uint64_t head = 0;
+    if (file_size >= sizeof(uint64_t)) {
+        uint64_t header_len = 0;
+        std::memcpy(&header_len, mapped.data, sizeof(header_len));
+        if (header_len <= file_size - sizeof(uint64_t) && header_len <= KANG_CDC_MAX_SIZE) head = sizeof(uint64_t) + header_len;
+    }
+    if (head > 0) plan.push_back(static_cast<size_t>(head));
+    const std::vector<size_t> payload_plan =
+        plan_content_defined_chunks(mapped.data + head, static_cast<size_t>(file_size - head));
+    plan.insert(plan.end(), payload_plan.begin(), payload_plan.end());
+    std::vector<uint64_t> starts(plan.size() + 1, 0);
+    for (size_t i = 0; i < plan.size(); ++i) starts[i + 1] = starts[i] + plan[i];
+
+    // 2. 청크 ID 병렬 계산
+    std::vector<ManifestChunk> chunks(plan.size());
+    parallel_for(plan.size(), threads, [&](size_t i) {
+        uint8_t hash[BLAKE3_OUT_LEN];
+        blake3_hash(mapped.data + starts[i], plan[i], hash);
+        chunks[i].id.assign(reinterpret_cast<const char*>(hash), BLAKE3_OUT_LEN);
+        chunks[i].size = plan[i];
+    });
+
+    // 3. 저장소에 없는 청크만 (파일 안 중복도 한 번만)
+    std::vector<size_t> fresh;
+    std::unordered_set<std::string> seen;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (!store.entries.count(chunks[i].id) && seen.insert(chunks[i].id).second) fresh.push_back(i);
+    }
+
+    // 4. 새 청크를 스레드별 묶음으로 압축해 현재 팩 끝에 붙임
+    uint32_t pack = store.next_pack - 1;
+    if (pack == 0 || (fs::exists(pack_path(store.dir, pack)) && fs::file_size(pack_path(store.dir, pack)) >= KANG_STORE_PACK_LIMIT)) {
+        pack = store.next_pack++;
+    }
+    std::FILE* out = file_open(pack_path(store.dir, pack), "ab");
+    if (!out || !file_seek_end(out)) {
+        std::cerr << "Error: Cannot open pack " << pack_path(store.dir, pack).string() << std::endl;
+        if (out) std::fclose(out);
+        unmap_file(mapped);
+        return false;
+    }
+    std::mutex out_mutex;
+    std::unordered_map<std::string, StoreEntry> added;
+    const size_t groups = std::min(std::max<size_t>(threads, 1), fresh.size());
+    std::atomic<bool> failed{ false };
+    parallel_for(groups, threads, [&](size_t g) {
+        const size_t begin = fresh.size() * g / groups;
+        const size_t end = fresh.size() * (g + 1) / groups;
+        std::vector<size_t> sizes;
+        for (size_t k = begin; k < end; ++k) sizes.push_back(plan[fresh[k]]);
+        bool ok = compress_chunks_streaming(
+            sizes, 0,
+            [&](size_t k, size_t) -> const char* { return mapped.data + starts[fresh[begin + k]]; },
+            [&](size_t k, const char* data, size_t original_size, size_t compressed_size) {
+                std::lock_guard<std::mutex> lock(out_mutex);
+                StoreEntry e;
+                e.pack = pack;
+                e.offset = file_tell(out);
+                e.compressed_size = compressed_size;
+                e.original_size = original_size;
+                e.codec = static_cast<uint8_t>(ChunkCodec::NvcompZstd);
+                e.level = static_cast<int8_t>(NVCOMP_ZSTD_LEVEL);
+                if (std::fwrite(data, 1, compressed_size, out) != compressed_size) return false;
+                added[chunks[fresh[begin + k]].id] = e;
+                return true;
+            },
+            compression_level);
+        if (!ok) failed = true;
+    });
+    bool ok = !failed && file_sync(out);
+    ok = (std::fclose(out) == 0) && ok;
+    unmap_file(mapped);
+    if (!ok) {
+        std::cerr << "Error: Failed to store " << input_path.string() << std::endl;
+        return false;
+    }
+
+    // 5. 참조 수 반영 후 카탈로그 먼저 저장 (매니페스트가 없는 청크를 가리키는 일이 없도록)
+    for (auto& kv : added) {
+        new_bytes += kv.second.compressed_size;
+        store.entries.emplace(kv.first, kv.second);
+    }
+    for (const auto& c : chunks) ++store.entries[c.id].refcount;
+    if (!save_catalog(store)) return false;
+    if (!write_manifest(manifest_path, file_size, chunks)) return false;
+
+    std::cout << input_path.filename().string() << ": " << chunks.size() << " chunks, " << fresh.size()
+              << " new, " << (chunks.size() - fresh.size()) << " deduplicated" << std::endl;
+    return true;
+}
+
+} // namespace
+
+void handle_store_add(const fs::path& store_dir, const fs::path& input_path, const fs::path& output_path,
+                      int compression_level, size_t threads)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Storing " << input_path.string() << "\n-> in ->  " << store_dir.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    StoreLock lock(store_dir);
+    ChunkStore store;
+    if (!lock.locked() || !load_catalog(store_dir, store)) return;
+
+    // 폴더면 .safetensors 전부, 매니페스트는 같은 상대 경로에 .kang 으로
+    std::vector<std::pair<fs::path, fs::path>> jobs;
+    if (fs::is_directory(input_path)) {
+        for (const auto& entry : fs::recursive_directory_iterator(input_path)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".safetensors") continue;
+            fs::path out = output_path / fs::relative(entry.path(), input_path);
+            out.replace_extension(".kang");
+            jobs.emplace_back(entry.path(), out);
+        }
+    } else {
+        jobs.emplace_back(input_path, output_path);
+    }
+
+    uint64_t input_bytes = 0, new_bytes = 0;
+    for (const auto& job : jobs) {
+        if (job.second.has_parent_path()) fs::create_directories(job.second.parent_path());
+        if (!store_file(store, job.first, job.second, compression_level, threads, new_bytes)) {
+            std::cerr << "Store add failed." << std::endl;
+            return;
+        }
+        input_bytes += fs::file_size(job.first);
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Stored " << jobs.size() << " files: " << input_bytes << " bytes, " << new_bytes
+              << " new compressed bytes added to the store" << std::endl;
+    std::cout << "Store add successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+void handle_store_get(const fs::path& store_dir, const fs::path& manifest_path, const fs::path& output_path)
+{
+    std::cout << "----------------------------------------------------" << std::endl;
+    std::cout << "Restoring " << manifest_path.string() << "\n-> to ->   " << output_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    uint64_t file_size = 0;
+    std::vector<ManifestChunk> chunks;
+    StoreLock lock(store_dir);
+    ChunkStore store;
+    if (!read_manifest(manifest_path, file_size, chunks) || !lock.locked() || !load_catalog(store_dir, store)) return;
+
+    // 같은 팩에 이어지는 청크들을 한 번에 해제 (코덱별 처리는 v2 아카이브와 공유)
+    std::FILE* out = file_open(output_path, "wb");
+    if (!out) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        return;
+    }
+    bool ok = true;
+    size_t i = 0;
+    while (ok && i < chunks.size()) {
+        auto it = store.entries.find(chunks[i].id);
+        if (it == store.entries.end()) {
+            std::cerr << "Error: Chunk " << blake3_hex(reinterpret_cast<const uint8_t*>(chunks[i].id.data()))
+                      << " is missing from the store." << std::endl;
+            ok = false;
+            break;
+        }
+        const uint32_t pack = it->second.pack;
+        ArchiveIndex run;
+        std::vector<size_t> ids;
+        size_t j = i;
+        for (; j < chunks.size(); ++j) {
+            auto e = store.entries.find(chunks[j].id);
+            if (e == store.entries.end() || e->second.pack != pack) break;
+            ArchiveChunk c;
+            c.offset = e->second.offset;
+            c.compressed_size = e->second.compressed_size;
+            c.original_size = e->second.original_size;
+            c.codec = e->second.codec;
+            ids.push_back(run.chunks.size());
+            run.chunks.push_back(c);
+        }
+        std::FILE* pf = file_open(pack_path(store_dir, pack), "rb");
+        ok = pf && decode_archive_chunks(pf, run, ids, [&](size_t k, const char* data, size_t size) {
+            uint8_t hash[BLAKE3_OUT_LEN];
+            blake3_hash(data, size, hash);
+            if (std::memcmp(hash, chunks[i + k].id.data(), BLAKE3_OUT_LEN) != 0) {
+                std::cerr << "Error: Chunk " << blake3_hex(hash) << " failed verification." << std::endl;
+                return false;
+            }
+            return std::fwrite(data, 1, size, out) == size;
+        });
+        if (pf) std::fclose(pf);
+        i = j;
+    }
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Restore failed." << std::endl;
+        return;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Restored " << file_size << " bytes from " << chunks.size() << " chunks" << std::endl;
+    std::cout << "Restore successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+void handle_store_remove(const fs::path& store_dir, const std::vector<fs::path>& manifests)
+{
+    StoreLock lock(store_dir);
+    ChunkStore store;
+    if (!lock.locked() || !load_catalog(store_dir, store)) return;
+
+    for (const auto& path : manifests) {
+        uint64_t file_size = 0;
+        std::vector<ManifestChunk> chunks;
+        if (!read_manifest(path, file_size, chunks)) return;
+        for (const auto& c : chunks) {
+            auto it = store.entries.find(c.id);
+            if (it != store.entries.end() && it->second.refcount > 0) --it->second.refcount;
+        }
+        // 참조 수를 먼저 저장 (도중에 죽어도 청크가 새는 쪽으로만 틀어짐)
+        if (!save_catalog(store)) return;
+        std::error_code ec;
+        fs::remove(path, ec);
+        std::cout << "Removed " << path.string() << " (" << chunks.size() << " chunk references)" << std::endl;
+    }
+    std::cout << "Run 'kang store gc' to reclaim space." << std::endl;
+}
+
+void handle_store_gc(const fs::path& store_dir)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Collecting garbage in " << store_dir.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    StoreLock lock(store_dir);
+    ChunkStore store;
+    if (!lock.locked() || !load_catalog(store_dir, store)) return;
+
+    // 1. 참조 없는 청크 제거
+    size_t dropped = 0;
+    for (auto it = store.entries.begin(); it != store.entries.end();) {
+        if (it->second.refcount == 0) {
+            it = store.entries.erase(it);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+
+    // 2. 팩별 살아 있는 청크 (오프셋 순)
+    std::map<uint32_t, std::vector<StoreEntry*>> live;
+    for (auto& kv : store.entries) live[kv.second.pack].push_back(&kv.second);
+    uint64_t before = 0, after = 0;
+    std::vector<fs::path> obsolete;
+    for (const auto& entry : fs::directory_iterator(store_dir / "packs")) {
+        if (entry.path().extension() != ".kpk") continue;
+        const uint64_t size = entry.file_size();
+        before += size;
+        const uint32_t pack = static_cast<uint32_t>(std::strtoul(entry.path().stem().string().c_str(), nullptr, 10));
+        auto it = live.find(pack);
+        uint64_t live_bytes = 0;
+        if (it != live.end()) {
+            for (const StoreEntry* e : it->second) live_bytes += e->compressed_size;
+        }
+        if (live_bytes == size) {
+            after += size;
+            continue;
+        }
+        obsolete.push_back(entry.path());
+        if (live_bytes == 0) continue;
+
+        // 3. 죽은 공간이 있는 팩은 살아 있는 청크만 새 팩으로 복사
+        std::vector<StoreEntry*>& entries = it->second;
+        std::sort(entries.begin(), entries.end(), [](const StoreEntry* a, const StoreEntry* b) { return a->offset < b->offset; });
+        const uint32_t new_pack = store.next_pack++;
+        std::FILE* in = file_open(entry.path(), "rb");
+        std::FILE* out = file_open(pack_path(store_dir, new_pack), "wb");
+        bool ok = in && out;
+        std::vector<char> buf;
+        for (StoreEntry* e : entries) {
+            if (!ok) break;
+            buf.resize(static_cast<size_t>(e->compressed_size));
+            ok = file_read_at(in, e->offset, buf.data(), buf.size());
+            e->pack = new_pack;
+            e->offset = file_tell(out);
+            ok = ok && std::fwrite(buf.data(), 1, buf.size(), out) == buf.size();
+        }
+        ok = ok && file_sync(out);
+        if (in) std::fclose(in);
+        if (out) ok = (std::fclose(out) == 0) && ok;
+        if (!ok) {
+            std::cerr << "Error: Cannot rewrite pack " << entry.path().string() << ", catalog left unchanged." << std::endl;
+            return;
+        }
+        after += live_bytes;
+    }
+
+    // 4. 카탈로그 저장 후에만 이전 팩 삭제
+    if (!save_catalog(store)) return;
+    std::error_code ec;
+    for (const auto& p : obsolete) fs::remove(p, ec);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Dropped " << dropped << " unreferenced chunks, compacted " << obsolete.size() << " packs: "
+              << before << " -> " << after << " bytes" << std::endl;
+    std::cout << "GC successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+void handle_store_stat(const fs::path& store_dir)
+{
+    ChunkStore store;
+    if (!load_catalog(store_dir, store)) return;
+    uint64_t logical = 0, unique = 0, stored = 0, unreferenced = 0;
+    for (const auto& kv : store.entries) {
+        const StoreEntry& e = kv.second;
+        logical += e.original_size * e.refcount;
+        unique += e.original_size;
+        stored += e.compressed_size;
+        if (e.refcount == 0) ++unreferenced;
+    }
+    uint64_t on_disk = 0;
+    std::error_code ec;
+    if (fs::is_directory(store_dir / "packs", ec)) {
+        for (const auto& entry : fs::directory_iterator(store_dir / "packs")) {
+            if (entry.path().extension() == ".kpk") on_disk += entry.file_size();
+        }
+    }
+    std::cout << "Chunks:        " << store.entries.size() << " (" << unreferenced << " unreferenced)" << std::endl;
+    std::cout << "Logical bytes: " << logical << std::endl;
+    std::cout << "Unique bytes:  " << unique << std::endl;
+    std::cout << "Stored bytes:  " << stored << " (" << on_disk << " on disk)" << std::endl;
+    if (stored > 0) {
+        std::cout << "Overall ratio: " << static_cast<double>(logical) / static_cast<double>(stored) << "x" << std::endl;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef STORE_H
+#define STORE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+// 내용 주소 청크 저장소 (여러 체크포인트/파인튜닝 간 중복 제거)
+// <store>/catalog.kst   : 청크 ID(BLAKE3) -> 팩 위치, 크기, 참조 수
+// <store>/packs/*.kpk   : 압축 청크를 이어 붙인 팩 파일 (추가 전용, gc 때만 다시 씀)
+// <store>/lock          : 쓰기 잠금 (디렉터리 생성으로 원자적 획득)
+// 파일은 FastCDC 로 나눠 청크별로 한 번만 압축/저장하고, .kang 자리에는 청크 ID 목록(매니페스트)만 남김.
+inline const std::string KANG_MANIFEST_SIGNATURE = "KANGMAN1";
+constexpr const char* KANG_STORE_ENV = "KANG_STORE";
+
+// 새 팩 파일로 넘어가는 크기
+constexpr uint64_t KANG_STORE_PACK_LIMIT = 1024ULL * 1024ULL * 1024ULL * 4ULL; // 4GB
+
+// 파일(또는 폴더의 .safetensors)을 저장소에 넣고 매니페스트 기록
+void handle_store_add(const std::filesystem::path& store_dir, const std::filesystem::path& input_path,
+                      const std::filesystem::path& output_path, int compression_level, size_t threads);
+
+// 매니페스트로 원본 복원 (청크마다 BLAKE3 검증)
+void handle_store_get(const std::filesystem::path& store_dir, const std::filesystem::path& manifest_path,
+                      const std::filesystem::path& output_path);
+
+// 매니페스트 삭제 + 참조 수 감소 (공간 회수는 gc)
+void handle_store_remove(const std::filesystem::path& store_dir, const std::vector<std::filesystem::path>& manifests);
+
+// 참조 없는 청크 제거, 죽은 공간이 있는 팩 다시 기록
+void handle_store_gc(const std::filesystem::path& store_dir);
+
+// 저장소 통계 (논리 크기, 고유 크기, 중복 제거율)
+void handle_store_stat(const std::filesystem::path& store_dir);
+
+#endif //STORE_H
@@ -0,0 +1,337 @@
+#include "tensor_index.h"
+#include "safetensors.h"
+#include "file_util.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+uint64_t align8(uint64_t v)
+{
+    return (v + 7) & ~uint64_t(7);
+}
+
+uint64_t name_hash(std::string_view name)
+{
+    return fnv1a64(name.data(), name.size());
+}
+
+// 섹션을 8바이트 정렬로 이어 붙임
+struct SectionBuilder {
+    std::vector<char> body;
+    KidxSectionRef refs[KIDX_MAX_SECTIONS] = {};
+
+    void add(uint32_t id, const void* data, size_t size)
+    {
+        body.resize(static_cast<size_t>(align8(body.size())), 0);
+        refs[id].offset = sizeof(KidxHeader) + body.size();
+        refs[id].size = size;
+        const char* p = static_cast<const char*>(data);
+        body.insert(body.end(), p, p + size);
+    }
+    template <typename T>
+    void add(uint32_t id, const std::vector<T>& v)
+    {
+        add(id, v.data(), v.size() * sizeof(T));
+    }
+};
+
+} // namespace
+
+bool build_tensor_index(const std::string& json_header, uint64_t data_size, std::vector<char>& out,
+                        const KidxChunkLayout* chunks)
+{
+    std::vector<TensorInfo> tensors;
+    if (!parse_safetensors_header(json_header, tensors)) return false;
+    std::sort(tensors.begin(), tensors.end(), [](const TensorInfo& a, const TensorInfo& b) { return a.name < b.name; });
+
+    const uint64_t n = tensors.size();
+    std::string name_pool;
+    std::vector<uint64_t> name_offsets;
+    std::vector<uint8_t> dtype_codes, ndims;
+    std::vector<std::string> dtype_names;
+    std::vector<uint32_t> shape_start;
+    std::vector<uint64_t> shape_pool, data_begin, data_end;
+
+    for (const auto& t : tensors) {
+        name_offsets.push_back(name_pool.size());
+        name_pool += t.name;
+
+        auto it = std::find(dtype_names.begin(), dtype_names.end(), t.dtype);
+        if (it == dtype_names.end()) {
+            if (dtype_names.size() == 255) return false;
+            dtype_names.push_back(t.dtype);
+            it = dtype_names.end() - 1;
+        }
+        dtype_codes.push_back(static_cast<uint8_t>(it - dtype_names.begin()));
+
+        if (t.shape.size() > 255) return false;
+        ndims.push_back(static_cast<uint8_t>(t.shape.size()));
+        shape_start.push_back(static_cast<uint32_t>(shape_pool.size()));
+        shape_pool.insert(shape_pool.end(), t.shape.begin(), t.shape.end());
+
+        if (t.data_end > data_size) {
+            std::cerr << "Error: Tensor " << t.name << " points past the tensor data." << std::endl;
+            return false;
+        }
+        data_begin.push_back(t.data_begin);
+        data_end.push_back(t.data_end);
+    }
+    name_offsets.push_back(name_pool.size());
+    shape_start.push_back(static_cast<uint32_t>(shape_pool.size()));
+
+    std::string dtype_pool;
+    for (const auto& d : dtype_names) {
+        dtype_pool += d;
+        dtype_pool += '\0';
+    }
+
+    // 적재율 50% 이하 해시 테이블
+    uint64_t slots = 16;
+    while (slots < n * 2) slots <<= 1;
+    std::vector<uint32_t> table(static_cast<size_t>(slots), 0);
+    for (uint64_t i = 0; i < n; ++i) {
+        uint64_t h = name_hash(tensors[i].name) & (slots - 1);
+        while (table[h] != 0) h = (h + 1) & (slots - 1);
+        table[h] = static_cast<uint32_t>(i + 1);
+    }
+
+    SectionBuilder b;
+    b.add(KIDX_NAME_POOL, name_pool.data(), name_pool.size());
+    b.add(KIDX_NAME_OFFSETS, name_offsets);
+    b.add(KIDX_DTYPE, dtype_codes);
+    b.add(KIDX_DTYPE_NAMES, dtype_pool.data(), dtype_pool.size());
+    b.add(KIDX_NDIM, ndims);
+    b.add(KIDX_SHAPE_START, shape_start);
+    b.add(KIDX_SHAPE_POOL, shape_pool);
+    b.add(KIDX_DATA_BEGIN, data_begin);
+    b.add(KIDX_DATA_END, data_end);
+    b.add(KIDX_HASH_TABLE, table);
+
+    uint32_t flags = 0;
+    if (chunks) {
+        // 청크 절대 오프셋 + 텐서가 걸친 청크 범위
+        const size_t c = chunks->chunk_info.size();
+        std::vector<uint64_t> offsets(c), comp_sizes(c), starts(c + 1, 0);
+        uint64_t offset = chunks->payload_offset;
+        for (size_t k = 0; k < c; ++k) {
+            offsets[k] = offset;
+            comp_sizes[k] = chunks->chunk_info[k].second;
+            starts[k + 1] = starts[k] + chunks->chunk_info[k].first;
+            offset += chunks->chunk_info[k].second;
+        }
+        if (starts[c] != data_size || offset > chunks->archive_size) {
+            std::cerr << "Error: Chunk table does not match the tensor data size." << std::endl;
+            return false;
+        }
+        std::vector<uint32_t> chunk_begin(static_cast<size_t>(n)), chunk_end(static_cast<size_t>(n));
+        for (uint64_t i = 0; i < n; ++i) {
+            // data_begin 을 포함하는 청크 ~ data_end - 1 을 포함하는 청크
+            auto first = std::upper_bound(starts.begin(), starts.end(), data_begin[i]) - starts.begin() - 1;
+            auto last = (data_end[i] > data_begin[i])
+                ? std::lower_bound(starts.begin(), starts.end(), data_end[i]) - starts.begin()
+                : first;
+            chunk_begin[i] = static_cast<uint32_t>(std::max<std::ptrdiff_t>(first, 0));
+            chunk_end[i] = static_cast<uint32_t>(std::max<std::ptrdiff_t>(last, first));
+        }
+        const uint64_t info[3] = { chunks->archive_size, chunks->payload_offset, c };
+        b.add(KIDX_ARCHIVE_INFO, info, sizeof(info));
+        b.add(KIDX_CHUNK_OFFSET, offsets);
+        b.add(KIDX_CHUNK_COMP_SIZE, comp_sizes);
+        b.add(KIDX_CHUNK_DATA_START, starts);
+        b.add(KIDX_TENSOR_CHUNK_BEGIN, chunk_begin);
+        b.add(KIDX_TENSOR_CHUNK_END, chunk_end);
+        flags |= KIDX_FLAG_CHUNKS;
+    }
+
+    KidxHeader h{};
+    std::memcpy(h.magic, KIDX_MAGIC, sizeof(KIDX_MAGIC));
+    h.version = KIDX_VERSION;
+    h.flags = flags;
+    h.tensor_count = n;
+    h.hash_slots = slots;
+    h.header_hash = fnv1a64(json_header.data(), json_header.size());
+    h.header_size = json_header.size();
+    h.data_size = data_size;
+    std::memcpy(h.sections, b.refs, sizeof(h.sections));
+
+    out.resize(sizeof(KidxHeader));
+    std::memcpy(out.data(), &h, sizeof(h));
+    out.insert(out.end(), b.body.begin(), b.body.end());
+    return true;
+}
+
+bool write_tensor_index_file(const std::string& json_header, uint64_t data_size, const fs::path& path,
+                             const KidxChunkLayout* chunks)
+{
+    std::vector<char> buf;
+    if (!build_tensor_index(json_header, data_size, buf, chunks)) {
+        std::cerr << "Warning: Could not build tensor index, skipping " << path.string() << std::endl;
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Warning: Cannot create tensor index " << path.string() << std::endl;
+        return false;
+    }
+    out.write(buf.data(), buf.size());
+    out.close();
+    const KidxHeader* h = reinterpret_cast<const KidxHeader*>(buf.data());
+    std::cout << "Tensor index written: " << h->tensor_count << " tensors";
+    if (chunks) std::cout << ", " << chunks->chunk_info.size() << " chunks";
+    std::cout << " -> " << path.string() << std::endl;
+    return true;
+}
+
+fs::path tensor_index_path_for(const fs::path& archive_path)
+{
+    fs::path p = archive_path;
+    return p.replace_extension(".kidx");
+}
+
+bool open_tensor_index(const char* data, size_t size, TensorIndexView& view)
+{
+    view = TensorIndexView();
+    if (size < sizeof(KidxHeader)) return false;
+    const KidxHeader* h = reinterpret_cast<const KidxHeader*>(data);
+    if (std::memcmp(h->magic, KIDX_MAGIC, sizeof(KIDX_MAGIC)) != 0 || h->version != KIDX_VERSION) return false;
+
+    const uint64_t n = h->tensor_count;
+    for (uint32_t i = 0; i < KIDX_MAX_SECTIONS; ++i) {
+        if (h->sections[i].offset > size || h->sections[i].size > size - h->sections[i].offset) return false;
+    }
+    // 섹션 크기가 텐서 수와 맞는지 확인 (잘린/손상 파일 방지)
+    if (h->sections[KIDX_NAME_OFFSETS].size != (n + 1) * 8 ||
+        h->sections[KIDX_DTYPE].size != n ||
+        h->sections[KIDX_NDIM].size != n ||
+        h->sections[KIDX_SHAPE_START].size != (n + 1) * 4 ||
+        h->sections[KIDX_DATA_BEGIN].size != n * 8 ||
+        h->sections[KIDX_DATA_END].size != n * 8 ||
+        h->hash_slots == 0 || (h->hash_slots & (h->hash_slots - 1)) != 0 ||
+        h->sections[KIDX_HASH_TABLE].size != h->hash_slots * 4) {
+        return false;
+    }
+    if (h->flags & KIDX_FLAG_CHUNKS) {
+        if (h->sections[KIDX_ARCHIVE_INFO].size != 24) return false;
+        uint64_t info[3];
+        std::memcpy(info, data + h->sections[KIDX_ARCHIVE_INFO].offset, sizeof(info));
+        const uint64_t c = info[2];
+        if (h->sections[KIDX_CHUNK_OFFSET].size != c * 8 ||
+            h->sections[KIDX_CHUNK_COMP_SIZE].size != c * 8 ||
+            h->sections[KIDX_CHUNK_DATA_START].size != (c + 1) * 8 ||
+            h->sections[KIDX_TENSOR_CHUNK_BEGIN].size != n * 4 ||
+            h->sections[KIDX_TENSOR_CHUNK_END].size != n * 4) {
+            return false;
+        }
+    }
+    view.base = data;
+    view.size = size;
+    view.header = h;
+    const uint64_t* name_offsets = view.section<uint64_t>(KIDX_NAME_OFFSETS);
+    const uint32_t* shape_start = view.section<uint32_t>(KIDX_SHAPE_START);
+    if (name_offsets[n] > h->sections[KIDX_NAME_POOL].size ||
+        static_cast<uint64_t>(shape_start[n]) * 8 > h->sections[KIDX_SHAPE_POOL].size) {
+        view = TensorIndexView();
+        return false;
+    }
+    // 조회 때 그대로 따라가는 값들 (이름/shape 위치는 줄지 않아야, 해시 슬롯은 텐서 번호 + 1 이하, 청크 범위는 청크 수 이하)
+    bool valid = h->sections[KIDX_DTYPE_NAMES].size == 0 ||
+                 data[h->sections[KIDX_DTYPE_NAMES].offset + h->sections[KIDX_DTYPE_NAMES].size - 1] == '\0';
+    for (uint64_t i = 0; i < n && valid; ++i) {
+        valid = name_offsets[i] <= name_offsets[i + 1] && shape_start[i] <= shape_start[i + 1];
+    }
+    const uint32_t* table = view.section<uint32_t>(KIDX_HASH_TABLE);
+    for (uint64_t s = 0; s < h->hash_slots && valid; ++s) valid = table[s] <= n;
+    if (valid && (h->flags & KIDX_FLAG_CHUNKS)) {
+        const uint64_t c = view.section<uint64_t>(KIDX_ARCHIVE_INFO)[2];
+        const uint32_t* chunk_begin = view.section<uint32_t>(KIDX_TENSOR_CHUNK_BEGIN);
+        const uint32_t* chunk_end = view.section<uint32_t>(KIDX_TENSOR_CHUNK_END);
+        for (uint64_t i = 0; i < n && valid; ++i) valid = chunk_begin[i] <= chunk_end[i] && chunk_end[i] <= c;
+    }
+    if (!valid) {
+        view = TensorIndexView();
+        return false;
+    }
+    return true;
+}
+
+int64_t find_tensor(const TensorIndexView& view, std::string_view name)
+{
+    const uint64_t mask = view.header->hash_slots - 1;
+    const uint32_t* table = view.section<uint32_t>(KIDX_HASH_TABLE);
+    uint64_t h = name_hash(name) & mask;
+    for (uint64_t probe = 0; probe <= mask; ++probe) {
+        const uint32_t slot = table[h];
+        if (slot == 0) return -1;
+        if (kidx_tensor_name(view, slot - 1) == name) return static_cast<int64_t>(slot - 1);
+        h = (h + 1) & mask;
+    }
+    return -1;
+}
+
+std::string_view kidx_tensor_name(const TensorIndexView& view, uint64_t i)
+{
+    const uint64_t* offsets = view.section<uint64_t>(KIDX_NAME_OFFSETS);
+    const char* pool = view.section<char>(KIDX_NAME_POOL);
+    return std::string_view(pool + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i]));
+}
+
+std::string_view kidx_tensor_dtype(const TensorIndexView& view, uint64_t i)
+{
+    const uint8_t code = view.section<uint8_t>(KIDX_DTYPE)[i];
+    const char* p = view.section<char>(KIDX_DTYPE_NAMES);
+    const char* end = p + view.header->sections[KIDX_DTYPE_NAMES].size;
+    for (uint8_t k = 0; k < code && p < end; ++k) p += std::strlen(p) + 1;
+    return p < end ? std::string_view(p) : std::string_view();
+}
+
+std::vector<uint64_t> kidx_tensor_shape(const TensorIndexView& view, uint64_t i)
+{
+    const uint32_t* start = view.section<uint32_t>(KIDX_SHAPE_START);
+    const uint64_t* pool = view.section<uint64_t>(KIDX_SHAPE_POOL);
+    return std::vector<uint64_t>(pool + start[i], pool + start[i + 1]);
+}
+
+void handle_lookup(const fs::path& index_path, const std::vector<std::string>& names)
+{
+    MappedFile mapped;
+    if (!map_file(index_path, mapped)) {
+        std::cerr << "Error: Cannot open tensor index " << index_path.string() << std::endl;
+        return;
+    }
+    TensorIndexView view;
+    if (!open_tensor_index(mapped.data, mapped.size, view)) {
+        std::cerr << "Error: Not a valid .kidx tensor index." << std::endl;
+        unmap_file(mapped);
+        return;
+    }
+
+    if (names.empty()) {
+        std::cout << view.header->tensor_count << " tensors, header " << view.header->header_size
+                  << " bytes, tensor data " << view.header->data_size << " bytes" << std::endl;
+    }
+    const uint64_t data_base = 8 + view.header->header_size;
+    for (const auto& name : names) {
+        const int64_t i = find_tensor(view, name);
+        if (i < 0) {
+            std::cout << name << ": not found" << std::endl;
+            continue;
+        }
+        const uint64_t begin = view.section<uint64_t>(KIDX_DATA_BEGIN)[i];
+        const uint64_t end = view.section<uint64_t>(KIDX_DATA_END)[i];
+        std::cout << name << ": " << kidx_tensor_dtype(view, static_cast<uint64_t>(i)) << " [";
+        const auto shape = kidx_tensor_shape(view, static_cast<uint64_t>(i));
+        for (size_t k = 0; k < shape.size(); ++k) std::cout << (k ? ", " : "") << shape[k];
+        std::cout << "] data_offsets [" << begin << ", " << end << "] file offset " << (data_base + begin);
+        if (kidx_has_chunks(view)) {
+            std::cout << " chunks [" << view.section<uint32_t>(KIDX_TENSOR_CHUNK_BEGIN)[i] << ", "
+                      << view.section<uint32_t>(KIDX_TENSOR_CHUNK_END)[i] << ")";
+        }
+        std::cout << std::endl;
+    }
+    unmap_file(mapped);
+}
@@ -0,0 +1,108 @@
+#ifndef TENSOR_INDEX_H
+#define TENSOR_INDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+
+// .kidx 바이너리 텐서 인덱스
+// 압축 시 JSON 헤더를 미리 파싱해 두어, 로더가 mmap 만으로 텐서를 O(1) 조회할 수 있게 함.
+// [KidxHeader][섹션들...] 모든 섹션은 8바이트 정렬, 텐서별 필드는 배열 구조체(SoA) 레이아웃.
+// 원본 JSON 헤더는 .kang 에 그대로 남아 바이트 단위 복원에 사용됨.
+constexpr char KIDX_MAGIC[8] = { 'K', 'A', 'N', 'G', 'K', 'I', 'D', 'X' };
+constexpr uint32_t KIDX_VERSION = 1;
+constexpr uint32_t KIDX_MAX_SECTIONS = 16;
+
+enum KidxSection : uint32_t {
+    KIDX_NAME_POOL = 0,   // 텐서 이름 바이트 (이름 정렬 순)
+    KIDX_NAME_OFFSETS,    // u64[n+1], 이름 풀 내 위치
+    KIDX_DTYPE,           // u8[n], dtype 이름 표 번호
+    KIDX_DTYPE_NAMES,     // "BF16\0F32\0..." (NUL 구분)
+    KIDX_NDIM,            // u8[n]
+    KIDX_SHAPE_START,     // u32[n+1], shape 풀 내 위치
+    KIDX_SHAPE_POOL,      // u64[]
+    KIDX_DATA_BEGIN,      // u64[n], 텐서 데이터 영역 기준 시작
+    KIDX_DATA_END,        // u64[n]
+    KIDX_HASH_TABLE,      // u32[slots], 0 = 빈 슬롯, 그 외 텐서 번호 + 1 (선형 탐사)
+    // 아래는 KIDX_FLAG_CHUNKS 일 때만 존재 (v1 .kang 랜덤 액세스용)
+    KIDX_ARCHIVE_INFO,    // u64[3]: 아카이브 크기, 첫 청크 오프셋, 청크 수
+    KIDX_CHUNK_OFFSET,    // u64[c], 압축 청크의 아카이브 내 절대 오프셋
+    KIDX_CHUNK_COMP_SIZE, // u64[c]
+    KIDX_CHUNK_DATA_START,// u64[c+1], 청크가 담는 텐서 데이터 시작 위치 (마지막 = 데이터 크기)
+    KIDX_TENSOR_CHUNK_BEGIN, // u32[n], 텐서가 걸친 첫 청크
+    KIDX_TENSOR_CHUNK_END,   // u32[n], 마지막 청크 + 1 (빈 텐서는 begin == end)
+};
+
+// KidxHeader::flags
+constexpr uint32_t KIDX_FLAG_CHUNKS = 1;
+
+struct KidxSectionRef {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct KidxHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t tensor_count;
+    uint64_t hash_slots;         // 2의 거듭제곱
+    uint64_t header_hash;        // 원본 JSON 헤더 FNV-1a (인덱스가 최신인지 확인용)
+    uint64_t header_size;        // 원본 JSON 헤더 길이 (텐서 데이터는 8 + header_size 부터)
+    uint64_t data_size;          // 텐서 데이터 영역 크기
+    KidxSectionRef sections[KIDX_MAX_SECTIONS];
+};
+
+// v1 .kang 의 청크 배치 (있으면 인덱스에 청크 오프셋/텐서-청크 매핑 섹션 추가)
+struct KidxChunkLayout {
+    uint64_t archive_size = 0;
+    uint64_t payload_offset = 0;
+    std::vector<std::pair<size_t, size_t>> chunk_info; // <original_size, compressed_size>
+};
+
+// JSON 헤더로 인덱스 바이트 생성
+bool build_tensor_index(const std::string& json_header, uint64_t data_size, std::vector<char>& out,
+                        const KidxChunkLayout* chunks = nullptr);
+
+// 인덱스를 만들어 파일로 기록 (실패해도 압축 자체는 계속되도록 경고만 출력)
+bool write_tensor_index_file(const std::string& json_header, uint64_t data_size, const std::filesystem::path& path,
+                             const KidxChunkLayout* chunks = nullptr);
+
+// .kang 에 대응하는 사이드카 경로 (model.kang -> model.kidx)
+std::filesystem::path tensor_index_path_for(const std::filesystem::path& archive_path);
+
+// 메모리(mmap)에 올린 인덱스 조회용 뷰
+struct TensorIndexView {
+    const char* base = nullptr;
+    size_t size = 0;
+    const KidxHeader* header = nullptr;
+
+    template <typename T>
+    const T* section(uint32_t id) const
+    {
+        return reinterpret_cast<const T*>(base + header->sections[id].offset);
+    }
+};
+
+// 섹션 크기와 조회가 따라가는 값(이름/shape 위치, 해시 슬롯, 청크 범위)을 검사. 손상된 인덱스면 false
+bool open_tensor_index(const char* data, size_t size, TensorIndexView& view);
+
+// 이름으로 텐서 번호 조회 (해시 테이블, 없으면 -1)
+int64_t find_tensor(const TensorIndexView& view, std::string_view name);
+
+std::string_view kidx_tensor_name(const TensorIndexView& view, uint64_t i);
+std::string_view kidx_tensor_dtype(const TensorIndexView& view, uint64_t i);
+std::vector<uint64_t> kidx_tensor_shape(const TensorIndexView& view, uint64_t i);
+
+inline bool kidx_has_chunks(const TensorIndexView& view)
+{
+    return (view.header->flags & KIDX_FLAG_CHUNKS) != 0;
+}
+
+// 인덱스로 텐서 조회 (names 가 비어 있으면 요약만 출력)
+void handle_lookup(const std::filesystem::path& index_path, const std::vector<std::string>& names);
+
+#endif //TENSOR_INDEX_H
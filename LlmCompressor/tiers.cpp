@@ -0,0 +1,358 @@
+#include "tiers.h"
+#include "archive.h"
+#include "chunk_codec.h"
+#include "rans.h"
+#include "chunking.h"
+#include "moe.h"
+#include "gguf.h"
+#include "rules.h"
+#include "tensor_index.h"
+#include "file_util.h"
+#include "safetensors.h"
+#include "parallel.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 청크 원본을 계획의 구간 순서대로 읽어 이어 붙임 (구간은 파일 절대 오프셋)
+bool read_planned_chunk(std::FILE* in, const PlannedChunk& chunk, std::vector<char>& out)
+{
+    out.resize(static_cast<size_t>(chunk.size()));
+    size_t pos = 0;
+    for (const auto& r : chunk.ranges) {
+        if (!file_read_at(in, r.offset, out.data() + pos, static_cast<size_t>(r.length))) return false;
+        pos += static_cast<size_t>(r.length);
+    }
+    return true;
+}
+
+// rANS 로 인코딩할 텐서 청크(XOR 잔차 청크 제외)를 한 번 읽어 (dtype, 평면) 별 바이트 빈도를 모으고 공유 rANS 표로 정규화
+bool build_shared_rans_tables(std::FILE* in, const std::vector<PlannedChunk>& plan, const std::vector<ChunkCodec>& codecs,
+                              size_t threads, RansSharedTables& shared)
+{
+    const size_t num_chunks = plan.size();
+    auto shared_candidate = [&](size_t id) { return codecs[id] == ChunkCodec::Rans && plan[id].reference == UINT64_MAX; };
+    std::vector<std::vector<uint64_t>> totals(256); // DType -> 평면 * 256
+    std::vector<std::vector<char>> src(threads);
+    std::vector<std::vector<uint64_t>> counts(threads);
+    std::vector<const DTypeKernels*> kernels(threads);
+    for (size_t first = 1; first < num_chunks; first += threads) {
+        const size_t count = std::min(threads, num_chunks - first);
+        for (size_t k = 0; k < count; ++k) {
+            if (!shared_candidate(first + k)) src[k].clear();
+            else if (!read_planned_chunk(in, plan[first + k], src[k])) return false;
+        }
+        parallel_for(count, threads, [&](size_t k) {
+            kernels[k] = shared_candidate(first + k) ? dtype_kernels(plan[first + k].dtype) : nullptr;
+            if (!kernels[k] || src[k].size() < kernels[k]->width) {
+                kernels[k] = nullptr;
+                return;
+            }
+            counts[k].assign(256 * kernels[k]->width, 0);
+            rans_plane_histograms(*kernels[k], kernels[k]->kind != DTypeKind::Unsigned, src[k].data(), src[k].size(),
+                                  counts[k].data());
+        });
+        for (size_t k = 0; k < count; ++k) {
+            if (!kernels[k]) continue;
+            std::vector<uint64_t>& total = totals[static_cast<uint8_t>(kernels[k]->dtype)];
+            total.resize(counts[k].size(), 0);
+            for (size_t i = 0; i < total.size(); ++i) total[i] += counts[k][i];
+        }
+    }
+    for (size_t d = 0; d < totals.size(); ++d) {
+        for (size_t plane = 0; plane * 256 < totals[d].size(); ++plane) {
+            RansTable t;
+            t.dtype = static_cast<DType>(d);
+            t.plane = static_cast<uint8_t>(plane);
+            rans_normalize_freqs(&totals[d][plane * 256], t.freq);
+            shared.tables.push_back(t);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void handle_compression_tiered(const fs::path& input_path, const fs::path& output_path, const CompressOptions& options)
+{
+    const bool cold = options.profile == CompressProfile::Cold;
+    const bool entropy = options.profile == CompressProfile::Entropy;
+    const ChunkCodec codec = cold ? ChunkCodec::Lzma : entropy ? ChunkCodec::Rans : ChunkCodec::Lz4;
+    const size_t chunk_size = cold ? KANG_COLD_CHUNK_SIZE : KANG_FASTLOAD_CHUNK_SIZE;
+    const bool byte_split = options.byte_split || entropy;
+    const char* codec_name = cold ? "LZMA2" : entropy ? "rANS" : options.level >= KANG_LZ4HC_MIN_LEVEL ? "LZ4-HC" : "LZ4";
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Compressing " << input_path.string() << "\n-> to ->    " << output_path.string()
+              << (cold ? " (cold, " : entropy ? " (entropy, " : " (fast-load, ") << codec_name
+              << (byte_split ? " + byte split" : "") << ")" << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::FILE* in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open file " << input_path.string() << std::endl;
+        return;
+    }
+    const uint64_t input_size = fs::file_size(input_path);
+    std::string json_header;
+    uint64_t data_offset = 0;
+    std::vector<TensorInfo> tensors;
+    GgufHeader gguf;
+    const bool is_gguf = is_gguf_file(in);
+    if (is_gguf) {
+        if (options.rsyncable) {
+            std::cerr << "Error: --rsyncable is not supported for GGUF input." << std::endl;
+            std::fclose(in);
+            return;
+        }
+        if (!read_gguf_header(in, input_size, gguf)) {
+            std::fclose(in);
+            return;
+        }
+        tensors = gguf.tensors;
+        data_offset = gguf.data_offset;
+    }
+    else if (!read_safetensors_header(in, input_size, json_header, data_offset) ||
+             !parse_safetensors_header(json_header, tensors)) {
+        std::fclose(in);
+        return;
+    }
+    const uint64_t data_size = input_size - data_offset;
+
+    // --rule: 텐서마다 처음 맞는 규칙 (규칙이 있으면 규칙이 같은 텐서끼리만 청크로 묶음)
+    std::vector<TensorRule> rules;
+    if (!load_tensor_rules(options.rules, options.rules_file, rules)) {
+        std::fclose(in);
+        return;
+    }
+    const std::vector<uint32_t> tensor_rules = match_tensor_rules(rules, tensors);
+
+    // 청크 0 = safetensors/GGUF 앞부분 (헤더), 이후 텐서 데이터 청크
+    // (--rsyncable 이면 텐서 경계, --solid/--transpose/--moe 면 작은 텐서 블록 + 행렬 행 묶음, --reorder 면 텐서를 모은 순서로,
+    //  GGUF 는 양자화 텐서를 블록 경계에서 자른 자기 청크 + 나머지 솔리드)
+    std::vector<PlannedChunk> plan;
+    const bool solid = options.solid || options.transpose || options.moe || !rules.empty();
+    if (is_gguf || solid || options.reorder) {
+        std::vector<TensorSpan> spans = tensor_spans(tensors, data_size, options.reorder);
+        assign_span_rules(tensors, tensor_rules, spans);
+        plan = is_gguf ? plan_gguf_chunks(gguf, spans, chunk_size)
+             : solid ? plan_solid_chunks(spans, chunk_size) : plan_sliced_chunks(spans, chunk_size);
+    } else {
+        std::vector<size_t> sizes(static_cast<size_t>(data_size / chunk_size), chunk_size);
+        if (data_size % chunk_size != 0) sizes.push_back(static_cast<size_t>(data_size % chunk_size));
+        if (options.rsyncable) sizes = plan_tensor_aligned_chunks(tensors, data_size);
+        uint64_t pos = 0;
+        for (size_t size : sizes) {
+            PlannedChunk c;
+            c.ranges.push_back({ pos, size });
+            c.dtype = dominant_dtype(tensors, pos, pos + size);
+            plan.push_back(std::move(c));
+            pos += size;
+        }
+    }
+    for (auto& c : plan) {
+        for (auto& r : c.ranges) r.offset += data_offset;
+    }
+    PlannedChunk header;
+    header.ranges.push_back({ 0, data_offset });
+    plan.insert(plan.begin(), std::move(header));
+
+    // --moe: 잔차 전문가의 청크마다 참조 전문가의 같은 위치 청크를 참조로 (같은 모양이라 행 단위 분할 위치가 같음)
+    size_t expert_clusters = 0, xor_chunks = 0;
+    if (options.moe) {
+        std::vector<ExpertDelta> deltas;
+        if (!plan_expert_deltas(in, data_offset, tensors, KANG_SOLID_SMALL_TENSOR, deltas, expert_clusters)) {
+            std::fclose(in);
+            return;
+        }
+        std::map<std::pair<uint64_t, uint64_t>, size_t> single; // (시작, 길이) -> 구간 하나짜리 청크
+        for (size_t i = 1; i < plan.size(); ++i) {
+            if (plan[i].ranges.size() == 1) single[{ plan[i].ranges[0].offset, plan[i].ranges[0].length }] = i;
+        }
+        for (const auto& d : deltas) {
+            const TensorInfo& t = tensors[d.tensor];
+            const TensorInfo& r = tensors[d.reference];
+            for (size_t i = 1; i < plan.size(); ++i) {
+                if (plan[i].ranges.size() != 1) continue;
+                const ChunkRange& range = plan[i].ranges[0];
+                if (range.offset < data_offset + t.data_begin || range.offset + range.length > data_offset + t.data_end) continue;
+                auto ref = single.find({ range.offset - t.data_begin + r.data_begin, range.length });
+                if (ref == single.end()) continue;
+                plan[i].reference = ref->second;
+                plan[i].columns = 0; // aux 는 참조 번호에 씀
+                ++xor_chunks;
+            }
+        }
+    }
+
+    std::FILE* out = file_open(output_path, "wb");
+    if (!out || !write_v2_signature(out)) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        if (out) std::fclose(out);
+        std::fclose(in);
+        return;
+    }
+
+    ArchiveIndex index;
+    ArchiveFile af;
+    af.path = input_path.filename().string();
+    af.size = input_size;
+
+    const size_t threads = default_thread_count();
+
+    // --rule 청크는 규칙 코덱, --fpc 면 나머지 fp32/fp64 청크는 등급 코덱 대신 FPC 예측 코더
+    std::vector<ChunkCodec> codecs(plan.size(), codec);
+    for (size_t i = 1; i < plan.size(); ++i) {
+        if (plan[i].rule != NO_RULE) codecs[i] = rules[plan[i].rule].codec;
+    }
+    size_t fpc_chunks = 0;
+    for (size_t i = 1; i < plan.size() && options.fpc; ++i) {
+        if ((plan[i].dtype == DType::F32 || plan[i].dtype == DType::F64) && plan[i].reference == UINT64_MAX &&
+            plan[i].rule == NO_RULE) {
+            codecs[i] = ChunkCodec::Fpc;
+            ++fpc_chunks;
+        }
+    }
+
+    // entropy: 모델 전체의 (dtype, 평면) 분포로 공유 표를 만들어 청크들이 참조 (분포가 다른 청크만 자체 표)
+    RansSharedTables shared;
+    if (entropy) {
+        if (!build_shared_rans_tables(in, plan, codecs, threads, shared)) {
+            std::cerr << "Error: Cannot read " << input_path.string() << std::endl;
+            std::fclose(in);
+            std::fclose(out);
+            std::error_code ec;
+            fs::remove(output_path, ec);
+            return;
+        }
+        if (!shared.tables.empty()) index.extra_sections[SECTION_RANS_TABLES] = serialize_rans_tables(shared.tables);
+    }
+
+    // 스레드 수만큼 청크를 읽어 병렬 압축, 순서대로 기록
+    std::vector<std::vector<char>> src(threads), dst(threads);
+    std::vector<ArchiveChunk> meta(threads);
+    std::vector<char> reference;
+    std::vector<std::pair<uint64_t, ArchiveExtent>> pieces; // (파일 오프셋, extent)
+    size_t split_chunks = 0;
+    size_t transposed_chunks = 0;
+    size_t quant_chunks = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> rule_bytes(rules.size() + 1, { 0, 0 }); // 규칙별 원본/압축 (마지막 = 규칙 없음)
+    bool ok = true;
+    for (size_t first = 0; first < plan.size() && ok; first += threads) {
+        const size_t count = std::min(threads, plan.size() - first);
+        for (size_t k = 0; k < count && ok; ++k) {
+            ok = read_planned_chunk(in, plan[first + k], src[k]);
+            if (ok && plan[first + k].reference != UINT64_MAX) {
+                ok = read_planned_chunk(in, plan[plan[first + k].reference], reference);
+                if (ok) xor_bytes(src[k].data(), reference.data(), src[k].size());
+            }
+        }
+        std::atomic<bool> batch_ok{ ok };
+        if (ok) {
+            parallel_for(count, threads, [&](size_t k) {
+                // 헤더 청크는 변환 없음. 텐서 청크는 주된 dtype 으로 바이트 분할 (LZMA 는 분할 안 해도 정렬 힌트로 사용)
+                // --rule 이 있으면 규칙의 레벨/변환, GGUF 양자화 청크는 블록 필드별 스트림으로 (QuantSplit)
+                meta[k] = ArchiveChunk();
+                const PlannedChunk& chunk = plan[first + k];
+                const ChunkCodec chunk_codec = codecs[first + k];
+                const TensorRule* rule = chunk.rule != NO_RULE ? &rules[chunk.rule] : nullptr;
+                const RuleTransform transform = rule ? rule->transform : RuleTransform::Default;
+                const int level = rule && rule->level >= 0 ? rule->level : options.level;
+                const bool split = transform == RuleTransform::Default ? byte_split : transform != RuleTransform::Plain;
+                const bool transpose = transform == RuleTransform::Default ? options.transpose : transform == RuleTransform::Transpose;
+                bool encoded = true;
+                if (chunk_codec == ChunkCodec::Stored) {
+                    meta[k].original_size = src[k].size();
+                    meta[k].codec = static_cast<uint8_t>(ChunkCodec::Stored);
+                    dst[k] = src[k];
+                }
+                else if (chunk.quant != UINT32_MAX && transform != RuleTransform::Plain) {
+                    encoded = encode_quant_chunk(chunk_codec, src[k].data(), src[k].size(), level, chunk.quant, meta[k], dst[k]);
+                }
+                else {
+                    encoded = encode_cpu_chunk(chunk_codec, src[k].data(), src[k].size(), level, chunk.dtype, split, meta[k],
+                                               dst[k], entropy ? &shared : nullptr, transpose ? chunk.columns : 0);
+                }
+                if (!encoded) batch_ok = false;
+                if (plan[first + k].reference != UINT64_MAX) {
+                    meta[k].transform |= CHUNK_TRANSFORM_XOR_REFERENCE;
+                    meta[k].aux = static_cast<uint32_t>(plan[first + k].reference);
+                }
+            });
+        }
+        ok = batch_ok;
+        for (size_t k = 0; k < count && ok; ++k) {
+            meta[k].offset = file_tell(out);
+            meta[k].compressed_size = dst[k].size();
+            ok = std::fwrite(dst[k].data(), 1, dst[k].size(), out) == dst[k].size();
+            const uint8_t transform = meta[k].transform & ~CHUNK_TRANSFORM_XOR_REFERENCE;
+            if (transform == static_cast<uint8_t>(ChunkTransform::QuantSplit)) ++quant_chunks;
+            else if (transform != static_cast<uint8_t>(ChunkTransform::None)) ++split_chunks;
+            if (transform == static_cast<uint8_t>(ChunkTransform::TransposeSplit)) ++transposed_chunks;
+            uint64_t chunk_offset = 0;
+            for (const auto& r : plan[first + k].ranges) {
+                pieces.push_back({ r.offset, { index.chunks.size(), chunk_offset, r.length } });
+                chunk_offset += r.length;
+            }
+            auto& bytes = rule_bytes[plan[first + k].rule == NO_RULE ? rules.size() : plan[first + k].rule];
+            bytes.first += meta[k].original_size;
+            bytes.second += dst[k].size();
+            index.chunks.push_back(meta[k]);
+        }
+    }
+    std::fclose(in);
+
+    // 파일 순서로 정렬한 구간이 곧 extent 목록 (솔리드 블록 안 텐서 위치 표)
+    std::sort(pieces.begin(), pieces.end(),
+              [](const std::pair<uint64_t, ArchiveExtent>& a, const std::pair<uint64_t, ArchiveExtent>& b) {
+                  return a.first < b.first;
+              });
+    for (const auto& p : pieces) {
+        const ArchiveExtent& e = p.second;
+        if (!af.extents.empty() && af.extents.back().chunk == e.chunk &&
+            af.extents.back().chunk_offset + af.extents.back().length == e.chunk_offset) {
+            af.extents.back().length += e.length;
+        } else {
+            af.extents.push_back(e);
+        }
+    }
+
+    const uint64_t payload_end = file_tell(out);
+    index.files.push_back(std::move(af));
+    ok = ok && write_archive_index(out, index);
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(output_path, ec);
+        std::cerr << "Compression failed." << std::endl;
+        return;
+    }
+    if (options.write_index && !is_gguf) {
+        // 청크 위치는 v2 인덱스(CHNK/FILE)에 있으므로 텐서 목록만 기록
+        write_tensor_index_file(json_header, data_size, tensor_index_path_for(output_path));
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Compressed (CPU " << codec_name << "): " << input_size << " -> " << (payload_end - KANG_V2_SIGNATURE.size())
+              << " bytes in " << index.chunks.size() << " chunks";
+    if (byte_split) {
+        std::cout << " (" << split_chunks << " byte-split";
+        if (transposed_chunks > 0) std::cout << ", " << transposed_chunks << " column-major";
+        std::cout << ")";
+    }
+    if (quant_chunks > 0) std::cout << ", " << quant_chunks << " quant-block split";
+    if (fpc_chunks > 0) std::cout << ", " << fpc_chunks << " FPC";
+    if (options.moe) std::cout << ", " << expert_clusters << " expert clusters (" << xor_chunks << " XOR chunks)";
+    if (!shared.tables.empty()) std::cout << ", " << shared.tables.size() << " shared rANS tables";
+    std::cout << std::endl;
+    if (!rules.empty()) print_rule_report(rules, tensors, tensor_rules, rule_bytes);
+    std::cout << "Compression successful! Took " << diff.count() << " seconds." << std::endl;
+}
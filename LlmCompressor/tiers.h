@@ -0,0 +1,25 @@
+#ifndef TIERS_H
+#define TIERS_H
+
+#include <filesystem>
+#include "options.h"
+
+// CPU 코덱 저장 등급 (--profile). 결과는 파일 하나짜리 v2 아카이브이며 청크마다 독립 압축이라
+// decompress/unpack 이 코어 수만큼 병렬 해제하고, transcode --codec 으로 등급 간 이동 가능.
+// fast-load: KANG_FASTLOAD_CHUNK_SIZE 청크 LZ4/LZ4-HC. 용량보다 로드 지연이 중요한 서빙용
+// cold:      KANG_COLD_CHUNK_SIZE 청크 LZMA2(xz). 압축/해제가 느린 대신 zstd -19 보다 높은 압축률 (보관용)
+// entropy:   KANG_FASTLOAD_CHUNK_SIZE 청크를 바이트 분할하고 평면마다 rANS (rans.h). 매치 탐색 없이 지수/상위 바이트의
+//            편향만 취하므로 LZ4 보다 작고 SIMD 해제로 코어당 수 GB/s
+// byte_split 이면 청크마다 주된 dtype 크기로 바이트 분할 후 압축 (entropy 는 항상).
+// solid 면 큰 텐서는 자기 청크, 작은 텐서는 dtype 별 블록으로 모아 압축 (plan_solid_chunks)
+// fpc 면 주된 dtype 이 F32/F64 인 청크는 등급 코덱 대신 FPC 예측 코더 (fpc.h). --solid 와 함께 쓰면 텐서 단위로 갈림
+// transpose 면 solid 계획의 행렬 청크마다 열 우선 배치가 나은지 추정해 전치 후 분할 (ChunkTransform::TransposeSplit)
+// moe 면 solid 계획에서 비슷한 전문가 청크를 참조 전문가 청크와의 XOR 잔차로 인코딩 (CHUNK_TRANSFORM_XOR_REFERENCE)
+// 입력이 GGUF 면 KV/텐서 정보로 텐서를 찾고 양자화 텐서 (Q4_K, Q8_0 ...) 는 블록 필드별 스트림으로 (gguf.h).
+// solid 여부와 관계없이 실수 텐서는 솔리드 계획
+// rules/rules_file 이 있으면 이름이 맞는 텐서의 청크는 규칙의 코덱/레벨/변환으로 (rules.h). 끝에 규칙별 리포트
+// reorder 면 청크 분할 전에 텐서를 (dtype, shape, 이름 역할) 순으로 모음 (tensor_spans). 원래 배치는 extent 로 복원
+void handle_compression_tiered(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                               const CompressOptions& options);
+
+#endif //TIERS_H
@@ -0,0 +1,304 @@
+#include "transcode.h"
+#include "archive.h"
+#include "compressor.cuh"
+#include "dictionary.h"
+#include "file_util.h"
+#include "kang_format.h"
+#include "parallel.h"
+#include "chunk_codec.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 기본 재압축 레벨 (compress 기본값과 동일)
+constexpr int TRANSCODE_DEFAULT_LEVEL = 10;
+
+// 작업 단위 청크 수 (워커당 메모리 = 배치 x 청크 크기)
+constexpr size_t TRANSCODE_COPY_BATCH = 8;
+constexpr size_t TRANSCODE_ENCODE_BATCH = 4;
+
+struct TranscodeSource {
+    ArchiveIndex index;
+    std::vector<std::vector<char>> plain; // 청크별 미리 해제된 원본 (비어 있으면 아카이브에서 읽음)
+    std::vector<bool> has_plain;
+};
+
+// v1 을 파일 하나짜리 v2 인덱스로 변환: 청크 0 = [u64 헤더 길이][JSON], 이후 v1 텐서 청크 그대로
+bool load_v1_source(std::FILE* f, const fs::path& input_path, const fs::path& dict_path, TranscodeSource& src)
+{
+    KangV1Layout layout;
+    if (!read_kang_v1_layout(f, layout)) return false;
+    std::string json_header;
+    ZstdDictionary dict;
+    if (!decompress_header_blob(layout.compressed_header, input_path, dict_path, json_header, dict)) {
+        std::cerr << "Error: Cannot decompress the archive header." << std::endl;
+        return false;
+    }
+
+    // v1 헤더 블롭에는 길이 접두사가 없으므로 헤더 청크는 새로 압축 (작음)
+    std::vector<char> head(sizeof(uint64_t) + json_header.size());
+    const uint64_t header_len = json_header.size();
+    std::memcpy(head.data(), &header_len, sizeof(header_len));
+    std::memcpy(head.data() + sizeof(header_len), json_header.data(), json_header.size());
+
+    ArchiveFile af;
+    af.path = input_path.stem().string() + ".safetensors";
+    af.size = head.size();
+    af.extents.push_back({ 0, 0, head.size() });
+    ArchiveChunk hc;
+    hc.original_size = head.size();
+    src.index.chunks.push_back(hc);
+    src.plain.push_back(std::move(head));
+    src.has_plain.push_back(true);
+
+    uint64_t offset = layout.payload_offset;
+    for (const auto& info : layout.chunk_info) {
+        ArchiveChunk c;
+        c.offset = offset;
+        c.compressed_size = info.second;
+        c.original_size = info.first;
+        c.codec = static_cast<uint8_t>(ChunkCodec::NvcompZstd);
+        c.level = 0; // v1 은 레벨을 기록하지 않음
+        offset += info.second;
+        af.extents.push_back({ src.index.chunks.size(), 0, info.first });
+        af.size += info.first;
+        src.index.chunks.push_back(c);
+        src.plain.emplace_back();
+        src.has_plain.push_back(false);
+    }
+    if (offset > layout.file_size) {
+        std::cerr << "Error: Archive is truncated (chunk data past end of file)." << std::endl;
+        return false;
+    }
+    src.index.files.push_back(std::move(af));
+
+    // 사전 압축된 작은 파일의 텐서 청크(CPU zstd)는 v2 코덱으로 다시 압축
+    if (layout.chunk_info.size() == 1) {
+        ArchiveChunk& c = src.index.chunks[1];
+        std::vector<char> blob(static_cast<size_t>(c.compressed_size));
+        if (!file_read_at(f, c.offset, blob.data(), blob.size())) return false;
+        if (is_cpu_zstd_blob(blob.data(), blob.size())) {
+            if ((dict.id == 0 && !resolve_dictionary(blob.data(), blob.size(), input_path, dict_path, dict)) ||
+                !decompress_with_dictionary(blob.data(), blob.size(), dict, src.plain[1]) ||
+                src.plain[1].size() != c.original_size) {
+                std::cerr << "Error: Cannot decompress dictionary-compressed tensor data." << std::endl;
+                return false;
+            }
+            src.has_plain[1] = true;
+        }
+    }
+    return true;
+}
+
+uint8_t target_codec(const TranscodeSource& src, size_t i, const TranscodeOptions& options)
+{
+    if (options.codec >= 0) return static_cast<uint8_t>(options.codec);
+    return src.has_plain[i] ? static_cast<uint8_t>(ChunkCodec::NvcompZstd) : src.index.chunks[i].codec;
+}
+
+bool needs_reencode(const TranscodeSource& src, size_t i, const TranscodeOptions& options)
+{
+    const ArchiveChunk& c = src.index.chunks[i];
+    const uint8_t codec = target_codec(src, i, options);
+    if (src.has_plain[i] || codec != c.codec) return true;
+    // Stored/Rans/Fpc 는 레벨이 없고, nvCOMP zstd 는 레벨을 적용하지 못하므로 다시 압축해도 결과가 같음
+    return codec != static_cast<uint8_t>(ChunkCodec::Stored) && codec != static_cast<uint8_t>(ChunkCodec::Rans) &&
+           codec != static_cast<uint8_t>(ChunkCodec::Fpc) && codec != static_cast<uint8_t>(ChunkCodec::NvcompZstd) &&
+           options.level >= 0 && c.level != options.level;
+}
+
+} // namespace
+
+void handle_transcode(const fs::path& input_path, const fs::path& output_path, const TranscodeOptions& options)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Transcoding " << input_path.string() << "\n-> to ->     " << output_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::error_code ec;
+    if (fs::exists(output_path) && fs::equivalent(input_path, output_path, ec)) {
+        std::cerr << "Error: Output must be a different file than the input." << std::endl;
+        return;
+    }
+
+    // 1. 입력 인덱스 (v1 은 헤더/청크 테이블만 읽어 변환)
+    std::FILE* in = file_open(input_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open input file " << input_path.string() << std::endl;
+        return;
+    }
+    TranscodeSource src;
+    const bool v1 = !is_v2_archive(input_path);
+    bool ok = v1 ? load_v1_source(in, input_path, options.dict_path, src) : read_archive_index(in, src.index);
+    std::fclose(in);
+    if (!ok) {
+        std::cerr << "Transcoding failed." << std::endl;
+        return;
+    }
+    if (!v1) {
+        src.plain.resize(src.index.chunks.size());
+        src.has_plain.assign(src.index.chunks.size(), false);
+    }
+
+    // 2. 청크 분류: 그대로 복사 / 다시 압축
+    std::vector<size_t> copy_ids, encode_ids;
+    for (size_t i = 0; i < src.index.chunks.size(); ++i) {
+        if (needs_reencode(src, i, options)) {
+            if (src.index.chunks[i].original_size > KANG_CHUNK_SIZE) {
+                std::cerr << "Error: Chunk " << i << " is larger than the chunk size, cannot re-encode." << std::endl;
+                return;
+            }
+            encode_ids.push_back(i);
+        } else {
+            copy_ids.push_back(i);
+        }
+    }
+    std::vector<std::pair<bool, std::vector<size_t>>> work; // <다시 압축 여부, 청크들>
+    for (size_t b = 0; b < copy_ids.size(); b += TRANSCODE_COPY_BATCH) {
+        work.emplace_back(false, std::vector<size_t>(copy_ids.begin() + b,
+                                                     copy_ids.begin() + std::min(copy_ids.size(), b + TRANSCODE_COPY_BATCH)));
+    }
+    for (size_t b = 0; b < encode_ids.size(); b += TRANSCODE_ENCODE_BATCH) {
+        work.emplace_back(true, std::vector<size_t>(encode_ids.begin() + b,
+                                                    encode_ids.begin() + std::min(encode_ids.size(), b + TRANSCODE_ENCODE_BATCH)));
+    }
+    std::cout << src.index.chunks.size() << " chunks: " << copy_ids.size() << " copied, "
+              << encode_ids.size() << " re-encoded." << std::endl;
+
+    // 3. 청크 기록 (끝나는 순서대로 붙이고 인덱스에 위치 갱신, 청크 번호는 유지)
+    std::FILE* out = file_open(output_path, "wb");
+    if (!out || !write_v2_signature(out)) {
+        std::cerr << "Error: Cannot create output file " << output_path.string() << std::endl;
+        if (out) std::fclose(out);
+        return;
+    }
+    ArchiveIndex out_index = src.index;
+    std::mutex out_mutex;
+    auto append = [&](size_t id, const char* data, size_t compressed_size, const ArchiveChunk& meta) {
+        std::lock_guard<std::mutex> lock(out_mutex);
+        ArchiveChunk& c = out_index.chunks[id];
+        c = meta;
+        c.offset = file_tell(out);
+        c.compressed_size = compressed_size;
+        return std::fwrite(data, 1, compressed_size, out) == compressed_size;
+    };
+
+    const int level = options.level >= 0 ? options.level : TRANSCODE_DEFAULT_LEVEL;
+    auto encode = [&](size_t id, const char* data, size_t size) {
+        ArchiveChunk meta = src.index.chunks[id];
+        meta.original_size = size;
+        meta.codec = target_codec(src, id, options);
+        meta.transform = static_cast<uint8_t>(ChunkTransform::None); // 해제된 원본을 다시 압축
+        meta.transform_param = 0;
+        meta.aux = 0;
+        // --moe 잔차 청크는 참조 청크(번호 유지)와 다시 XOR 해 잔차로 압축
+        std::vector<char> residual;
+        const ArchiveChunk& c = src.index.chunks[id];
+        if ((c.transform & CHUNK_TRANSFORM_XOR_REFERENCE) && size > 0) {
+            std::vector<char> reference;
+            if (src.has_plain[c.aux]) {
+                reference = src.plain[c.aux];
+            } else {
+                std::FILE* rf = file_open(input_path, "rb");
+                bool read = rf && decode_archive_chunks(rf, src.index, { c.aux }, [&](size_t, const char* d, size_t n) {
+                    reference.assign(d, d + n);
+                    return true;
+                });
+                if (rf) std::fclose(rf);
+                if (!read) return false;
+            }
+            if (reference.size() != size) {
+                std::cerr << "Error: Reference chunk " << c.aux << " does not match chunk " << id << "." << std::endl;
+                return false;
+            }
+            residual.assign(data, data + size);
+            xor_bytes(residual.data(), reference.data(), size);
+            data = residual.data();
+        }
+        auto mark = [&](ArchiveChunk& m) {
+            if (residual.empty()) return;
+            m.transform |= CHUNK_TRANSFORM_XOR_REFERENCE;
+            m.aux = c.aux;
+        };
+        mark(meta);
+        if (is_cpu_codec(meta.codec) && size > 0) {
+            // 원래 바이트/부호/전치 분할이던 청크는 같은 dtype 으로 다시 분할 (등급을 옮겨도 분할 이득 유지)
+            const DType dtype = repack_dtype(c);
+            std::vector<char> comp;
+            if (!encode_cpu_chunk(static_cast<ChunkCodec>(meta.codec), data, size, level, dtype, dtype != DType::Unknown,
+                                  meta, comp)) {
+                return false;
+            }
+            mark(meta);
+            return append(id, comp.data(), comp.size(), meta);
+        }
+        if (meta.codec == static_cast<uint8_t>(ChunkCodec::Stored) || size == 0) {
+            meta.codec = static_cast<uint8_t>(ChunkCodec::Stored);
+            meta.level = 0;
+            return append(id, data, size, meta);
+        }
+        if (meta.codec != static_cast<uint8_t>(ChunkCodec::NvcompZstd)) {
+            std::cerr << "Error: Unsupported target codec " << static_cast<int>(meta.codec) << "." << std::endl;
+            return false;
+        }
+        meta.level = static_cast<int8_t>(NVCOMP_ZSTD_LEVEL);
+        size_t produced = 0;
+        bool ok = compress_chunks_streaming(
+            size, 0,
+            [&](size_t, size_t) -> const char* { return data; },
+            [&](size_t, const char* comp, size_t, size_t compressed_size) {
+                ++produced;
+                return append(id, comp, compressed_size, meta);
+            },
+            level);
+        return ok && produced == 1;
+    };
+
+    std::atomic<bool> failed{ false };
+    parallel_for(work.size(), options.threads, [&](size_t w) {
+        if (failed) return;
+        std::FILE* f = file_open(input_path, "rb");
+        if (!f) { failed = true; return; }
+        const std::vector<size_t>& ids = work[w].second;
+        bool ok = true;
+        if (!work[w].first) {
+            std::vector<char> buf;
+            for (size_t id : ids) {
+                const ArchiveChunk& c = src.index.chunks[id];
+                buf.resize(static_cast<size_t>(c.compressed_size));
+                ok = ok && file_read_at(f, c.offset, buf.data(), buf.size()) && append(id, buf.data(), buf.size(), c);
+            }
+        } else {
+            std::vector<size_t> decode_ids;
+            for (size_t id : ids) {
+                if (src.has_plain[id]) ok = ok && encode(id, src.plain[id].data(), src.plain[id].size());
+                else decode_ids.push_back(id);
+            }
+            ok = ok && decode_archive_chunks(f, src.index, decode_ids, encode);
+        }
+        std::fclose(f);
+        if (!ok) failed = true;
+    });
+
+    ok = !failed && write_archive_index(out, out_index);
+    const uint64_t archive_size = file_tell(out);
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Transcoding failed." << std::endl;
+        fs::remove(output_path, ec);
+        return;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Transcoded " << out_index.files.size() << " file(s): " << fs::file_size(input_path) << " -> "
+              << archive_size << " bytes" << std::endl;
+    std::cout << "Transcoding successful! Took " << diff.count() << " seconds." << std::endl;
+}
@@ -0,0 +1,12 @@
+#ifndef TRANSCODE_H
+#define TRANSCODE_H
+
+#include <filesystem>
+#include "options.h"
+
+// 기존 아카이브(v1 또는 v2)를 v2 컨테이너로 스트리밍 변환
+// 코덱/레벨이 그대로인 청크는 해제 없이 바이트 복사, 바뀌는 청크만 병렬로 다시 압축
+void handle_transcode(const std::filesystem::path& input_path, const std::filesystem::path& output_path,
+                      const TranscodeOptions& options);
+
+#endif //TRANSCODE_H
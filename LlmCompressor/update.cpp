@@ -0,0 +1,572 @@
+#include "update.h"
+#include "archive.h"
+#include "chunk_codec.h"
+#include "compressor.cuh"
+#include "file_util.h"
+#include "safetensors.h"
+#include "tensor_index.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 새 데이터 영역의 한 구간: 기존 파일 내용 또는 교체 파일 내용
+struct UpdateSegment {
+    bool from_old = true;
+    uint64_t source_offset = 0; // 기존 파일 또는 교체 파일 내 오프셋
+    uint64_t length = 0;
+};
+
+// 아카이브 안 safetensors 의 JSON 헤더
+bool read_archived_header(std::FILE* f, const ArchiveIndex& index, const ArchiveFile& file, std::string& json_header)
+{
+    std::vector<char> buf;
+    if (file.size < sizeof(uint64_t) || !read_archive_file_range(f, index, file, 0, sizeof(uint64_t), buf)) return false;
+    uint64_t header_len = 0;
+    std::memcpy(&header_len, buf.data(), sizeof(header_len));
+    if (header_len > file.size - sizeof(uint64_t)) {
+        std::cerr << "Error: " << file.path << " is not a safetensors file." << std::endl;
+        return false;
+    }
+    if (!read_archive_file_range(f, index, file, sizeof(uint64_t), header_len, buf)) return false;
+    json_header.assign(buf.begin(), buf.end());
+    return true;
+}
+
+// 새 청크의 코덱: 원본 바이트가 가장 많은 코덱 (Stored 제외, 없으면 zstd) = 아카이브의 저장 등급
+// level 은 그 코덱 청크에서 가장 많은 레벨, split 은 그 코덱 청크가 바이트 분할 변환을 쓰는지
+struct TierCodec {
+    ChunkCodec codec = ChunkCodec::NvcompZstd;
+    int level = 10;
+    bool split = false;
+};
+
+TierCodec archive_tier_codec(const ArchiveIndex& index)
+{
+    std::map<uint8_t, uint64_t> bytes;
+    for (const auto& c : index.chunks) {
+        if (c.codec != static_cast<uint8_t>(ChunkCodec::Stored)) bytes[c.codec] += c.original_size;
+    }
+    TierCodec tier;
+    uint64_t best = 0;
+    for (const auto& b : bytes) {
+        if (b.second > best) {
+            best = b.second;
+            tier.codec = static_cast<ChunkCodec>(b.first);
+        }
+    }
+    if (best == 0) return tier;
+    std::map<int, uint64_t> levels;
+    for (const auto& c : index.chunks) {
+        if (c.codec != static_cast<uint8_t>(tier.codec)) continue;
+        levels[c.level] += c.original_size;
+        tier.split = tier.split || (c.transform & ~CHUNK_TRANSFORM_XOR_REFERENCE) != static_cast<uint8_t>(ChunkTransform::None);
+    }
+    best = 0;
+    for (const auto& l : levels) {
+        if (l.second > best) {
+            best = l.second;
+            tier.level = l.first;
+        }
+    }
+    return tier;
+}
+
+// 이 비율 미만만 살아 있는 청크는 compact 때 살아 있는 구간만 다시 압축
+constexpr double COMPACT_REPACK_LIVE_RATIO = 0.5;
+
+// 청크별로 파일이 참조하는 (해제 후) 구간, 정렬 + 병합
+std::vector<std::vector<std::pair<uint64_t, uint64_t>>> live_ranges(const ArchiveIndex& index)
+{
+    std::vector<std::vector<std::pair<uint64_t, uint64_t>>> ranges(index.chunks.size());
+    for (const auto& f : index.files) {
+        for (const auto& e : f.extents) {
+            if (e.chunk < ranges.size()) ranges[e.chunk].emplace_back(e.chunk_offset, e.chunk_offset + e.length);
+        }
+    }
+    for (auto& r : ranges) {
+        std::sort(r.begin(), r.end());
+        std::vector<std::pair<uint64_t, uint64_t>> merged;
+        for (const auto& x : r) {
+            if (!merged.empty() && x.first <= merged.back().second) merged.back().second = std::max(merged.back().second, x.second);
+            else merged.push_back(x);
+        }
+        r.swap(merged);
+    }
+    return ranges;
+}
+
+uint64_t live_size(const std::vector<std::pair<uint64_t, uint64_t>>& ranges)
+{
+    uint64_t n = 0;
+    for (const auto& r : ranges) n += r.second - r.first;
+    return n;
+}
+
+// 죽은 공간 추정: 이전 인덱스 + 참조 없는 청크 + 일부만 참조되는 청크의 죽은 비율만큼
+uint64_t dead_bytes(const ArchiveIndex& index, uint64_t payload_end)
+{
+    const auto ranges = live_ranges(index);
+    uint64_t payload = 0;
+    double dead = 0;
+    for (size_t c = 0; c < index.chunks.size(); ++c) {
+        const ArchiveChunk& chunk = index.chunks[c];
+        payload += chunk.compressed_size;
+        if (chunk.original_size == 0) continue;
+        const double live = static_cast<double>(live_size(ranges[c])) / static_cast<double>(chunk.original_size);
+        dead += static_cast<double>(chunk.compressed_size) * (1.0 - live);
+    }
+    return (payload_end - KANG_V2_SIGNATURE.size() - payload) + static_cast<uint64_t>(dead);
+}
+
+} // namespace
+
+void handle_update(const fs::path& archive_path, const fs::path& replace_path,
+                   const std::string& file_name, int compression_level, int codec)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Updating " << archive_path.string() << "\n<- from - " << replace_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    if (!is_v2_archive(archive_path)) {
+        std::cerr << "Error: Only v2 archives can be updated in place, run 'kang transcode' first." << std::endl;
+        return;
+    }
+    std::FILE* f = file_open(archive_path, "r+b");
+    if (!f) {
+        std::cerr << "Error: Cannot open archive " << archive_path.string() << std::endl;
+        return;
+    }
+    ArchiveIndex index;
+    if (!read_archive_index(f, index)) {
+        std::fclose(f);
+        return;
+    }
+
+    // 1. 대상 파일과 기존 헤더
+    size_t target = index.files.size();
+    for (size_t i = 0; i < index.files.size(); ++i) {
+        if (file_name.empty() ? index.files.size() == 1 : index.files[i].path == file_name) target = i;
+    }
+    if (target == index.files.size()) {
+        std::cerr << "Error: " << (file_name.empty() ? "Archive holds several files, choose one with --file."
+                                                     : "File not found in archive: " + file_name) << std::endl;
+        std::fclose(f);
+        return;
+    }
+    const ArchiveFile old_file = index.files[target];
+    std::string old_json, metadata_json;
+    std::vector<TensorInfo> old_tensors;
+    if (!read_archived_header(f, index, old_file, old_json) ||
+        !parse_safetensors_header(old_json, old_tensors, &metadata_json)) {
+        std::fclose(f);
+        std::cerr << "Update failed." << std::endl;
+        return;
+    }
+    const uint64_t old_data_start = sizeof(uint64_t) + old_json.size();
+
+    // 2. 교체할 텐서 (헤더만 읽음, 데이터는 압축할 때 스트리밍)
+    std::FILE* rf = file_open(replace_path, "rb");
+    const uint64_t replace_size = rf ? fs::file_size(replace_path) : 0;
+    uint64_t replace_data_start = 0;
+    std::string replace_json;
+    std::vector<TensorInfo> replace_tensors;
+    bool ok = rf && read_safetensors_header(rf, replace_size, replace_json, replace_data_start) &&
+              parse_safetensors_header(replace_json, replace_tensors);
+    for (const auto& t : replace_tensors) {
+        if (replace_data_start + t.data_end > replace_size) ok = false;
+    }
+    if (!ok) {
+        std::cerr << "Error: Cannot read replacement safetensors " << replace_path.string() << std::endl;
+        if (rf) std::fclose(rf);
+        std::fclose(f);
+        return;
+    }
+
+    // 3. 새 레이아웃: 기존 데이터 순서 유지, 교체 텐서는 자리 바꿈, 새 텐서는 끝에 추가
+    std::map<std::string, const TensorInfo*> replacements;
+    for (const auto& t : replace_tensors) replacements[t.name] = &t;
+    std::vector<size_t> order(old_tensors.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return old_tensors[a].data_begin < old_tensors[b].data_begin; });
+
+    std::vector<TensorInfo> new_tensors = old_tensors;
+    std::vector<TensorInfo> stream_tensors; // 새 스트림 안의 교체/추가 텐서 (data_* 는 헤더 뒤 스트림 기준, 바이트 분할 dtype 용)
+    std::vector<UpdateSegment> segments;
+    uint64_t cursor = 0, stream_cursor = 0;
+    size_t replaced = 0, added = 0;
+    bool layout_unchanged = true;
+    for (size_t i : order) {
+        TensorInfo& t = new_tensors[i];
+        auto it = replacements.find(t.name);
+        UpdateSegment seg;
+        if (it == replacements.end()) {
+            seg = { true, old_data_start + t.data_begin, t.data_end - t.data_begin };
+        } else {
+            const TensorInfo& r = *it->second;
+            seg = { false, replace_data_start + r.data_begin, r.data_end - r.data_begin };
+            layout_unchanged = layout_unchanged && r.dtype == t.dtype && r.shape == t.shape;
+            t.dtype = r.dtype;
+            t.shape = r.shape;
+            replacements.erase(it);
+            ++replaced;
+            TensorInfo s = t;
+            s.data_begin = stream_cursor;
+            s.data_end = stream_cursor += seg.length;
+            stream_tensors.push_back(s);
+        }
+        layout_unchanged = layout_unchanged && t.data_begin == cursor && seg.length == t.data_end - t.data_begin;
+        t.data_begin = cursor;
+        t.data_end = cursor + seg.length;
+        cursor = t.data_end;
+        segments.push_back(seg);
+    }
+    for (const auto& t : replace_tensors) {
+        if (!replacements.count(t.name)) continue;
+        TensorInfo n = t;
+        n.data_begin = cursor;
+        n.data_end = cursor + (t.data_end - t.data_begin);
+        cursor = n.data_end;
+        segments.push_back({ false, replace_data_start + t.data_begin, t.data_end - t.data_begin });
+        new_tensors.push_back(n);
+        TensorInfo s = n;
+        s.data_begin = stream_cursor;
+        s.data_end = stream_cursor += n.data_end - n.data_begin;
+        stream_tensors.push_back(s);
+        ++added;
+    }
+    layout_unchanged = layout_unchanged && added == 0 && old_data_start + cursor == old_file.size;
+
+    // 크기/모양이 그대로면 기존 헤더 청크를 재사용, 아니면 헤더를 새로 생성
+    const std::string new_json = layout_unchanged ? old_json : make_safetensors_header(new_tensors, metadata_json);
+    std::vector<char> new_prefix;
+    if (!layout_unchanged) {
+        const uint64_t new_header_len = new_json.size();
+        new_prefix.resize(sizeof(uint64_t) + new_json.size());
+        std::memcpy(new_prefix.data(), &new_header_len, sizeof(new_header_len));
+        std::memcpy(new_prefix.data() + sizeof(uint64_t), new_json.data(), new_json.size());
+    }
+
+    for (auto& s : stream_tensors) {
+        s.data_begin += new_prefix.size();
+        s.data_end += new_prefix.size();
+    }
+
+    // 4. 새 스트림 = [새 헤더] + 교체/추가 텐서 데이터, 기존 트레일러 뒤에 청크로 붙임
+    //    코덱/레벨을 지정하지 않으면 아카이브의 저장 등급 (fast-load/cold/entropy 아카이브에 zstd 청크를 섞지 않음)
+    TierCodec tier = archive_tier_codec(index);
+    if (codec >= 0) {
+        tier.split = tier.split && tier.codec == static_cast<ChunkCodec>(codec);
+        tier.codec = static_cast<ChunkCodec>(codec);
+        if (tier.codec == ChunkCodec::Rans) tier.split = true;
+    }
+    if (compression_level >= 0) tier.level = compression_level;
+    else if (codec >= 0 && archive_tier_codec(index).codec != tier.codec) tier.level = 10;
+    compression_level = tier.level;
+    const size_t stream_chunk_size = tier.codec == ChunkCodec::NvcompZstd ? KANG_CHUNK_SIZE
+                                   : tier.codec == ChunkCodec::Lzma ? KANG_COLD_CHUNK_SIZE : KANG_FASTLOAD_CHUNK_SIZE;
+    uint64_t stream_size = new_prefix.size();
+    for (const auto& seg : segments) {
+        if (!seg.from_old) stream_size += seg.length;
+    }
+    if (!file_seek_end(f)) ok = false;
+    const uint64_t old_archive_size = file_tell(f);
+    std::vector<size_t> stream_chunks;
+    std::vector<char> in_buf;
+    size_t seg_index = 0;
+    uint64_t seg_pos = 0, prefix_pos = 0;
+    auto read_chunk = [&](size_t, size_t size) -> const char* {
+        in_buf.resize(size);
+        size_t filled = 0;
+        if (prefix_pos < new_prefix.size()) {
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(size, new_prefix.size() - prefix_pos));
+            std::memcpy(in_buf.data(), new_prefix.data() + prefix_pos, n);
+            prefix_pos += n;
+            filled = n;
+        }
+        while (filled < size && seg_index < segments.size()) {
+            const UpdateSegment& seg = segments[seg_index];
+            if (seg.from_old || seg_pos == seg.length) {
+                ++seg_index;
+                seg_pos = 0;
+                continue;
+            }
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(size - filled, seg.length - seg_pos));
+            if (!file_read_at(rf, seg.source_offset + seg_pos, in_buf.data() + filled, n)) return nullptr;
+            filled += n;
+            seg_pos += n;
+        }
+        return filled == size ? in_buf.data() : nullptr;
+    };
+    auto write_chunk = [&](size_t, const char* data, size_t original_size, size_t compressed_size) {
+        ArchiveChunk c;
+        c.offset = file_tell(f);
+        c.compressed_size = compressed_size;
+        c.original_size = original_size;
+        c.codec = static_cast<uint8_t>(ChunkCodec::NvcompZstd);
+        c.level = static_cast<int8_t>(NVCOMP_ZSTD_LEVEL);
+        if (std::fwrite(data, 1, compressed_size, f) != compressed_size) return false;
+        stream_chunks.push_back(index.chunks.size());
+        index.chunks.push_back(c);
+        return true;
+    };
+    if (tier.codec == ChunkCodec::NvcompZstd) {
+        ok = ok && (stream_size == 0 ||
+                    compress_chunks_streaming(static_cast<size_t>(stream_size), 0, read_chunk, write_chunk, compression_level));
+    } else {
+        // CPU 코덱 / Stored: 등급 청크 크기로 잘라 청크마다 인코딩 (encode_cpu_chunk 는 커지면 Stored)
+        std::vector<char> comp;
+        for (uint64_t pos = 0; ok && pos < stream_size; pos += stream_chunk_size) {
+            const size_t size = static_cast<size_t>(std::min<uint64_t>(stream_chunk_size, stream_size - pos));
+            const char* data = read_chunk(0, size);
+            ArchiveChunk c;
+            if (!data) {
+                ok = false;
+                break;
+            }
+            if (tier.codec == ChunkCodec::Stored) {
+                c.original_size = size;
+                c.codec = static_cast<uint8_t>(ChunkCodec::Stored);
+                comp.assign(data, data + size);
+            }
+            else if (!encode_cpu_chunk(tier.codec, data, size, compression_level, dominant_dtype(stream_tensors, pos, pos + size),
+                                       tier.split, c, comp)) {
+                ok = false;
+                break;
+            }
+            c.offset = file_tell(f);
+            c.compressed_size = comp.size();
+            ok = std::fwrite(comp.data(), 1, comp.size(), f) == comp.size();
+            stream_chunks.push_back(index.chunks.size());
+            index.chunks.push_back(c);
+        }
+    }
+    std::fclose(rf);
+
+    // 5. 새 익스텐트: 바뀌지 않은 구간은 기존 익스텐트를 잘라 재사용
+    auto stream_extents = [&](uint64_t pos, uint64_t length, std::vector<ArchiveExtent>& out) {
+        while (length > 0) {
+            const size_t ci = static_cast<size_t>(pos / stream_chunk_size);
+            const uint64_t in_chunk = pos % stream_chunk_size;
+            const uint64_t len = std::min<uint64_t>(length, index.chunks[stream_chunks[ci]].original_size - in_chunk);
+            out.push_back({ stream_chunks[ci], in_chunk, len });
+            pos += len;
+            length -= len;
+        }
+    };
+    ArchiveFile new_file;
+    new_file.path = old_file.path;
+    if (ok) {
+        if (new_prefix.empty()) ok = append_extent_slice(old_file.extents, 0, old_data_start, new_file.extents);
+        else stream_extents(0, new_prefix.size(), new_file.extents);
+        uint64_t stream_pos = new_prefix.size();
+        for (const auto& seg : segments) {
+            if (seg.from_old) {
+                ok = ok && append_extent_slice(old_file.extents, seg.source_offset, seg.length, new_file.extents);
+            } else {
+                stream_extents(stream_pos, seg.length, new_file.extents);
+                stream_pos += seg.length;
+            }
+        }
+        new_file.size = (new_prefix.empty() ? old_data_start : new_prefix.size()) + cursor;
+        index.files[target] = new_file;
+    }
+
+    // 6. 새 인덱스 + 트레일러 (기록 전까지는 기존 트레일러가 유효하지 않으므로 실패 시 원래 크기로 되돌림)
+    const uint64_t new_index_offset = file_tell(f);
+    ok = ok && write_archive_index(f, index) && file_sync(f);
+    const uint64_t archive_size = file_tell(f);
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) {
+        std::error_code ec;
+        fs::resize_file(archive_path, old_archive_size, ec);
+        std::cerr << "Update failed, archive restored to its previous state." << std::endl;
+        return;
+    }
+    // 텐서 전용 .kidx 를 새 헤더로 다시 기록 (여러 파일 아카이브에는 둘 수 없으므로 남은 사이드카를 지움)
+    const fs::path index_path = tensor_index_path_for(archive_path);
+    if (index.files.size() == 1) {
+        write_tensor_index_file(new_json, cursor, index_path);
+    } else {
+        std::error_code ec;
+        fs::remove(index_path, ec);
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << replaced << " tensors replaced, " << added << " added (" << stream_chunks.size() << " new chunks, "
+              << (archive_size - old_archive_size) << " bytes appended)" << std::endl;
+    std::cout << "Dead space: ~" << dead_bytes(index, new_index_offset) << " bytes (run 'kang compact' to reclaim)" << std::endl;
+    std::cout << "Update successful! Took " << diff.count() << " seconds." << std::endl;
+}
+
+void handle_compact(const fs::path& archive_path, const fs::path& output_path)
+{
+    std::cout << "--------------------------------------------------" << std::endl;
+    std::cout << "Compacting " << archive_path.string() << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::FILE* in = file_open(archive_path, "rb");
+    if (!in) {
+        std::cerr << "Error: Cannot open input file " << archive_path.string() << std::endl;
+        return;
+    }
+    ArchiveIndex index;
+    if (!read_archive_index(in, index)) {
+        std::fclose(in);
+        return;
+    }
+
+    // 1. 청크 분류: 참조 없음 -> 버림, 대부분 죽음 -> 살아 있는 구간만 다시 압축, 나머지 -> 그대로 복사
+    //    그대로 복사하는 XOR 청크(--moe)의 참조 청크는 내용이 그대로여야 하므로 죽었어도 통째로 복사
+    const auto ranges = live_ranges(index);
+    auto repackable = [&](size_t c) {
+        const uint64_t live = live_size(ranges[c]);
+        return live > 0 &&
+               static_cast<double>(live) < COMPACT_REPACK_LIVE_RATIO * static_cast<double>(index.chunks[c].original_size);
+    };
+    std::vector<bool> pinned(index.chunks.size(), false);
+    for (size_t c = 0; c < index.chunks.size(); ++c) {
+        const ArchiveChunk& chunk = index.chunks[c];
+        if ((chunk.transform & CHUNK_TRANSFORM_XOR_REFERENCE) && live_size(ranges[c]) > 0 && !repackable(c) &&
+            chunk.aux < index.chunks.size()) {
+            pinned[chunk.aux] = true;
+        }
+    }
+    std::vector<uint64_t> remap(index.chunks.size(), UINT64_MAX);
+    std::vector<size_t> repack;
+    ArchiveIndex out_index;
+    out_index.extra_sections = index.extra_sections;
+    size_t dropped = 0;
+    for (size_t c = 0; c < index.chunks.size(); ++c) {
+        if (live_size(ranges[c]) == 0 && !pinned[c]) {
+            ++dropped;
+            continue;
+        }
+        remap[c] = out_index.chunks.size();
+        out_index.chunks.push_back(index.chunks[c]);
+        if (!pinned[c] && repackable(c)) repack.push_back(c);
+    }
+    for (auto& chunk : out_index.chunks) {
+        // 다시 압축하는 XOR 청크는 원본으로 풀려 참조가 사라지므로 (참조가 버려졌을 수 있음) 건너뜀
+        if ((chunk.transform & CHUNK_TRANSFORM_XOR_REFERENCE) && remap[chunk.aux] != UINT64_MAX) {
+            chunk.aux = static_cast<uint32_t>(remap[chunk.aux]);
+        }
+    }
+
+    // 2. 기록 (제자리면 임시 파일에 쓴 뒤 교체)
+    const fs::path target = output_path.empty() ? fs::path(archive_path.string() + ".compact") : output_path;
+    std::FILE* out = file_open(target, "wb");
+    bool ok = out && write_v2_signature(out);
+    std::vector<char> buf;
+    for (size_t c = 0; c < index.chunks.size() && ok; ++c) {
+        if (remap[c] == UINT64_MAX || std::find(repack.begin(), repack.end(), c) != repack.end()) continue;
+        ArchiveChunk& oc = out_index.chunks[remap[c]];
+        buf.resize(static_cast<size_t>(oc.compressed_size));
+        ok = file_read_at(in, oc.offset, buf.data(), buf.size());
+        oc.offset = file_tell(out);
+        ok = ok && std::fwrite(buf.data(), 1, buf.size(), out) == buf.size();
+    }
+    std::vector<bool> packed(index.chunks.size(), false); // 살아 있는 구간만 다시 압축해 기록한 청크
+    ok = ok && decode_archive_chunks(in, index, repack, [&](size_t c, const char* data, size_t) {
+        buf.clear();
+        for (const auto& r : ranges[c]) buf.insert(buf.end(), data + r.first, data + r.second);
+        const ArchiveChunk& ic = index.chunks[c];
+        const DType dtype = repack_dtype(ic);
+        ArchiveChunk meta = ic;
+        meta.original_size = buf.size();
+        meta.transform = 0; // buf 는 변환을 되돌린 원본
+        meta.transform_param = 0;
+        meta.aux = 0;
+        std::vector<char> comp;
+        bool encoded = true;
+        if (is_cpu_codec(meta.codec)) {
+            // 원래 CPU 코덱/레벨로 (바이트 분할이던 청크는 같은 dtype 으로 다시 분할). 커지면 encode_cpu_chunk 가 Stored
+            encoded = encode_cpu_chunk(static_cast<ChunkCodec>(meta.codec), buf.data(), buf.size(), meta.level, dtype,
+                                       dtype != DType::Unknown, meta, comp);
+        }
+        else if (meta.codec == static_cast<uint8_t>(ChunkCodec::NvcompZstd)) {
+            encoded = compress_chunks_streaming(
+                buf.size(), 0,
+                [&](size_t, size_t) -> const char* { return buf.data(); },
+                [&](size_t, const char* z, size_t, size_t compressed_size) {
+                    comp.assign(z, z + compressed_size);
+                    return true;
+                },
+                meta.level > 0 ? meta.level : 10);
+            meta.level = static_cast<int8_t>(NVCOMP_ZSTD_LEVEL);
+        }
+        else {
+            meta.codec = static_cast<uint8_t>(ChunkCodec::Stored);
+            comp = buf;
+        }
+        if (!encoded) return false;
+        // 살아 있는 구간만 압축해도 작아지지 않으면 (죽은 구간이 특히 잘 압축되던 청크) 원래 청크를 그대로 복사
+        // XOR 청크는 참조 청크가 버려졌을 수 있어 항상 다시 압축
+        ArchiveChunk& oc = out_index.chunks[remap[c]];
+        if (comp.size() >= ic.compressed_size && !(ic.transform & CHUNK_TRANSFORM_XOR_REFERENCE)) {
+            comp.resize(static_cast<size_t>(ic.compressed_size));
+            if (!file_read_at(in, ic.offset, comp.data(), comp.size())) return false;
+        } else {
+            oc = meta;
+            packed[c] = true;
+        }
+        oc.offset = file_tell(out);
+        oc.compressed_size = comp.size();
+        return std::fwrite(comp.data(), 1, comp.size(), out) == comp.size();
+    });
+
+    // 청크 내 위치 이동 (다시 압축한 청크는 살아 있는 구간만 이어 붙임)
+    auto remap_offset = [&](size_t c, uint64_t offset) {
+        if (!packed[c]) return offset;
+        uint64_t position = 0;
+        for (const auto& r : ranges[c]) {
+            if (offset < r.second) return position + (offset - r.first);
+            position += r.second - r.first;
+        }
+        return position;
+    };
+    out_index.files = index.files;
+    for (auto& file : out_index.files) {
+        for (auto& e : file.extents) {
+            e.chunk_offset = remap_offset(static_cast<size_t>(e.chunk), e.chunk_offset);
+            e.chunk = remap[e.chunk];
+        }
+    }
+    ok = ok && write_archive_index(out, out_index) && file_sync(out);
+    const uint64_t old_size = fs::file_size(archive_path);
+    const uint64_t new_size = out ? file_tell(out) : 0;
+    // 파일 내용은 그대로이므로 사이드카가 있던 아카이브는 같은 헤더로 텐서 전용 .kidx 를 새 아카이브 옆에 기록
+    std::string json_header;
+    const bool had_index = ok && index.files.size() == 1 && fs::exists(tensor_index_path_for(archive_path)) &&
+                           read_archived_header(in, index, index.files[0], json_header);
+    std::fclose(in);
+    if (out) ok = (std::fclose(out) == 0) && ok;
+    std::error_code ec;
+    if (ok && output_path.empty()) {
+        fs::rename(target, archive_path, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        std::cerr << "Compaction failed." << std::endl;
+        fs::remove(target, ec);
+        return;
+    }
+    if (had_index) {
+        write_tensor_index_file(json_header, index.files[0].size - sizeof(uint64_t) - json_header.size(),
+                                tensor_index_path_for(output_path.empty() ? archive_path : output_path));
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end_time - start_time;
+    std::cout << "Dropped " << dropped << " dead chunks, repacked " << std::count(packed.begin(), packed.end(), true) << ": " << old_size
+              << " -> " << new_size << " bytes" << std::endl;
+    std::cout << "Compaction successful! Took " << diff.count() << " seconds." << std::endl;
+}
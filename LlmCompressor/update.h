@@ -0,0 +1,18 @@
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include <filesystem>
+#include <string>
+
+// v2 아카이브 안 safetensors 의 텐서 교체/추가 (제자리 갱신)
+// 바뀐 텐서만 새 청크로 뒤에 붙이고 새 인덱스를 기록. 이전 청크/인덱스는 죽은 공간으로 남음
+// file_name 이 비어 있으면 아카이브에 파일이 하나뿐이어야 함
+// codec (ChunkCodec, -1 = 아카이브 저장 등급) / compression_level (-1 = 그 코덱 청크의 레벨) 로 새 청크를 압축
+void handle_update(const std::filesystem::path& archive_path, const std::filesystem::path& replace_path,
+                   const std::string& file_name, int compression_level, int codec = -1);
+
+// 참조되지 않는 청크를 버리고 다시 기록 (output_path 가 비어 있으면 제자리)
+// 대부분 죽은 청크는 살아 있는 구간만 원래 코덱/레벨로 다시 압축
+void handle_compact(const std::filesystem::path& archive_path, const std::filesystem::path& output_path);
+
+#endif //UPDATE_H